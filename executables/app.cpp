@@ -26,6 +26,11 @@ int32_t main(int32_t argc_, char** argv_) {
   //ds print loaded configuration
   parameters->command_line_parameters->print();
 
+  //ds start recording profiler spans if desired
+  if (!parameters->command_line_parameters->profile_file_name.empty()) {
+    proslam::Profiler::enable();
+  }
+
   //ds allocate SLAM system (has internal access to parameter server)
   proslam::SLAMAssembly slam_system(parameters);
 
@@ -35,8 +40,13 @@ int32_t main(int32_t argc_, char** argv_) {
   //ds start system
   try {
 
-    //ds load cameras
-    slam_system.loadCamerasFromMessageFile();
+    //ds load cameras (from a native dataset directory or a txt_io message file)
+    slam_system.loadCamerasFromDataset();
+
+    //ds load a prior map if desired
+    if (!parameters->command_line_parameters->map_file_name_to_load.empty()) {
+      slam_system.loadMap(parameters->command_line_parameters->map_file_name_to_load);
+    }
 
     //ds if visualization is desired
     if (parameters->command_line_parameters->option_use_gui) {
@@ -80,7 +90,7 @@ int32_t main(int32_t argc_, char** argv_) {
       std::cerr << "main|all threads successfully joined" << std::endl;
     } else {
 
-      //ds disable opencv multithreading
+      //ds disable opencv multithreading (parallel processing is handled by the shared thread pool)
       cv::setNumThreads(0);
 
       //ds wait for start
@@ -96,6 +106,13 @@ int32_t main(int32_t argc_, char** argv_) {
     //ds print full report
     slam_system.printReport();
 
+    //ds print span percentiles and save the profiler trace
+    if (proslam::Profiler::isEnabled()) {
+      proslam::Profiler::disable();
+      proslam::Profiler::printStatistics(std::cerr, slam_system.processingTimeTotalSeconds());
+      proslam::Profiler::writeChromeTrace(parameters->command_line_parameters->profile_file_name);
+    }
+
     //ds save trajectories to disk
     slam_system.writeTrajectoryKITTI("trajectory_kitti.txt");
     slam_system.writeTrajectoryTUM("trajectory_tum.txt");
@@ -104,6 +121,11 @@ int32_t main(int32_t argc_, char** argv_) {
     if (parameters->command_line_parameters->option_save_pose_graph) {
       slam_system.writePoseGraphToFile("pose_graph.g2o");
     }
+
+    //ds save map to disk
+    if (!parameters->command_line_parameters->map_file_name_to_save.empty()) {
+      slam_system.saveMap(parameters->command_line_parameters->map_file_name_to_save);
+    }
   } catch (const std::runtime_error& exception_) {
     std::cerr << DOUBLE_BAR << std::endl;
     std::cerr << "main|caught runtime exception: '" << exception_.what() << "'" << std::endl;
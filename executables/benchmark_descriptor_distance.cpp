@@ -0,0 +1,83 @@
+#include "types/descriptor_distance.h"
+using namespace proslam;
+
+
+
+//ds measures the average duration of a descriptor distance function over a set of random descriptor pairs
+template<typename DistanceFunction>
+double measureNanosecondsPerCall(const cv::Mat& descriptors_a_,
+                                 const cv::Mat& descriptors_b_,
+                                 const uint32_t& number_of_repetitions_,
+                                 DistanceFunction distance_function_,
+                                 uint64_t& checksum_) {
+  checksum_ = 0;
+  const double time_start_seconds = srrg_core::getTime();
+  for (uint32_t r = 0; r < number_of_repetitions_; ++r) {
+    for (int32_t u = 0; u < descriptors_a_.rows; ++u) {
+      checksum_ += distance_function_(descriptors_a_.row(u), descriptors_b_.row(u));
+    }
+  }
+  return 1e9*(srrg_core::getTime()-time_start_seconds)/(static_cast<double>(number_of_repetitions_)*descriptors_a_.rows);
+}
+
+
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds configuration: number of descriptor pairs, repetitions and comparisons per frame (features x candidates)
+  const int32_t number_of_descriptors          = (argc_ > 1) ? std::stoi(argv_[1]) : 10000;
+  const uint32_t number_of_repetitions         = (argc_ > 2) ? std::stoi(argv_[2]) : 100;
+  const double number_of_comparisons_per_frame = (argc_ > 3) ? std::stod(argv_[3]) : 2000*50;
+  std::cerr << BAR << std::endl;
+  std::cerr << "descriptor size (bits): " << SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS << std::endl;
+  std::cerr << "number of descriptor pairs: " << number_of_descriptors << std::endl;
+  std::cerr << "number of repetitions: " << number_of_repetitions << std::endl;
+  std::cerr << "assumed comparisons per frame: " << number_of_comparisons_per_frame << std::endl;
+  std::cerr << "default kernel: " << DescriptorDistance::kernelName(DescriptorDistance::kernelType()) << std::endl;
+  std::cerr << BAR << std::endl;
+
+  //ds random descriptors
+  cv::Mat descriptors_a(number_of_descriptors, DESCRIPTOR_SIZE_BYTES, CV_8U);
+  cv::Mat descriptors_b(number_of_descriptors, DESCRIPTOR_SIZE_BYTES, CV_8U);
+  cv::randu(descriptors_a, cv::Scalar(0), cv::Scalar(256));
+  cv::randu(descriptors_b, cv::Scalar(0), cv::Scalar(256));
+
+  //ds reference: generic opencv norm
+  uint64_t checksum_reference = 0;
+  const double nanoseconds_reference = measureNanosecondsPerCall(descriptors_a, descriptors_b, number_of_repetitions,
+    [](const cv::Mat& a_, const cv::Mat& b_) {return static_cast<uint32_t>(cv::norm(a_, b_, SRRG_PROSLAM_DESCRIPTOR_NORM));},
+    checksum_reference);
+  std::printf("%16s | %8.2f ns/call | %8.3f ms/frame | speedup: %5.2f\n", "cv::norm",
+              nanoseconds_reference, 1e-6*nanoseconds_reference*number_of_comparisons_per_frame, 1.0);
+
+  //ds evaluate all kernels supported on this machine
+  const DescriptorDistance::KernelType kernel_type_default = DescriptorDistance::kernelType();
+  for (const DescriptorDistance::KernelType& kernel_type: {DescriptorDistance::SCALAR,
+                                                           DescriptorDistance::POPCNT,
+                                                           DescriptorDistance::AVX2,
+                                                           DescriptorDistance::AVX512_VPOPCNTDQ,
+                                                           DescriptorDistance::NEON}) {
+    if (!DescriptorDistance::isSupported(kernel_type)) {
+      std::printf("%16s | not supported\n", DescriptorDistance::kernelName(kernel_type).c_str());
+      continue;
+    }
+    DescriptorDistance::setKernel(kernel_type);
+    uint64_t checksum = 0;
+    const double nanoseconds = measureNanosecondsPerCall(descriptors_a, descriptors_b, number_of_repetitions,
+      [](const cv::Mat& a_, const cv::Mat& b_) {return DescriptorDistance::compute(a_, b_);},
+      checksum);
+    std::printf("%16s | %8.2f ns/call | %8.3f ms/frame | speedup: %5.2f", DescriptorDistance::kernelName(kernel_type).c_str(),
+                nanoseconds, 1e-6*nanoseconds*number_of_comparisons_per_frame, nanoseconds_reference/nanoseconds);
+
+    //ds results must be identical to the reference
+    if (checksum != checksum_reference) {
+      std::printf("\n");
+      std::cerr << "ERROR: checksum mismatch: " << checksum << " != " << checksum_reference << std::endl;
+      return -1;
+    }
+    std::printf("\n");
+  }
+  DescriptorDistance::setKernel(kernel_type_default);
+  std::cerr << BAR << std::endl;
+  return 0;
+}
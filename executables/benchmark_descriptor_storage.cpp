@@ -0,0 +1,115 @@
+#include <set>
+#include "types/descriptor_distance.h"
+using namespace proslam;
+
+
+
+//ds descriptor copies of the frontend for one frame: extracted matrix > features > framepoints > landmark descriptor histories
+//ds the histories are converted (cleared) once they reach the track length, as in the local map creation
+template<typename DescriptorType>
+struct DescriptorPipeline {
+
+  //ds per frame copy chain, returns the copy duration in seconds
+  static double process(const cv::Mat& descriptors_extracted_,
+                        const Count& track_length_,
+                        std::vector<DescriptorType>& features_,
+                        std::vector<DescriptorType>& framepoints_,
+                        std::vector<std::vector<DescriptorType>>& landmark_descriptors_,
+                        uint64_t& checksum_) {
+    const double time_begin_seconds = srrg_core::getTime();
+    for (int32_t row = 0; row < descriptors_extracted_.rows; ++row) {
+      features_[row] = DescriptorType(descriptors_extracted_.row(row));
+    }
+    for (int32_t row = 0; row < descriptors_extracted_.rows; ++row) {
+      framepoints_[row] = features_[row];
+    }
+    for (int32_t row = 0; row < descriptors_extracted_.rows; ++row) {
+      if (landmark_descriptors_[row].size() == track_length_) {
+        landmark_descriptors_[row].clear();
+      }
+      landmark_descriptors_[row].push_back(framepoints_[row]);
+    }
+    const double duration_seconds = srrg_core::getTime()-time_begin_seconds;
+
+    //ds the descriptors must be identical for both storages
+    for (int32_t row = 0; row < descriptors_extracted_.rows; ++row) {
+      checksum_ += DescriptorDistance::compute(_data(framepoints_[row]), _data(framepoints_[(row+1)%descriptors_extracted_.rows]));
+    }
+    return duration_seconds;
+  }
+
+  static const uint8_t* _data(const cv::Mat& descriptor_) {return descriptor_.data;}
+  static const uint8_t* _data(const BinaryDescriptor& descriptor_) {return descriptor_.data();}
+};
+
+
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds configuration: features per frame (= landmarks), descriptors per landmark until local map conversion and number of frames
+  const int32_t number_of_features = (argc_ > 1) ? std::stoi(argv_[1]) : 2000;
+  const Count track_length         = (argc_ > 2) ? std::stoi(argv_[2]) : 10;
+  const uint32_t number_of_frames  = (argc_ > 3) ? std::stoi(argv_[3]) : 1000;
+  std::cerr << BAR << std::endl;
+  std::cerr << "descriptor size (bits): " << SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS << std::endl;
+  std::cerr << "number of features per frame: " << number_of_features << std::endl;
+  std::cerr << "descriptors per landmark: " << track_length << std::endl;
+  std::cerr << "number of frames: " << number_of_frames << std::endl;
+  std::cerr << BAR << std::endl;
+
+  //ds reference: single row cv::Mat views on the extracted descriptor matrix (previous storage)
+  std::vector<cv::Mat> features_matrix(number_of_features);
+  std::vector<cv::Mat> framepoints_matrix(number_of_features);
+  std::vector<std::vector<cv::Mat>> landmark_descriptors_matrix(number_of_features);
+
+  //ds fixed size descriptors stored by value
+  std::vector<BinaryDescriptor> features_fixed(number_of_features);
+  std::vector<BinaryDescriptor> framepoints_fixed(number_of_features);
+  std::vector<std::vector<BinaryDescriptor>> landmark_descriptors_fixed(number_of_features);
+
+  double duration_matrix_seconds = 0;
+  double duration_fixed_seconds  = 0;
+  uint64_t checksum_matrix = 0;
+  uint64_t checksum_fixed  = 0;
+  for (uint32_t u = 0; u < number_of_frames; ++u) {
+
+    //ds random descriptors as obtained from the extractor (a new matrix for each frame)
+    cv::Mat descriptors_extracted(number_of_features, DESCRIPTOR_SIZE_BYTES, CV_8U);
+    cv::randu(descriptors_extracted, cv::Scalar(0), cv::Scalar(256));
+    duration_matrix_seconds += DescriptorPipeline<cv::Mat>::process(descriptors_extracted, track_length, features_matrix,
+                                                                     framepoints_matrix, landmark_descriptors_matrix, checksum_matrix);
+    duration_fixed_seconds += DescriptorPipeline<BinaryDescriptor>::process(descriptors_extracted, track_length, features_fixed,
+                                                                            framepoints_fixed, landmark_descriptors_fixed, checksum_fixed);
+  }
+
+  //ds memory held by the landmark descriptor histories: the row views additionally keep each referenced descriptor matrix alive
+  size_t bytes_matrix = 0;
+  size_t bytes_fixed  = 0;
+  std::set<const uint8_t*> referenced_matrices;
+  for (int32_t index = 0; index < number_of_features; ++index) {
+    bytes_matrix += landmark_descriptors_matrix[index].capacity()*sizeof(cv::Mat);
+    for (const cv::Mat& descriptor: landmark_descriptors_matrix[index]) {
+      if (referenced_matrices.insert(descriptor.datastart).second) {
+        bytes_matrix += descriptor.dataend-descriptor.datastart;
+      }
+    }
+    bytes_fixed += landmark_descriptors_fixed[index].capacity()*sizeof(BinaryDescriptor);
+  }
+
+  //ds summary (the checksums have to match)
+  std::cerr << "checksum cv::Mat: " << checksum_matrix << " BinaryDescriptor: " << checksum_fixed << std::endl;
+  std::cerr << "referenced descriptor matrices: " << referenced_matrices.size() << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "         storage | bytes/descriptor | bytes/landmark | copy time (ms/frame)" << std::endl;
+  std::cerr << BAR << std::endl;
+  std::printf("%16s | %16zu | %14.1f | %20.4f\n", "cv::Mat", sizeof(cv::Mat),
+              static_cast<double>(bytes_matrix)/number_of_features, 1e3*duration_matrix_seconds/number_of_frames);
+  std::printf("%16s | %16zu | %14.1f | %20.4f\n", "BinaryDescriptor", sizeof(BinaryDescriptor),
+              static_cast<double>(bytes_fixed)/number_of_features, 1e3*duration_fixed_seconds/number_of_frames);
+  std::cerr << BAR << std::endl;
+  if (checksum_matrix != checksum_fixed) {
+    std::cerr << "ERROR: checksum mismatch: " << checksum_matrix << " != " << checksum_fixed << std::endl;
+    return -1;
+  }
+  return 0;
+}
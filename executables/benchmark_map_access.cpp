@@ -0,0 +1,144 @@
+#include <map>
+#include "types/world_map.h"
+using namespace proslam;
+
+//ds access patterns of the map-access-heavy stages, for the tree (std::map) and the flat (IdentifierMap) storage
+template<typename LandmarkStorage, typename VertexStorage>
+struct AccessPatterns {
+
+  //ds drawing: iteration over all landmarks (the viewer draws each landmark)
+  static double iterate(const LandmarkStorage& landmarks_) {
+    double sum = 0;
+    for (const LandmarkPointerMapElement& landmark: landmarks_) {
+      sum += landmark.second->coordinates().x();
+    }
+    return sum;
+  }
+
+  //ds landmark merging: lookups of the landmark pairs of each closure and removal of the absorbed landmark
+  static Count merge(LandmarkStorage& landmarks_, const std::vector<std::pair<Identifier, Identifier>>& merges_) {
+    Count number_of_merges = 0;
+    for (const std::pair<Identifier, Identifier>& merge: merges_) {
+      typename LandmarkStorage::iterator iterator_query     = landmarks_.find(merge.first);
+      typename LandmarkStorage::iterator iterator_reference = landmarks_.find(merge.second);
+      if (iterator_query != landmarks_.end() && iterator_reference != landmarks_.end()) {
+        Landmark* landmark_query = iterator_query->second;
+        landmarks_.erase(merge.first);
+        landmarks_.insert(std::make_pair(merge.first, landmark_query));
+        ++number_of_merges;
+      }
+    }
+    return number_of_merges;
+  }
+
+  //ds bundle adjustment graph construction: vertex lookup or insertion for each landmark observation
+  static Count construct(VertexStorage& vertices_, const std::vector<Identifier>& observations_, Landmark* vertex_) {
+    Count number_of_vertices = 0;
+    for (const Identifier& identifier: observations_) {
+      if (vertices_.find(identifier) == vertices_.end()) {
+        vertices_.insert(std::make_pair(identifier, vertex_));
+        ++number_of_vertices;
+      }
+    }
+    return number_of_vertices;
+  }
+};
+
+
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds validate input
+  if (argc_ < 2) {
+    std::cerr << "ERROR: invalid call - please use: ./benchmark_map_access <file_name_map> [<number_of_repetitions>]" << std::endl;
+    std::cerr << "       (a map file is obtained with: ./app <dataset> -save-map <file_name_map>, e.g. for KITTI sequence 00)" << std::endl;
+    return 0;
+  }
+
+  //ds configuration
+  const std::string file_name_map      = argv_[1];
+  const uint32_t number_of_repetitions = (argc_ > 2) ? std::stoi(argv_[2]) : 10;
+  std::cerr << BAR << std::endl;
+  std::cerr << "map file: " << file_name_map << std::endl;
+  std::cerr << "number of repetitions: " << number_of_repetitions << std::endl;
+  std::cerr << BAR << std::endl;
+
+  //ds load the map (flat storage) and build the tree storage with identical content
+  WorldMapParameters* world_map_parameters = new WorldMapParameters();
+  WorldMap* world_map = new WorldMap(world_map_parameters);
+  try {
+    world_map->read(file_name_map);
+  } catch (const std::runtime_error& exception_) {
+    std::cerr << "ERROR: " << exception_.what() << std::endl;
+    delete world_map;
+    delete world_map_parameters;
+    return 0;
+  }
+  typedef std::map<const Identifier, Landmark*> LandmarkTree;
+  LandmarkPointerMap landmarks_flat(world_map->landmarks());
+  LandmarkTree landmarks_tree(world_map->landmarks().begin(), world_map->landmarks().end());
+
+  //ds access sequences from the local maps: landmark observations in order of the local maps (graph construction)
+  //ds and pairs of landmarks observed in consecutive local maps (merge candidates)
+  std::vector<Identifier> observations;
+  std::vector<std::pair<Identifier, Identifier>> merges;
+  for (LocalMap* local_map: world_map->localMaps()) {
+    Identifier identifier_previous = 0;
+    for (const Closure::LandmarkStateMapElement& landmark_state: local_map->landmarks()) {
+      observations.push_back(landmark_state.first);
+      if (identifier_previous > 0) {
+        merges.push_back(std::make_pair(identifier_previous, landmark_state.first));
+      }
+      identifier_previous = landmark_state.first;
+    }
+  }
+
+  //ds measure each access pattern for both storages
+  typedef AccessPatterns<LandmarkTree, LandmarkTree> AccessTree;
+  typedef AccessPatterns<LandmarkPointerMap, LandmarkPointerMap> AccessFlat;
+  double durations_tree_seconds[3] = {0, 0, 0};
+  double durations_flat_seconds[3] = {0, 0, 0};
+  double checksum_tree = 0;
+  double checksum_flat = 0;
+  for (uint32_t u = 0; u < number_of_repetitions; ++u) {
+    double time_begin_seconds = srrg_core::getTime();
+    checksum_tree += AccessTree::iterate(landmarks_tree);
+    durations_tree_seconds[0] += srrg_core::getTime()-time_begin_seconds;
+    time_begin_seconds = srrg_core::getTime();
+    checksum_flat += AccessFlat::iterate(landmarks_flat);
+    durations_flat_seconds[0] += srrg_core::getTime()-time_begin_seconds;
+
+    time_begin_seconds = srrg_core::getTime();
+    checksum_tree += AccessTree::merge(landmarks_tree, merges);
+    durations_tree_seconds[1] += srrg_core::getTime()-time_begin_seconds;
+    time_begin_seconds = srrg_core::getTime();
+    checksum_flat += AccessFlat::merge(landmarks_flat, merges);
+    durations_flat_seconds[1] += srrg_core::getTime()-time_begin_seconds;
+
+    LandmarkTree vertices_tree;
+    time_begin_seconds = srrg_core::getTime();
+    checksum_tree += AccessTree::construct(vertices_tree, observations, nullptr);
+    durations_tree_seconds[2] += srrg_core::getTime()-time_begin_seconds;
+    LandmarkPointerMap vertices_flat;
+    time_begin_seconds = srrg_core::getTime();
+    checksum_flat += AccessFlat::construct(vertices_flat, observations, nullptr);
+    durations_flat_seconds[2] += srrg_core::getTime()-time_begin_seconds;
+  }
+
+  //ds summary (the checksums have to match)
+  std::cerr << "frames: " << world_map->frames().size() << " landmarks: " << world_map->landmarks().size()
+            << " local maps: " << world_map->localMaps().size() << " observations: " << observations.size() << std::endl;
+  std::cerr << "checksum tree: " << checksum_tree << " flat: " << checksum_flat << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "                 access pattern | std::map (s) | IdentifierMap (s) | speedup" << std::endl;
+  std::cerr << BAR << std::endl;
+  const char* names[3] = {"drawing (iteration)", "landmark merging (lookup/erase)", "BA graph construction (lookup)"};
+  for (uint32_t u = 0; u < 3; ++u) {
+    std::printf("%31s | %12.6f | %17.6f | %7.2f\n", names[u], durations_tree_seconds[u]/number_of_repetitions,
+                durations_flat_seconds[u]/number_of_repetitions, durations_tree_seconds[u]/durations_flat_seconds[u]);
+  }
+  std::cerr << BAR << std::endl;
+  delete world_map;
+  delete world_map_parameters;
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "relocalization/relocalizer.h"
+using namespace proslam;
+
+
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds validate input
+  if (argc_ < 2) {
+    std::cerr << "ERROR: invalid call - please use: ./benchmark_map_serialization <file_name_map> [<number_of_repetitions>]" << std::endl;
+    std::cerr << "       (a map file is obtained with: ./app <dataset> -save-map <file_name_map>, e.g. for KITTI sequence 00)" << std::endl;
+    return 0;
+  }
+
+  //ds configuration
+  const std::string file_name_map       = argv_[1];
+  const std::string file_name_map_saved = file_name_map+".benchmark";
+  const uint32_t number_of_repetitions  = (argc_ > 2) ? std::stoi(argv_[2]) : 10;
+  std::cerr << BAR << std::endl;
+  std::cerr << "map file: " << file_name_map << std::endl;
+  std::cerr << "number of repetitions: " << number_of_repetitions << std::endl;
+  std::cerr << BAR << std::endl;
+
+  //ds default parameters (the map content does not depend on them)
+  WorldMapParameters* world_map_parameters     = new WorldMapParameters();
+  RelocalizerParameters* relocalizer_parameters = new RelocalizerParameters();
+
+  //ds measure load, place database construction and save separately
+  double duration_load_seconds     = 0;
+  double duration_database_seconds = 0;
+  double duration_save_seconds     = 0;
+  Count number_of_frames     = 0;
+  Count number_of_landmarks  = 0;
+  Count number_of_local_maps = 0;
+  try {
+    for (uint32_t u = 0; u < number_of_repetitions; ++u) {
+      WorldMap* world_map = new WorldMap(world_map_parameters);
+      Relocalizer* relocalizer = new Relocalizer(relocalizer_parameters);
+      relocalizer->configure();
+
+      //ds load map from disk
+      double time_begin_seconds = srrg_core::getTime();
+      world_map->read(file_name_map);
+      duration_load_seconds += srrg_core::getTime()-time_begin_seconds;
+
+      //ds build the place database (required for relocalization against the loaded map)
+      time_begin_seconds = srrg_core::getTime();
+      for (LocalMap* local_map: world_map->localMaps()) {
+        relocalizer->add(local_map);
+      }
+      relocalizer->integrateAppearanceMerges();
+      duration_database_seconds += srrg_core::getTime()-time_begin_seconds;
+
+      //ds save map to disk
+      time_begin_seconds = srrg_core::getTime();
+      world_map->write(file_name_map_saved);
+      duration_save_seconds += srrg_core::getTime()-time_begin_seconds;
+
+      number_of_frames     = world_map->frames().size();
+      number_of_landmarks  = world_map->landmarks().size();
+      number_of_local_maps = world_map->localMaps().size();
+      delete relocalizer;
+      delete world_map;
+      Frame::reset();
+      Landmark::reset();
+      LocalMap::reset();
+    }
+  } catch (const std::runtime_error& exception_) {
+    std::cerr << "ERROR: " << exception_.what() << std::endl;
+    delete relocalizer_parameters;
+    delete world_map_parameters;
+    return 0;
+  }
+
+  //ds file size for throughput
+  std::ifstream infile(file_name_map, std::ios::in | std::ios::binary | std::ios::ate);
+  const double size_megabytes = infile.tellg()/1e6;
+  infile.close();
+  std::remove(file_name_map_saved.c_str());
+
+  //ds summary
+  std::cerr << "frames: " << number_of_frames << " landmarks: " << number_of_landmarks << " local maps: " << number_of_local_maps
+            << " (" << size_megabytes << " MB)" << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "           operation | mean duration (s) | throughput (MB/s)" << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "                load | " << duration_load_seconds/number_of_repetitions << " | " << size_megabytes*number_of_repetitions/duration_load_seconds << std::endl;
+  std::cerr << "place database build | " << duration_database_seconds/number_of_repetitions << " | -" << std::endl;
+  std::cerr << "                save | " << duration_save_seconds/number_of_repetitions << " | " << size_megabytes*number_of_repetitions/duration_save_seconds << std::endl;
+  std::cerr << BAR << std::endl;
+  delete relocalizer_parameters;
+  delete world_map_parameters;
+  return 0;
+}
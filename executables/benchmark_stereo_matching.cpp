@@ -0,0 +1,111 @@
+#include <fstream>
+#include "framepoint_generation/stereo_framepoint_generator.h"
+using namespace proslam;
+
+
+
+//ds helpers
+Eigen::Matrix3d getCameraCalibrationMatrixKITTI(const std::string& file_name_calibration_, Eigen::Vector3d& baseline_pixels_);
+
+
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds validate input
+  if (argc_ < 4) {
+    std::cerr << "ERROR: invalid call - please use: ./benchmark_stereo_matching <file_name_image_LEFT> <file_name_image_RIGHT> "
+                 "<calib.txt> [<number_of_repetitions>]" << std::endl;
+    return 0;
+  }
+
+  //ds configuration
+  const std::string file_name_image_left  = argv_[1];
+  const std::string file_name_image_right = argv_[2];
+  const std::string file_name_calibration = argv_[3];
+  const uint32_t number_of_repetitions    = (argc_ > 4) ? std::stoi(argv_[4]) : 100;
+  std::cerr << BAR << std::endl;
+  std::cerr << "image LEFT: " << file_name_image_left << std::endl;
+  std::cerr << "image RIGHT: " << file_name_image_right << std::endl;
+  std::cerr << "calibration file (KITTI): " << file_name_calibration << std::endl;
+  std::cerr << "number of repetitions: " << number_of_repetitions << std::endl;
+
+  //ds load images and camera configuration
+  const cv::Mat image_left  = cv::imread(file_name_image_left, CV_LOAD_IMAGE_GRAYSCALE);
+  const cv::Mat image_right = cv::imread(file_name_image_right, CV_LOAD_IMAGE_GRAYSCALE);
+  if (image_left.rows == 0 || image_left.rows != image_right.rows || image_left.cols != image_right.cols) {
+    std::cerr << "ERROR: invalid images" << std::endl;
+    return 0;
+  }
+  Eigen::Vector3d baseline_pixels(Eigen::Vector3d::Zero());
+  const Eigen::Matrix3d camera_calibration_matrix(getCameraCalibrationMatrixKITTI(file_name_calibration, baseline_pixels));
+  Camera* camera_left  = new Camera(image_left.rows, image_left.cols, camera_calibration_matrix);
+  Camera* camera_right = new Camera(image_right.rows, image_right.cols, camera_calibration_matrix);
+  camera_right->setBaselineHomogeneous(baseline_pixels);
+  std::cerr << BAR << std::endl;
+
+  //ds evaluate stereo matching for increasing epipolar search offsets
+  for (int32_t maximum_epipolar_search_offset_pixels = 0; maximum_epipolar_search_offset_pixels <= 3; ++maximum_epipolar_search_offset_pixels) {
+    StereoFramePointGeneratorParameters* parameters = new StereoFramePointGeneratorParameters();
+    parameters->maximum_epipolar_search_offset_pixels = maximum_epipolar_search_offset_pixels;
+    StereoFramePointGenerator* framepoint_generator   = new StereoFramePointGenerator(parameters);
+    framepoint_generator->setCameraLeft(camera_left);
+    framepoint_generator->setCameraRight(camera_right);
+    framepoint_generator->configure();
+
+    //ds triangulate the same image pair repeatedly (feature extraction is not part of the measured time)
+    Count number_of_points = 0;
+    for (uint32_t u = 0; u < number_of_repetitions; ++u) {
+      Frame* frame = new Frame(nullptr, nullptr, nullptr, TransformMatrix3D::Identity(), 0);
+      frame->setCameraLeft(camera_left);
+      frame->setCameraRight(camera_right);
+      frame->setIntensityImageLeft(image_left);
+      frame->setIntensityImageRight(image_right);
+      framepoint_generator->initialize(frame);
+      framepoint_generator->compute(frame);
+      number_of_points += frame->points().size();
+      delete frame;
+    }
+    std::printf("maximum epipolar search offset: %i | triangulation: %8.3f ms/frame | points: %6.1f\n",
+                maximum_epipolar_search_offset_pixels,
+                1e3*framepoint_generator->getTimeConsumptionSeconds_point_triangulation()/number_of_repetitions,
+                static_cast<double>(number_of_points)/number_of_repetitions);
+    delete framepoint_generator;
+    delete parameters;
+  }
+
+  //ds clean up
+  delete camera_left;
+  delete camera_right;
+  return 0;
+}
+
+Eigen::Matrix3d getCameraCalibrationMatrixKITTI(const std::string& file_name_calibration_, Eigen::Vector3d& baseline_pixels_) {
+
+  //ds load camera matrix - for now only KITTI parsing
+  std::ifstream file_calibration(file_name_calibration_, std::ifstream::in);
+  std::string line_buffer("");
+  std::getline(file_calibration, line_buffer);
+  if (line_buffer.empty()) {
+    throw std::runtime_error("invalid camera calibration file provided");
+  }
+  std::istringstream stream_left(line_buffer);
+  Eigen::Matrix3d camera_calibration_matrix(Eigen::Matrix3d::Identity());
+  baseline_pixels_.setZero();
+
+  //ds parse in fixed order
+  std::string filler(""); stream_left >> filler;
+  stream_left >> camera_calibration_matrix(0,0);
+  stream_left >> filler;
+  stream_left >> camera_calibration_matrix(0,2);
+  stream_left >> filler; stream_left >> filler;
+  stream_left >> camera_calibration_matrix(1,1);
+  stream_left >> camera_calibration_matrix(1,2);
+
+  //ds read second projection matrix to obtain the horizontal offset
+  std::getline(file_calibration, line_buffer);
+  std::istringstream stream_right(line_buffer);
+  stream_right >> filler; stream_right >> filler; stream_right >> filler; stream_right >> filler;
+  stream_right >> baseline_pixels_(0);
+  file_calibration.close();
+  return camera_calibration_matrix;
+}
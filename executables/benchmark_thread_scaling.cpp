@@ -0,0 +1,109 @@
+#include "system/slam_assembly.h"
+using namespace proslam;
+
+
+
+//ds module timings of a single run
+struct ModuleTimings {
+  double fps                           = 0;
+  double feature_extraction_seconds    = 0;
+  double tracking_seconds              = 0;
+  double pose_optimization_seconds     = 0;
+  double landmark_optimization_seconds = 0;
+  double relocalization_seconds        = 0;
+  double graph_optimization_seconds    = 0;
+  double dataset_decoding_seconds      = 0;
+  Count number_of_frames               = 0;
+};
+
+//ds processes the complete dataset with the given number of threads
+ModuleTimings run(int32_t argc_, char** argv_, const Count& number_of_threads_) {
+  ParameterCollection* parameters = new ParameterCollection();
+  parameters->parseFromCommandLine(argc_, argv_);
+  parameters->command_line_parameters->option_use_gui   = false;
+  parameters->thread_pool_parameters->number_of_threads = number_of_threads_;
+  ModuleTimings timings;
+  {
+    SLAMAssembly slam_system(parameters);
+    slam_system.loadCamerasFromDataset();
+    slam_system.playbackMessageFile();
+
+    //ds collect timings (feature extraction: wall time of both image streams if available)
+    const BaseFramePointGenerator* framepoint_generator = slam_system.tracker()->framepointGenerator();
+    const StereoFramePointGenerator* stereo_framepoint_generator = dynamic_cast<const StereoFramePointGenerator*>(framepoint_generator);
+    timings.fps = slam_system.currentFPS();
+    if (stereo_framepoint_generator) {
+      timings.feature_extraction_seconds = stereo_framepoint_generator->getTimeConsumptionSeconds_feature_extraction();
+    } else {
+      timings.feature_extraction_seconds = framepoint_generator->getTimeConsumptionSeconds_keypoint_detection()+
+                                           framepoint_generator->getTimeConsumptionSeconds_descriptor_extraction();
+    }
+    timings.tracking_seconds              = slam_system.tracker()->getTimeConsumptionSeconds_tracking();
+    timings.pose_optimization_seconds     = slam_system.tracker()->getTimeConsumptionSeconds_pose_optimization();
+    timings.landmark_optimization_seconds = slam_system.tracker()->getTimeConsumptionSeconds_landmark_optimization();
+    timings.relocalization_seconds        = slam_system.relocalizer()->getTimeConsumptionSeconds_overall();
+    timings.graph_optimization_seconds    = slam_system.graphOptimizer()->getTimeConsumptionSeconds_optimization();
+    timings.dataset_decoding_seconds      = slam_system.threadPool()->timeConsumptionSecondsParallelLoops(ThreadPool::Stage::DATASET_DECODING);
+    timings.number_of_frames              = slam_system.numberOfProcessedFrames();
+  }
+  delete parameters;
+  return timings;
+}
+
+int32_t main(int32_t argc_, char** argv_) {
+
+  //ds validate input
+  if (argc_ < 3) {
+    std::cerr << "ERROR: invalid call - please use: ./benchmark_thread_scaling <maximum_number_of_threads> <dataset> [<app options, e.g. -c configuration.yaml>]" << std::endl;
+    std::cerr << "       (the dataset is processed once for every number of threads from 1 to maximum_number_of_threads)" << std::endl;
+    return 0;
+  }
+  const Count maximum_number_of_threads = std::max(std::stoi(argv_[1]), 1);
+
+  //ds the remaining arguments are parsed like the ones of the app (the thread count takes the place of the program name)
+  const int32_t argc_app = argc_-1;
+  char** argv_app        = argv_+1;
+
+  //ds disable opencv multithreading (parallel processing is handled by the shared thread pool)
+  cv::setUseOptimized(true);
+  cv::setNumThreads(0);
+
+  //ds process the dataset for each number of threads
+  std::vector<ModuleTimings> timings;
+  try {
+    for (Count number_of_threads = 1; number_of_threads <= maximum_number_of_threads; ++number_of_threads) {
+      std::cerr << "benchmark_thread_scaling|processing dataset with threads: " << number_of_threads << std::endl;
+      timings.push_back(run(argc_app, argv_app, number_of_threads));
+    }
+  } catch (const std::runtime_error& exception_) {
+    std::cerr << "ERROR: " << exception_.what() << std::endl;
+    return 0;
+  }
+
+  //ds scaling curves: absolute time and speedup with respect to a single thread for each module
+  std::cerr << DOUBLE_BAR << std::endl;
+  std::cerr << "thread scaling - absolute (s) and speedup w.r.t. 1 thread" << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "threads |         FPS | feature extraction |           tracking | pose optimization (ms/frame) | landmark optimization |     relocalization | graph optimization |   dataset decoding" << std::endl;
+  std::cerr << BAR << std::endl;
+  auto speedup = [](const double& duration_reference_seconds_, const double& duration_seconds_) {
+    return (duration_seconds_ > 0) ? duration_reference_seconds_/duration_seconds_ : 0.0;
+  };
+  const ModuleTimings& reference = timings.front();
+  for (Index index = 0; index < timings.size(); ++index) {
+    const ModuleTimings& current = timings[index];
+    std::printf("%7u | %6.2f %4.2fx | %11.3f %5.2fx | %11.3f %5.2fx | %11.3f (%8.4f) %5.2fx | %14.3f %5.2fx | %11.3f %5.2fx | %11.3f %5.2fx | %11.3f %5.2fx\n",
+                index+1,
+                current.fps, speedup(current.fps, reference.fps),
+                current.feature_extraction_seconds, speedup(reference.feature_extraction_seconds, current.feature_extraction_seconds),
+                current.tracking_seconds, speedup(reference.tracking_seconds, current.tracking_seconds),
+                current.pose_optimization_seconds, 1e3*current.pose_optimization_seconds/std::max(current.number_of_frames, Count(1)),
+                speedup(reference.pose_optimization_seconds, current.pose_optimization_seconds),
+                current.landmark_optimization_seconds, speedup(reference.landmark_optimization_seconds, current.landmark_optimization_seconds),
+                current.relocalization_seconds, speedup(reference.relocalization_seconds, current.relocalization_seconds),
+                current.graph_optimization_seconds, speedup(reference.graph_optimization_seconds, current.graph_optimization_seconds),
+                current.dataset_decoding_seconds, speedup(reference.dataset_decoding_seconds, current.dataset_decoding_seconds));
+  }
+  std::cerr << DOUBLE_BAR << std::endl;
+  return 0;
+}
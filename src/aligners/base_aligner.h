@@ -1,5 +1,6 @@
 #pragma once
 #include "types/definitions.h"
+#include "types/thread_pool.h"
 
 namespace proslam {
 
@@ -43,6 +44,7 @@ public:
   inline const real totalError() const {return _total_error;}
   inline const real averageError() const {assert(_number_of_measurements > 0); return _total_error/_number_of_measurements;}
   inline const bool hasSystemConverged() const {return _has_system_converged;}
+  inline const Count numberOfIterations() const {return _number_of_iterations;}
   inline AlignerParameters* parameters() {return _parameters;}
   void setMinimumReliableDepthMeters(const real& minimum_reliable_depth_meters_) {_minimum_reliable_depth_meters = minimum_reliable_depth_meters_;}
   void setMaximumReliableDepthMeters(const real& maximum_reliable_depth_meters_) {_maximum_reliable_depth_meters = maximum_reliable_depth_meters_;}
@@ -61,6 +63,13 @@ protected:
   bool _has_system_converged = false;
   real _total_error          = 0;
 
+  //! @brief robust cost of the last linearization: squared error of inliers, downweighted outliers contribute kernel*(1+log(chi/kernel))
+  //! @brief (the cost whose derivative is the applied weight), ignored outliers and invalid measurements the constant kernel
+  real _robust_error = 0;
+
+  //! @brief number of optimization rounds performed by the last converge call (including inlier only rounds)
+  Count _number_of_iterations = 0;
+
   //ds generic thresholds (usally set by framepoint generator or tracker configuration)
   real _minimum_reliable_depth_meters = 0.01;
   real _maximum_reliable_depth_meters = 15;
@@ -92,6 +101,194 @@ public:
   typedef Eigen::Matrix<real, dimension_, dimension_> DimensionMatrix;
   typedef Eigen::Matrix<real, dimension_, states_> JacobianMatrix;
 
+  //! @brief number of measurements per linearization block: a multiple of the word size of std::vector<bool>
+  //! @brief so that blocks linearized in parallel never write to the same word of the inlier flags
+  static constexpr Count linearization_block_size = 64;
+
+  //! @brief partial linear system of a block of consecutive measurements (parallel linearization)
+  struct LinearizationBlock {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    StateMatrix H;
+    StateVector b;
+    Count number_of_inliers;
+    real total_error;
+    real robust_error;
+  };
+  typedef std::vector<LinearizationBlock, Eigen::aligned_allocator<LinearizationBlock> > LinearizationBlockVector;
+
+  //! @brief per-measurement terms of a linearization block in structure-of-arrays layout (one contiguous row per entry)
+  //! @brief filled by the aligners in a branch-free pass over their packed buffers, reduced by _accumulateLinearizationScratch
+  struct alignas(32) LinearizationScratch {
+
+    //! @brief jacobian entry (row, state) of each measurement
+    AlignerScalar jacobian[dimension_][states_][linearization_block_size];
+
+    //! @brief error entry of each measurement
+    AlignerScalar error[dimension_][linearization_block_size];
+
+    //! @brief diagonal information matrix entry of each measurement (scaled by the robust kernel weight on accumulation)
+    AlignerScalar omega[dimension_][linearization_block_size];
+
+    //! @brief squared error and robust kernel weight (0 for discarded measurements) of each measurement
+    AlignerScalar chi[linearization_block_size];
+    AlignerScalar weight[linearization_block_size];
+
+    //! @brief false if the measurement has no valid projection (its remaining entries are finite but meaningless)
+    bool is_valid[linearization_block_size];
+  };
+
+//ds helpers
+protected:
+
+  //! @brief linearizes the measurements in blocks of fixed size, which are distributed over the thread pool (if available)
+  //! @brief the partial systems are summed up in block order into _H and _b, hence the result does not depend on the number of threads
+  //! @param[in] number_of_measurements_ number of measurements
+  //! @param[in] linearize_block_ function accumulating the measurements [index_begin_, index_end_) into a zeroed LinearizationBlock
+  //! @param[in] thread_pool_ thread pool for the parallel linearization (sequential if nullptr)
+  //! @param[out] number_of_inliers_ total number of inliers
+  //! @param[out] total_error_ total error
+  //! @param[out] robust_error_ total robust cost (measurements without weight are charged the error kernel)
+  template<typename LinearizeBlockFunction>
+  void _linearizeInBlocks(const Count& number_of_measurements_,
+                          const LinearizeBlockFunction& linearize_block_,
+                          ThreadPool* thread_pool_,
+                          Count& number_of_inliers_,
+                          real& total_error_,
+                          real& robust_error_) {
+    const Count number_of_blocks = (number_of_measurements_+linearization_block_size-1)/linearization_block_size;
+    _linearization_blocks.resize(number_of_blocks);
+    auto linearize_block = [&](const Index& index_block_) {
+      LinearizationBlock& block = _linearization_blocks[index_block_];
+      block.H.setZero();
+      block.b.setZero();
+      block.number_of_inliers = 0;
+      block.total_error       = 0;
+      block.robust_error      = 0;
+      const Index index_begin = index_block_*linearization_block_size;
+      linearize_block_(index_begin, std::min(index_begin+linearization_block_size, number_of_measurements_), block);
+    };
+    if (thread_pool_ && number_of_blocks > 1) {
+      thread_pool_->parallelFor(0, number_of_blocks, linearize_block, ThreadPool::Stage::TRACKING);
+    } else {
+      for (Index index_block = 0; index_block < number_of_blocks; ++index_block) {
+        linearize_block(index_block);
+      }
+    }
+
+    //ds reduce the partial systems in fixed order (deterministic)
+    _H.setZero();
+    _b.setZero();
+    number_of_inliers_ = 0;
+    total_error_       = 0;
+    robust_error_      = 0;
+    for (const LinearizationBlock& block: _linearization_blocks) {
+      _H += block.H;
+      _b += block.b;
+      number_of_inliers_ += block.number_of_inliers;
+      total_error_       += block.total_error;
+      robust_error_      += block.robust_error;
+    }
+  }
+
+  //! @brief updates the error statistics of a filled scratch block and adds its weighted normal equations to the partial system
+  //! @brief all sums over measurements run in the innermost loops over contiguous rows (vectorized), the bookkeeping is scalar
+  //! @param[in,out] scratch_ filled scratch block (chi and weight are computed here)
+  //! @param[in] index_begin_ index of the first measurement of the block
+  //! @param[in] number_of_measurements_ number of measurements in the block
+  //! @param[in] ignore_outliers_ discard measurements exceeding the error kernel instead of downweighting them
+  //! @param[in] maximum_error_kernel_ robust error kernel
+  //! @param[out] errors_ squared error per measurement (-1 if not valid)
+  //! @param[out] inliers_ inlier flag per measurement
+  //! @param[in,out] block_ partial system of the block
+  static void _accumulateLinearizationScratch(LinearizationScratch& scratch_,
+                                              const Index& index_begin_,
+                                              const Count& number_of_measurements_,
+                                              const bool& ignore_outliers_,
+                                              const real& maximum_error_kernel_,
+                                              std::vector<real>& errors_,
+                                              std::vector<bool>& inliers_,
+                                              LinearizationBlock& block_) {
+
+    //ds squared errors
+    for (Index k = 0; k < number_of_measurements_; ++k) {
+      scratch_.chi[k] = 0;
+    }
+    for (Index r = 0; r < dimension_; ++r) {
+      for (Index k = 0; k < number_of_measurements_; ++k) {
+        scratch_.chi[k] += scratch_.omega[r][k]*scratch_.error[r][k]*scratch_.error[r][k];
+      }
+    }
+
+    //ds error statistics and robust kernel weights - the robust cost is the one whose gradient the weights produce: downweighted
+    //ds outliers are charged kernel*(1+log(chi/kernel)), measurements without weight (invalid or ignored) the constant kernel,
+    //ds so that a step can neither lower the cost by losing measurements nor be judged by a cost it did not descend on
+    const AlignerScalar maximum_error_kernel = maximum_error_kernel_;
+    for (Index k = 0; k < number_of_measurements_; ++k) {
+      const Index u = index_begin_+k;
+      scratch_.weight[k] = 0;
+      if (!scratch_.is_valid[k]) {
+        errors_[u]          = -1;
+        inliers_[u]         = false;
+        block_.robust_error += maximum_error_kernel_;
+        continue;
+      }
+      errors_[u] = scratch_.chi[k];
+
+      //ds check if outlier
+      if (scratch_.chi[k] > maximum_error_kernel) {
+        inliers_[u] = false;
+        if (ignore_outliers_) {
+          block_.robust_error += maximum_error_kernel_;
+          continue;
+        }
+
+        //ds proportionally reduce information value of the measurement
+        scratch_.weight[k]  = maximum_error_kernel/scratch_.chi[k];
+        block_.robust_error += maximum_error_kernel_*(1+std::log(scratch_.chi[k]/maximum_error_kernel));
+      } else {
+        inliers_[u]         = true;
+        scratch_.weight[k]  = 1;
+        block_.robust_error += scratch_.chi[k];
+        ++block_.number_of_inliers;
+      }
+      block_.total_error += errors_[u];
+    }
+    for (Index r = 0; r < dimension_; ++r) {
+      for (Index k = 0; k < number_of_measurements_; ++k) {
+        scratch_.omega[r][k] = (scratch_.weight[k] > 0) ? scratch_.omega[r][k]*scratch_.weight[k] : 0;
+      }
+    }
+
+    //ds update H (upper triangle, mirrored) and b
+    for (Index i = 0; i < states_; ++i) {
+      for (Index j = i; j < states_; ++j) {
+        AlignerScalar sum = 0;
+        for (Index r = 0; r < dimension_; ++r) {
+          const AlignerScalar* omega      = scratch_.omega[r];
+          const AlignerScalar* jacobian_i = scratch_.jacobian[r][i];
+          const AlignerScalar* jacobian_j = scratch_.jacobian[r][j];
+          for (Index k = 0; k < number_of_measurements_; ++k) {
+            sum += omega[k]*jacobian_i[k]*jacobian_j[k];
+          }
+        }
+        block_.H(i, j) += sum;
+        if (i != j) {
+          block_.H(j, i) += sum;
+        }
+      }
+      AlignerScalar sum = 0;
+      for (Index r = 0; r < dimension_; ++r) {
+        const AlignerScalar* omega      = scratch_.omega[r];
+        const AlignerScalar* jacobian_i = scratch_.jacobian[r][i];
+        const AlignerScalar* error      = scratch_.error[r];
+        for (Index k = 0; k < number_of_measurements_; ++k) {
+          sum += omega[k]*jacobian_i[k]*error[k];
+        }
+      }
+      block_.b(i) += sum;
+    }
+  }
+
 //ds workspace variables
 protected:
 
@@ -103,5 +300,8 @@ protected:
 
   std::vector<DimensionMatrix, Eigen::aligned_allocator<DimensionMatrix> > _information_matrix_vector;
   std::vector<MeasurementVector, Eigen::aligned_allocator<MeasurementVector> > _fixed;
+
+  //! @brief partial linear systems of the last linearization
+  LinearizationBlockVector _linearization_blocks;
 };
 }
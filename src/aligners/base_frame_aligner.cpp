@@ -0,0 +1,103 @@
+#include "base_frame_aligner.h"
+
+namespace proslam {
+
+  void BaseFrameAligner::_convergeLevenbergMarquardt(Matrix6& H_, Vector6& b_) {
+    const double time_begin_seconds = srrg_core::getTime();
+    _number_of_iterations     = 0;
+    _has_exceeded_time_budget = false;
+
+    //ds robust phase: outliers contribute with proportionally reduced information
+    _has_system_converged = _optimizeLevenbergMarquardt(false, H_, b_, time_begin_seconds);
+
+    //ds if we have at least a certain number of inliers and more inliers than outliers - refine on inliers only
+    if (_has_system_converged && _number_of_inliers > _parameters->minimum_number_of_inliers && _number_of_inliers > _number_of_outliers) {
+      _has_system_converged = _optimizeLevenbergMarquardt(true, H_, b_, time_begin_seconds);
+    }
+    if (!_has_system_converged) {
+      LOG_WARNING(std::cerr << "BaseFrameAligner::_convergeLevenbergMarquardt|system did not converge - total error: " << _total_error
+                            << " inliers: " << _number_of_inliers << " outliers: " << _number_of_outliers
+                            << " iterations: " << _number_of_iterations << " (time budget exceeded: " << _has_exceeded_time_budget << ")" << std::endl)
+    }
+  }
+
+  bool BaseFrameAligner::_optimizeLevenbergMarquardt(const bool& ignore_outliers_, Matrix6& H_, Vector6& b_, const double& time_begin_seconds_) {
+
+    //ds linearize at the initial estimate and initialize the damping relative to the system scale
+    linearize(ignore_outliers_);
+    real robust_error_accepted = _robust_error;
+    real lambda               = std::max(1e-5*H_.diagonal().maxCoeff(), 1e-9);
+    real lambda_growth        = 2;
+    while (_number_of_iterations < _parameters->maximum_number_of_iterations) {
+
+      //ds stop if the time budget is exhausted (keeping the last accepted estimate)
+      if (_parameters->maximum_duration_seconds > 0 && srrg_core::getTime()-time_begin_seconds_ > _parameters->maximum_duration_seconds) {
+        _has_exceeded_time_budget = true;
+        return false;
+      }
+      ++_number_of_iterations;
+
+      //ds solve the damped system (the configured damping is kept as constant regularization)
+      Matrix6 H_damped(H_);
+      H_damped.diagonal().array() += lambda+_parameters->damping*_number_of_measurements;
+      const Vector6 perturbation = H_damped.ldlt().solve(-b_);
+
+      //ds converged if the step is negligible
+      if (perturbation.norm() < _parameters->minimum_step_norm) {
+        return true;
+      }
+
+      //ds buffer the last accepted state
+      const TransformMatrix3D previous_to_current_accepted(_previous_to_current);
+      const Matrix6 H_accepted(H_);
+      const Vector6 b_accepted(b_);
+      const Count number_of_inliers_accepted = _number_of_inliers;
+      const real total_error_accepted        = _total_error;
+      _errors_accepted  = _errors;
+      _inliers_accepted = _inliers;
+
+      //ds apply perturbation and enforce proper rotation matrix
+      _previous_to_current                 = srrg_core::v2t(perturbation)*_previous_to_current;
+      const Matrix3 rotation               = _previous_to_current.linear();
+      Matrix3 rotation_squared             = rotation.transpose()*rotation;
+      rotation_squared.diagonal().array() -= 1;
+      _previous_to_current.linear()       -= 0.5*rotation*rotation_squared;
+
+      //ds evaluate the step on the robust cost it was computed for (measurements lost by the step are charged the error kernel)
+      linearize(ignore_outliers_);
+      if (_robust_error < robust_error_accepted) {
+
+        //ds accept step and move towards Gauss-Newton
+        const real relative_error_delta = (robust_error_accepted-_robust_error)/robust_error_accepted;
+        robust_error_accepted = _robust_error;
+        lambda                = std::max(lambda/3, 1e-9);
+        lambda_growth         = 2;
+
+        //ds converged if the error decrease is negligible
+        if (relative_error_delta < _parameters->minimum_relative_error_delta) {
+          return true;
+        }
+      } else {
+
+        //ds reject step: restore the last accepted state and move towards gradient descent
+        _previous_to_current = previous_to_current_accepted;
+        H_                   = H_accepted;
+        b_                   = b_accepted;
+        _number_of_inliers   = number_of_inliers_accepted;
+        _number_of_outliers  = _number_of_measurements-_number_of_inliers;
+        _total_error         = total_error_accepted;
+        _robust_error        = robust_error_accepted;
+        _errors.swap(_errors_accepted);
+        _inliers.swap(_inliers_accepted);
+        lambda        *= lambda_growth;
+        lambda_growth *= 2;
+
+        //ds give up if no descent is found even for (nearly) pure gradient steps - this is not convergence
+        if (lambda > 1e12) {
+          return false;
+        }
+      }
+    }
+    return false;
+  }
+}
@@ -21,11 +21,35 @@ public:
                           const Frame* frame_current_,
                           const TransformMatrix3D& previous_to_current_) = 0;
 
+//ds helpers
+protected:
+
+  //! @brief Levenberg-Marquardt convergence policy: adaptively damped steps solved with LDLT, which are only accepted if they decrease
+  //! @brief the robust error. Stops on a negligible step norm or relative error decrease (converged), the iteration cap or the time budget
+  //! @brief (not converged, the last accepted estimate is kept). Outliers are downweighted first, followed by an inlier only refinement
+  //! @param[in,out] H_ linear system of the concrete aligner workspace (filled by linearize)
+  //! @param[in,out] b_ linear system of the concrete aligner workspace (filled by linearize)
+  void _convergeLevenbergMarquardt(Matrix6& H_, Vector6& b_);
+
+  //! @brief single Levenberg-Marquardt phase (see _convergeLevenbergMarquardt)
+  //! @param[in] ignore_outliers_ phase selection
+  //! @param[in,out] H_ linear system of the concrete aligner workspace (filled by linearize)
+  //! @param[in,out] b_ linear system of the concrete aligner workspace (filled by linearize)
+  //! @param[in] time_begin_seconds_ start of the alignment (time budget)
+  //! @return true if converged (false if the iteration or time budget is exhausted or no descent direction is found)
+  bool _optimizeLevenbergMarquardt(const bool& ignore_outliers_, Matrix6& H_, Vector6& b_, const double& time_begin_seconds_);
+
 //ds setters/getters
 public:
 
   inline const TransformMatrix3D& previousToCurrent() const {return _previous_to_current;}
 
+  //! @brief true if the last alignment was stopped by the time budget (LEVENBERG_MARQUARDT)
+  inline const bool hasExceededTimeBudget() const {return _has_exceeded_time_budget;}
+
+  //! @brief shared thread pool for the parallel linearization (sequential linearization if not set)
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
+
 //ds attributes
 protected:
 
@@ -38,6 +62,16 @@ protected:
 
   Count _number_of_rows_image = 0;
   Count _number_of_cols_image = 0;
+
+  //! @brief shared thread pool for the parallel linearization
+  ThreadPool* _thread_pool = nullptr;
+
+  //! @brief set if the last alignment was stopped by the time budget
+  bool _has_exceeded_time_budget = false;
+
+  //! @brief error statistics of the last accepted estimate (restored on rejected Levenberg-Marquardt steps)
+  std::vector<real> _errors_accepted;
+  std::vector<bool> _inliers_accepted;
 };
 
 typedef std::shared_ptr<BaseFrameAligner> BaseFrameAlignerPtr;
@@ -18,46 +18,51 @@ namespace proslam {
     _number_of_measurements = _frame_current->points().size();
     _errors.resize(_number_of_measurements);
     _inliers.resize(_number_of_measurements);
-    _information_matrix_vector.resize(_number_of_measurements);
-    _weights_translation.resize(_number_of_measurements, 1);
-    _moving.resize(_number_of_measurements);
-    _fixed.resize(_number_of_measurements);
+    for (std::vector<AlignerScalar>& field: _measurements) {
+      field.resize(_number_of_measurements);
+    }
 
-    //ds fill buffers
+    //ds pack the framepoint data once for all iterations
     for (Index u = 0; u < _number_of_measurements; ++u) {
       const FramePoint* frame_point = _frame_current->points()[u];
-      _information_matrix_vector[u].setIdentity();
       assert(_frame_current->cameraLeft()->isInFieldOfView(frame_point->imageCoordinatesLeft()));
       assert(_frame_current->cameraRight()->isInFieldOfView(frame_point->imageCoordinatesRight()));
       assert(frame_point->previous());
       const FramePoint* previous = frame_point->previous();
 
       //ds set fixed part (image coordinates)
-      _fixed[u](0) = frame_point->imageCoordinatesLeft().x();
-      _fixed[u](1) = frame_point->imageCoordinatesLeft().y();
-      _fixed[u](2) = frame_point->imageCoordinatesRight().x();
-      _fixed[u](3) = frame_point->imageCoordinatesRight().y();
+      _measurements[FIXED_U_LEFT][u]  = frame_point->imageCoordinatesLeft().x();
+      _measurements[FIXED_V_LEFT][u]  = frame_point->imageCoordinatesLeft().y();
+      _measurements[FIXED_U_RIGHT][u] = frame_point->imageCoordinatesRight().x();
+      _measurements[FIXED_V_RIGHT][u] = frame_point->imageCoordinatesRight().y();
 
       //ds if we have a landmark
+      PointCoordinates moving;
+      real information = 1;
       if (previous->landmark()) {
         assert(previous->landmark()->numberOfUpdates() > 1);
 
         //ds prefer landmark estimate
-        _moving[u] = previous->cameraCoordinatesLeftLandmark();
+        moving = previous->cameraCoordinatesLeftLandmark();
 
         //ds increase weight with the number of updates - purely additive
-        _information_matrix_vector[u] *= (1+log(previous->landmark()->numberOfUpdates()));
+        information *= (1+log(previous->landmark()->numberOfUpdates()));
       } else {
 
         //ds set moving part (3D point coordinates)
-        _moving[u] = previous->cameraCoordinatesLeft();
+        moving = previous->cameraCoordinatesLeft();
       }
+      _measurements[MOVING_X][u]    = moving.x();
+      _measurements[MOVING_Y][u]    = moving.y();
+      _measurements[MOVING_Z][u]    = moving.z();
+      _measurements[INFORMATION][u] = information;
 
       //ds if individual weighting is desired
+      _measurements[WEIGHT_TRANSLATION][u] = 1;
       if (_parameters->enable_inverse_depth_as_information) {
 
         //ds use inverse depth as weight for translation contribution in jacobian: )0,1) * I
-        _weights_translation[u] = std::min(_maximum_reliable_depth_meters/frame_point->depthMeters(), 1.0);
+        _measurements[WEIGHT_TRANSLATION][u] = std::min(_maximum_reliable_depth_meters/frame_point->depthMeters(), 1.0);
       }
     }
 
@@ -71,119 +76,101 @@ namespace proslam {
   //ds linearize the system: to be called inside oneRound
   void StereoUVAligner::linearize(const bool& ignore_outliers_) {
 
-    //ds initialize setup
-    _H.setZero();
-    _b.setZero();
-    _number_of_inliers = 0;
-    _total_error       = 0;
+    //ds linearize all current framepoints (assuming that each of them has a previous one) in parallel blocks
+    _linearizeInBlocks(_number_of_measurements, [this, &ignore_outliers_](const Index& index_begin_, const Index& index_end_, LinearizationBlock& block_) {
+      _linearizeBlock(index_begin_, index_end_, ignore_outliers_, block_);
+    }, _thread_pool, _number_of_inliers, _total_error, _robust_error);
+    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+  }
 
-    //ds loop over all current framepoints (assuming that each of them has a previous one)
-    for (Index u = 0; u < _number_of_measurements; ++u) {
-      _errors[u]  = -1;
-      _inliers[u] = false;
-      _omega      = _information_matrix_vector[u];
+  //ds linearize a block of measurements (called concurrently for disjoint blocks)
+  void StereoUVAligner::_linearizeBlock(const Index& index_begin_,
+                                        const Index& index_end_,
+                                        const bool& ignore_outliers_,
+                                        LinearizationBlock& block_) {
+    LinearizationScratch scratch;
+    const Count number_of_measurements = index_end_-index_begin_;
+
+    //ds constant terms in packed precision
+    const AlignerScalar r00 = _previous_to_current(0,0), r01 = _previous_to_current(0,1), r02 = _previous_to_current(0,2);
+    const AlignerScalar r10 = _previous_to_current(1,0), r11 = _previous_to_current(1,1), r12 = _previous_to_current(1,2);
+    const AlignerScalar r20 = _previous_to_current(2,0), r21 = _previous_to_current(2,1), r22 = _previous_to_current(2,2);
+    const AlignerScalar t0  = _previous_to_current(0,3), t1  = _previous_to_current(1,3), t2  = _previous_to_current(2,3);
+    const AlignerScalar k00 = _camera_calibration_matrix(0,0), k01 = _camera_calibration_matrix(0,1), k02 = _camera_calibration_matrix(0,2);
+    const AlignerScalar k10 = _camera_calibration_matrix(1,0), k11 = _camera_calibration_matrix(1,1), k12 = _camera_calibration_matrix(1,2);
+    const AlignerScalar k20 = _camera_calibration_matrix(2,0), k21 = _camera_calibration_matrix(2,1), k22 = _camera_calibration_matrix(2,2);
+    const AlignerScalar o0 = _offset_camera_right.x(), o1 = _offset_camera_right.y(), o2 = _offset_camera_right.z();
+    const AlignerScalar minimum_depth_meters = _minimum_reliable_depth_meters;
+    const AlignerScalar number_of_cols_image = _number_of_cols_image;
+    const AlignerScalar number_of_rows_image = _number_of_rows_image;
+    const AlignerScalar* moving_x           = &_measurements[MOVING_X][index_begin_];
+    const AlignerScalar* moving_y           = &_measurements[MOVING_Y][index_begin_];
+    const AlignerScalar* moving_z           = &_measurements[MOVING_Z][index_begin_];
+    const AlignerScalar* fixed_u_left       = &_measurements[FIXED_U_LEFT][index_begin_];
+    const AlignerScalar* fixed_v_left       = &_measurements[FIXED_V_LEFT][index_begin_];
+    const AlignerScalar* fixed_u_right      = &_measurements[FIXED_U_RIGHT][index_begin_];
+    const AlignerScalar* fixed_v_right      = &_measurements[FIXED_V_RIGHT][index_begin_];
+    const AlignerScalar* information        = &_measurements[INFORMATION][index_begin_];
+    const AlignerScalar* weight_translation = &_measurements[WEIGHT_TRANSLATION][index_begin_];
+
+    //ds branch-free pass over the block: invalid measurements are evaluated with a unit depth and flagged
+    for (Index k = 0; k < number_of_measurements; ++k) {
 
       //ds compute the point in the camera frame - prefering a landmark estimate if available
-      const PointCoordinates sampled_point_in_camera_left = _previous_to_current*_moving[u];
-      if (sampled_point_in_camera_left.z() < _minimum_reliable_depth_meters) {
-        continue;
-      }
+      const AlignerScalar x = r00*moving_x[k]+r01*moving_y[k]+r02*moving_z[k]+t0;
+      const AlignerScalar y = r10*moving_x[k]+r11*moving_y[k]+r12*moving_z[k]+t1;
+      const AlignerScalar z = r20*moving_x[k]+r21*moving_y[k]+r22*moving_z[k]+t2;
+      const bool is_in_front = (z >= minimum_depth_meters);
 
       //ds retrieve projections on left and right camera image plane
-      const PointCoordinates sampled_abc_in_camera_left  = _camera_calibration_matrix*sampled_point_in_camera_left;
-      const PointCoordinates sampled_abc_in_camera_right = sampled_abc_in_camera_left+_offset_camera_right;
-      const real& sampled_c_left  = sampled_abc_in_camera_left.z();
-      const real& sampled_c_right = sampled_abc_in_camera_right.z();
+      const AlignerScalar a_left  = k00*x+k01*y+k02*z;
+      const AlignerScalar b_left  = k10*x+k11*y+k12*z;
+      const AlignerScalar c_left  = is_in_front ? k20*x+k21*y+k22*z : 1;
+      const AlignerScalar a_right = a_left+o0;
+      const AlignerScalar b_right = b_left+o1;
+      const AlignerScalar c_right = is_in_front ? c_left+o2 : 1;
 
       //ds compute the image coordinates
-      const PointCoordinates sampled_point_in_image_left  = sampled_abc_in_camera_left/sampled_c_left;
-      const PointCoordinates sampled_point_in_image_right = sampled_abc_in_camera_right/sampled_c_right;
-
-      //ds if the point is outside the image, skip
-      if (sampled_point_in_image_left.x() < 0 || sampled_point_in_image_left.x() > _number_of_cols_image||
-          sampled_point_in_image_left.y() < 0 || sampled_point_in_image_left.y() > _number_of_rows_image) {
-        continue;
-      }
-      if (sampled_point_in_image_right.x() < 0 || sampled_point_in_image_right.x() > _number_of_cols_image||
-          sampled_point_in_image_right.y() < 0 || sampled_point_in_image_right.y() > _number_of_rows_image) {
-        continue;
-      }
-      assert(_frame_current->cameraLeft()->isInFieldOfView(sampled_point_in_image_left));
-      assert(_frame_current->cameraRight()->isInFieldOfView(sampled_point_in_image_right));
+      const AlignerScalar inverse_c_left  = 1/c_left;
+      const AlignerScalar inverse_c_right = 1/c_right;
+      const AlignerScalar u_left  = a_left*inverse_c_left;
+      const AlignerScalar v_left  = b_left*inverse_c_left;
+      const AlignerScalar u_right = a_right*inverse_c_right;
+      const AlignerScalar v_right = b_right*inverse_c_right;
+
+      //ds the point has to be inside both images
+      scratch.is_valid[k] = is_in_front &&
+                            u_left >= 0 && u_left <= number_of_cols_image && v_left >= 0 && v_left <= number_of_rows_image &&
+                            u_right >= 0 && u_right <= number_of_cols_image && v_right >= 0 && v_right <= number_of_rows_image;
 
       //ds compute error (we compute the vertical error only once, since we assume rectified cameras)
-      const Vector4 error(sampled_point_in_image_left.x()-_fixed[u](0),
-                          sampled_point_in_image_left.y()-_fixed[u](1),
-                          sampled_point_in_image_right.x()-_fixed[u](2),
-                          sampled_point_in_image_right.y()-_fixed[u](3));
-
-      //ds compute squared error
-      const real chi = error.transpose()*_omega*error;
-
-      //ds update error stats
-      _errors[u] = chi;
-
-      //ds check if outlier
-      if (chi > _parameters->maximum_error_kernel) {
-        if (ignore_outliers_) {
-          continue;
-        }
-
-        //ds proportionally reduce information value of the measurement
-        _omega *= _parameters->maximum_error_kernel/chi;
-      } else {
-        _inliers[u] = true;
-        ++_number_of_inliers;
+      scratch.error[0][k] = u_left-fixed_u_left[k];
+      scratch.error[1][k] = v_left-fixed_v_left[k];
+      scratch.error[2][k] = u_right-fixed_u_right[k];
+      scratch.error[3][k] = v_right-fixed_v_right[k];
+      for (Index r = 0; r < 4; ++r) {
+        scratch.omega[r][k] = information[k];
       }
 
-      //ds update total error
-      _total_error += _errors[u];
-
-      //ds compute the jacobian of the transformation
-      Matrix3_6 jacobian_transform;
-
-      //ds translation contribution (will be scaled with omega)
-      jacobian_transform.block<3,3>(0,0) = _weights_translation[u]*Matrix3::Identity();
-
-      //ds rotation contribution - compensate for inverse depth (far points should have an equally strong contribution as close ones)
-      jacobian_transform.block<3,3>(0,3) = -2*srrg_core::skew(sampled_point_in_camera_left);
-
-      //ds precompute
-      const Matrix3_6 camera_matrix_per_jacobian_transform(_camera_calibration_matrix*jacobian_transform);
-
-      //ds precompute
-      const real inverse_sampled_c_left  = 1/sampled_c_left;
-      const real inverse_sampled_c_right = 1/sampled_c_right;
-      const real inverse_sampled_c_squared_left  = inverse_sampled_c_left*inverse_sampled_c_left;
-      const real inverse_sampled_c_squared_right = inverse_sampled_c_right*inverse_sampled_c_right;
-
-      //ds jacobian parts of the homogeneous division: left
-      Matrix2_3 jacobian_left;
-      jacobian_left << inverse_sampled_c_left, 0, -sampled_abc_in_camera_left.x()*inverse_sampled_c_squared_left,
-                       0, inverse_sampled_c_left, -sampled_abc_in_camera_left.y()*inverse_sampled_c_squared_left;
-
-      //ds we compute only the contribution for the horizontal error: right
-      Matrix2_3 jacobian_right;
-      jacobian_right << inverse_sampled_c_right, 0, -sampled_abc_in_camera_right.x()*inverse_sampled_c_squared_right,
-                        0, inverse_sampled_c_right, -sampled_abc_in_camera_right.y()*inverse_sampled_c_squared_right;
-
-      //ds assemble final jacobian
-      _jacobian.setZero();
-
-      //ds we have to compute the full block
-      _jacobian.block<2,6>(0,0) = jacobian_left*camera_matrix_per_jacobian_transform;
-
-      //ds we only have to compute the horizontal block
-      _jacobian.block<2,6>(2,0) = jacobian_right*camera_matrix_per_jacobian_transform;
-
-      //ds precompute transposed
-      const Matrix6_4 jacobian_transposed(_jacobian.transpose());
-
-      //ds update H and b
-      _H += jacobian_transposed*_omega*_jacobian;
-      _b += jacobian_transposed*_omega*error;
+      //ds jacobian rows: the derivative of each image coordinate with respect to the point is m = (K_row-coordinate*K_2)/c
+      //ds translation contribution (scaled with the translation weight) is m, rotation contribution is 2*(point x m)
+      const AlignerScalar m[4][3] = {{(k00-u_left*k20)*inverse_c_left,   (k01-u_left*k21)*inverse_c_left,   (k02-u_left*k22)*inverse_c_left},
+                                     {(k10-v_left*k20)*inverse_c_left,   (k11-v_left*k21)*inverse_c_left,   (k12-v_left*k22)*inverse_c_left},
+                                     {(k00-u_right*k20)*inverse_c_right, (k01-u_right*k21)*inverse_c_right, (k02-u_right*k22)*inverse_c_right},
+                                     {(k10-v_right*k20)*inverse_c_right, (k11-v_right*k21)*inverse_c_right, (k12-v_right*k22)*inverse_c_right}};
+      for (Index r = 0; r < 4; ++r) {
+        scratch.jacobian[r][0][k] = weight_translation[k]*m[r][0];
+        scratch.jacobian[r][1][k] = weight_translation[k]*m[r][1];
+        scratch.jacobian[r][2][k] = weight_translation[k]*m[r][2];
+        scratch.jacobian[r][3][k] = 2*(y*m[r][2]-z*m[r][1]);
+        scratch.jacobian[r][4][k] = 2*(z*m[r][0]-x*m[r][2]);
+        scratch.jacobian[r][5][k] = 2*(x*m[r][1]-y*m[r][0]);
+      }
     }
-    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+
+    //ds error statistics, robust kernel and update of H and b
+    _accumulateLinearizationScratch(scratch, index_begin_, number_of_measurements, ignore_outliers_,
+                                    _parameters->maximum_error_kernel, _errors, _inliers, block_);
   }
 
   //ds solve alignment problem for one round
@@ -209,12 +196,37 @@ namespace proslam {
   //ds solve alignment problem until convergence is reached
   void StereoUVAligner::converge() {
 
+    //ds iterate with the configured policy
+    if (_parameters->convergence_policy == AlignerParameters::ConvergencePolicy::LEVENBERG_MARQUARDT) {
+      _convergeLevenbergMarquardt(_H, _b);
+
+      //ds compute information matrix
+      _information_matrix = _H;
+    } else {
+      _convergeGaussNewton();
+    }
+
+    //ds VISUALIZATION ONLY
+    for (Index u = 0; u < _number_of_measurements; ++u) {
+      FramePoint* frame_point = _frame_current->points()[u];
+      const PointCoordinates moving(_measurements[MOVING_X][u], _measurements[MOVING_Y][u], _measurements[MOVING_Z][u]);
+      ImageCoordinates image_coordinates(_camera_calibration_matrix*_previous_to_current*moving);
+      image_coordinates /= image_coordinates.z();
+      frame_point->setProjectionEstimateLeftOptimized(cv::Point2f(image_coordinates.x(), image_coordinates.y()));
+    }
+  }
+
+  //ds Gauss-Newton iterations until the error delta falls below the threshold
+  void StereoUVAligner::_convergeGaussNewton() {
+
     //ds previous error to check for convergence
     real total_error_previous = 0;
+    _number_of_iterations     = 0;
 
     //ds start LS
     for (Count iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
       oneRound(false);
+      ++_number_of_iterations;
 
       //ds check if converged (no descent required)
       if (_parameters->error_delta_for_convergence > std::fabs(total_error_previous-_total_error)) {
@@ -224,6 +236,7 @@ namespace proslam {
         if (_number_of_inliers > _parameters->minimum_number_of_inliers && _number_of_inliers > _number_of_outliers) {
           for (Count iteration_inlier = 0; iteration_inlier < _parameters->maximum_number_of_iterations; ++iteration_inlier) {
             oneRound(true);
+            ++_number_of_iterations;
 
             //ds check for convergence
             if (std::fabs(total_error_previous-_total_error) < _parameters->error_delta_for_convergence) {
@@ -253,13 +266,5 @@ namespace proslam {
                   << " inliers: " << _number_of_inliers << " outliers: " << _number_of_outliers << std::endl)
       }
     }
-
-    //ds VISUALIZATION ONLY
-    for (Index u = 0; u < _number_of_measurements; ++u) {
-      FramePoint* frame_point = _frame_current->points()[u];
-      ImageCoordinates image_coordinates(_camera_calibration_matrix*_previous_to_current*_moving[u]);
-      image_coordinates /= image_coordinates.z();
-      frame_point->setProjectionEstimateLeftOptimized(cv::Point2f(image_coordinates.x(), image_coordinates.y()));
-    }
   }
 }
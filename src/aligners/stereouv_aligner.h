@@ -26,6 +26,19 @@ public:
   //ds solve alignment problem until convergence is reached
   virtual void converge();
 
+//ds helpers
+protected:
+
+  //! @brief linearizes the measurements [index_begin_, index_end_) into a partial system (called concurrently for disjoint blocks)
+  void _linearizeBlock(const Index& index_begin_,
+                       const Index& index_end_,
+                       const bool& ignore_outliers_,
+                       LinearizationBlock& block_);
+
+  //! @brief GAUSS_NEWTON convergence policy: undamped rounds (fullPivLu) until the error delta falls below error_delta_for_convergence
+  //! @brief followed by inlier only rounds
+  void _convergeGaussNewton();
+
 //ds aligner specific
 protected:
 
@@ -33,8 +46,19 @@ protected:
   CameraMatrix _camera_calibration_matrix   = CameraMatrix::Zero();
   Vector3 _offset_camera_right              = Vector3::Zero();
 
-  //ds 3D points in camera frame
-  std::vector<Vector3, Eigen::aligned_allocator<Vector3> > _moving;
-  std::vector<real> _weights_translation;
+  //! @brief per-measurement fields of the packed buffers
+  enum Field {MOVING_X,             //ds 3D point in camera frame (previous)
+              MOVING_Y,
+              MOVING_Z,
+              FIXED_U_LEFT,         //ds measured image coordinates (current)
+              FIXED_V_LEFT,
+              FIXED_U_RIGHT,
+              FIXED_V_RIGHT,
+              INFORMATION,          //ds isotropic information value
+              WEIGHT_TRANSLATION,   //ds translational contribution weight
+              NUMBER_OF_FIELDS};
+
+  //! @brief measurements packed once per frame in structure-of-arrays layout (one contiguous buffer per field)
+  std::vector<AlignerScalar> _measurements[NUMBER_OF_FIELDS];
 };
 }
@@ -19,51 +19,56 @@ namespace proslam {
     _number_of_measurements = _frame_current->points().size();
     _errors.resize(_number_of_measurements);
     _inliers.resize(_number_of_measurements);
-    _information_matrix_vector.resize(_number_of_measurements);
-    _weights_translation.resize(_number_of_measurements, 1);
-    _moving.resize(_number_of_measurements);
-    _fixed.resize(_number_of_measurements);
+    for (std::vector<AlignerScalar>& field: _measurements) {
+      field.resize(_number_of_measurements);
+    }
 
-    //ds fill buffers
+    //ds pack the framepoint data once for all iterations
     for (Index u = 0; u < _number_of_measurements; ++u) {
       const FramePoint* frame_point = _frame_current->points()[u];
-      _information_matrix_vector[u].setIdentity();
 
       //ds measurement: set fixed part U, V, Depth
-      _fixed[u](0) = frame_point->imageCoordinatesLeft().x();
-      _fixed[u](1) = frame_point->imageCoordinatesLeft().y();
-      _fixed[u](2) = frame_point->cameraCoordinatesLeft().z();
+      _measurements[FIXED_U][u]     = frame_point->imageCoordinatesLeft().x();
+      _measurements[FIXED_V][u]     = frame_point->imageCoordinatesLeft().y();
+      _measurements[FIXED_DEPTH][u] = frame_point->cameraCoordinatesLeft().z();
 
       //ds if we have a landmark
+      PointCoordinates moving;
+      real information = 1;
       if (frame_point->landmark()) {
 
         //ds prefer landmark estimate
-        _moving[u] = frame_point->previous()->cameraCoordinatesLeftLandmark();
+        moving = frame_point->previous()->cameraCoordinatesLeftLandmark();
 
         //ds increase weight linear in the number of updates
-        _information_matrix_vector[u] *= (1+frame_point->landmark()->numberOfUpdates());
+        information *= (1+frame_point->landmark()->numberOfUpdates());
       } else {
 
         //ds set moving part (3D point coordinates)
-        _moving[u] = frame_point->previous()->cameraCoordinatesLeft();
+        moving = frame_point->previous()->cameraCoordinatesLeft();
       }
+      _measurements[MOVING_X][u]       = moving.x();
+      _measurements[MOVING_Y][u]       = moving.y();
+      _measurements[MOVING_Z][u]       = moving.z();
+      _measurements[INFORMATION_UV][u] = information;
 
       //ds we scale the depth error by a factor to be competitive with the U V (pixel) error which is in integer format
-      _information_matrix_vector[u](2,2) *= 10.0;
+      _measurements[INFORMATION_DEPTH][u]  = 10*information;
+      _measurements[WEIGHT_TRANSLATION][u] = 1;
 
       //ds if we cannot consider the translation contribution of the point
       if (frame_point->hasUnreliableDepth()) {
 
         //ds block translation contribution
-        _weights_translation[u] = 0;
+        _measurements[WEIGHT_TRANSLATION][u] = 0;
 
         //ds and disable error on the depth
-        _information_matrix_vector[u](2,2) = 0;
+        _measurements[INFORMATION_DEPTH][u] = 0;
       } else if (_parameters->enable_inverse_depth_as_information) {
 
         //ds translation contribution is inversely proportional to depth
         //ds TODO check if this is truly beneficial since we already consider the depth in the error!
-        _weights_translation[u] = _maximum_reliable_depth_meters/frame_point->cameraCoordinatesLeft().z();
+        _measurements[WEIGHT_TRANSLATION][u] = _maximum_reliable_depth_meters/frame_point->cameraCoordinatesLeft().z();
       }
     }
 
@@ -76,98 +81,90 @@ namespace proslam {
   //ds linearize the system: to be called inside oneRound
   void UVDAligner::linearize(const bool& ignore_outliers_) {
 
-    //ds initialize setup
-    _H.setZero();
-    _b.setZero();
-    _number_of_inliers  = 0;
-    _number_of_outliers = 0;
-    _total_error        = 0;
+    //ds linearize all points (assumed to have previous points) in parallel blocks
+    _linearizeInBlocks(_number_of_measurements, [this, &ignore_outliers_](const Index& index_begin_, const Index& index_end_, LinearizationBlock& block_) {
+      _linearizeBlock(index_begin_, index_end_, ignore_outliers_, block_);
+    }, _thread_pool, _number_of_inliers, _total_error, _robust_error);
+    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+  }
 
-    //ds loop over all points (assumed to have previous points)
-    for (Index u = 0; u < _frame_current->points().size(); ++u) {
-      _errors[u]  = -1;
-      _inliers[u] = false;
-      _omega      = _information_matrix_vector[u];
+  //ds linearize a block of measurements (called concurrently for disjoint blocks)
+  void UVDAligner::_linearizeBlock(const Index& index_begin_,
+                                   const Index& index_end_,
+                                   const bool& ignore_outliers_,
+                                   LinearizationBlock& block_) {
+    LinearizationScratch scratch;
+    const Count number_of_measurements = index_end_-index_begin_;
+
+    //ds constant terms in packed precision
+    const AlignerScalar r00 = _previous_to_current(0,0), r01 = _previous_to_current(0,1), r02 = _previous_to_current(0,2);
+    const AlignerScalar r10 = _previous_to_current(1,0), r11 = _previous_to_current(1,1), r12 = _previous_to_current(1,2);
+    const AlignerScalar r20 = _previous_to_current(2,0), r21 = _previous_to_current(2,1), r22 = _previous_to_current(2,2);
+    const AlignerScalar t0  = _previous_to_current(0,3), t1  = _previous_to_current(1,3), t2  = _previous_to_current(2,3);
+    const AlignerScalar k00 = _camera_calibration_matrix(0,0), k01 = _camera_calibration_matrix(0,1), k02 = _camera_calibration_matrix(0,2);
+    const AlignerScalar k10 = _camera_calibration_matrix(1,0), k11 = _camera_calibration_matrix(1,1), k12 = _camera_calibration_matrix(1,2);
+    const AlignerScalar k20 = _camera_calibration_matrix(2,0), k21 = _camera_calibration_matrix(2,1), k22 = _camera_calibration_matrix(2,2);
+    const AlignerScalar minimum_depth_meters = _minimum_reliable_depth_meters;
+    const AlignerScalar number_of_cols_image = _number_of_cols_image;
+    const AlignerScalar number_of_rows_image = _number_of_rows_image;
+    const AlignerScalar* moving_x           = &_measurements[MOVING_X][index_begin_];
+    const AlignerScalar* moving_y           = &_measurements[MOVING_Y][index_begin_];
+    const AlignerScalar* moving_z           = &_measurements[MOVING_Z][index_begin_];
+    const AlignerScalar* fixed_u            = &_measurements[FIXED_U][index_begin_];
+    const AlignerScalar* fixed_v            = &_measurements[FIXED_V][index_begin_];
+    const AlignerScalar* fixed_depth        = &_measurements[FIXED_DEPTH][index_begin_];
+    const AlignerScalar* information_uv     = &_measurements[INFORMATION_UV][index_begin_];
+    const AlignerScalar* information_depth  = &_measurements[INFORMATION_DEPTH][index_begin_];
+    const AlignerScalar* weight_translation = &_measurements[WEIGHT_TRANSLATION][index_begin_];
+
+    //ds branch-free pass over the block: invalid measurements are evaluated with a unit depth and flagged
+    for (Index k = 0; k < number_of_measurements; ++k) {
 
       //ds compute the point in the camera frame
-      const PointCoordinates predicted_point_in_camera = _previous_to_current*_moving[u];
-      const real depth_meters                          = predicted_point_in_camera.z();
-      if (depth_meters <= _minimum_reliable_depth_meters) {
-        continue;
-      }
-
-      //ds retrieve homogeneous projections
-      const PointCoordinates predicted_uvd_in_camera = _camera_calibration_matrix*predicted_point_in_camera;
-      
-      //ds compute the image coordinates (homogeneous division)
-      PointCoordinates predicted_point_in_image  = predicted_uvd_in_camera/predicted_uvd_in_camera.z();
-
-      //ds restore the depth in the third component as we will confront it with the measured depth from the sensor
-      predicted_point_in_image.z() = depth_meters;
-      
-      //ds if the point is outside the image, skip
-      if (predicted_point_in_image.x() < 0 || predicted_point_in_image.x() > _number_of_cols_image||
-          predicted_point_in_image.y() < 0 || predicted_point_in_image.y() > _number_of_rows_image) {
-        continue;
-      }
+      const AlignerScalar x = r00*moving_x[k]+r01*moving_y[k]+r02*moving_z[k]+t0;
+      const AlignerScalar y = r10*moving_x[k]+r11*moving_y[k]+r12*moving_z[k]+t1;
+      const AlignerScalar z = r20*moving_x[k]+r21*moving_y[k]+r22*moving_z[k]+t2;
+      const bool is_in_front = (z > minimum_depth_meters);
+      const AlignerScalar depth_meters = is_in_front ? z : 1;
+
+      //ds retrieve homogeneous projections and compute the image coordinates (homogeneous division)
+      const AlignerScalar a = k00*x+k01*y+k02*z;
+      const AlignerScalar b = k10*x+k11*y+k12*z;
+      const AlignerScalar c = is_in_front ? k20*x+k21*y+k22*z : 1;
+      const AlignerScalar inverse_c = 1/c;
+      const AlignerScalar u = a*inverse_c;
+      const AlignerScalar v = b*inverse_c;
+
+      //ds the point has to be inside the image
+      scratch.is_valid[k] = is_in_front && u >= 0 && u <= number_of_cols_image && v >= 0 && v <= number_of_rows_image;
 
       //ds compute error (U V D)
-      const Vector3 error(predicted_point_in_image.x()-_fixed[u](0),
-                          predicted_point_in_image.y()-_fixed[u](1),
-                          predicted_point_in_image.z()-_fixed[u](2));
-
-      //ds compute squared error
-      const real chi = error.transpose()*_omega*error;
-
-      //ds update error stats
-      _errors[u] = chi;
-
-      //ds check if outlier
-      if (chi > _parameters->maximum_error_kernel) {
-        if (ignore_outliers_) {
-          continue;
-        }
-
-        //ds proportionally reduce information value of the measurement
-        _omega *= _parameters->maximum_error_kernel/chi;
-      } else {
-        _inliers[u] = true;
-        ++_number_of_inliers;
+      scratch.error[0][k] = u-fixed_u[k];
+      scratch.error[1][k] = v-fixed_v[k];
+      scratch.error[2][k] = depth_meters-fixed_depth[k];
+      scratch.omega[0][k] = information_uv[k];
+      scratch.omega[1][k] = information_uv[k];
+      scratch.omega[2][k] = information_depth[k];
+
+      //ds jacobian rows: the derivative of the image coordinates with respect to the point is m = (K_row-a|b/z*K_2)/z
+      //ds and K_2 for the depth, translation contribution (scaled with the translation weight) is m, rotation contribution is 2*(point x m)
+      const AlignerScalar inverse_z = 1/depth_meters;
+      const AlignerScalar m[3][3] = {{(k00-a*inverse_z*k20)*inverse_z, (k01-a*inverse_z*k21)*inverse_z, (k02-a*inverse_z*k22)*inverse_z},
+                                     {(k10-b*inverse_z*k20)*inverse_z, (k11-b*inverse_z*k21)*inverse_z, (k12-b*inverse_z*k22)*inverse_z},
+                                     {k20, k21, k22}};
+      for (Index r = 0; r < 3; ++r) {
+        scratch.jacobian[r][0][k] = weight_translation[k]*m[r][0];
+        scratch.jacobian[r][1][k] = weight_translation[k]*m[r][1];
+        scratch.jacobian[r][2][k] = weight_translation[k]*m[r][2];
+        scratch.jacobian[r][3][k] = 2*(y*m[r][2]-z*m[r][1]);
+        scratch.jacobian[r][4][k] = 2*(z*m[r][0]-x*m[r][2]);
+        scratch.jacobian[r][5][k] = 2*(x*m[r][1]-y*m[r][0]);
       }
-
-      //ds update total error
-      _total_error += _errors[u];
-
-      //ds precompute partial derivatives of homogeneous division
-      const real inverse_z         = 1/depth_meters;
-      const real inverse_z_squared = inverse_z*inverse_z;
-
-      //ds compute the jacobian of the transformation
-      Matrix3_6 jacobian_transform;
-
-      //ds translation contribution
-      jacobian_transform.block<3,3>(0,0) = _weights_translation[u]*Matrix3::Identity();
-
-      //ds always consider rotation
-      jacobian_transform.block<3,3>(0,3) = -2*skew(predicted_point_in_camera);
-
-      //ds jacobian parts of the homogeneous division (note that we have a 3x3 instead of a 2x3 matrix since we want to map the depth as well)
-      Matrix3 jacobian_projection;
-      jacobian_projection << inverse_z, 0, -predicted_uvd_in_camera.x()*inverse_z_squared,
-                             0, inverse_z, -predicted_uvd_in_camera.y()*inverse_z_squared,
-                             0, 0, 1;
-
-      //ds assemble final jacobian
-      _jacobian = jacobian_projection*_camera_calibration_matrix*jacobian_transform;
-
-      //ds precompute transposed
-      const Matrix6_3 jacobian_transposed(_jacobian.transpose());
-
-      //ds update H and b
-      _H += jacobian_transposed*_omega*_jacobian;
-      _b += jacobian_transposed*_omega*error;
     }
-    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+
+    //ds error statistics, robust kernel and update of H and b
+    _accumulateLinearizationScratch(scratch, index_begin_, number_of_measurements, ignore_outliers_,
+                                    _parameters->maximum_error_kernel, _errors, _inliers, block_);
   }
 
   //ds solve alignment problem for one round
@@ -193,12 +190,37 @@ namespace proslam {
   //ds solve alignment problem until convergence is reached
   void UVDAligner::converge() {
 
+    //ds iterate with the configured policy
+    if (_parameters->convergence_policy == AlignerParameters::ConvergencePolicy::LEVENBERG_MARQUARDT) {
+      _convergeLevenbergMarquardt(_H, _b);
+
+      //ds compute information matrix
+      _information_matrix = _H;
+    } else {
+      _convergeGaussNewton();
+    }
+
+    //ds VISUALIZATION ONLY
+    for (Index u = 0; u < _number_of_measurements; ++u) {
+      FramePoint* frame_point = _frame_current->points()[u];
+      const PointCoordinates moving(_measurements[MOVING_X][u], _measurements[MOVING_Y][u], _measurements[MOVING_Z][u]);
+      ImageCoordinates image_coordinates(_camera_calibration_matrix*_previous_to_current*moving);
+      image_coordinates /= image_coordinates.z();
+      frame_point->setProjectionEstimateLeftOptimized(cv::Point2f(image_coordinates.x(), image_coordinates.y()));
+    }
+  }
+
+  //ds Gauss-Newton iterations until the error delta falls below the threshold
+  void UVDAligner::_convergeGaussNewton() {
+
     //ds previous error to check for convergence
     real total_error_previous = 0;
+    _number_of_iterations     = 0;
 
     //ds start LS
     for (Count iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
       oneRound(false);
+      ++_number_of_iterations;
 
       //ds check if converged (no descent required)
       if (_parameters->error_delta_for_convergence > std::fabs(total_error_previous-_total_error)) {
@@ -208,6 +230,7 @@ namespace proslam {
         if (_number_of_inliers > 100 && _number_of_inliers > _number_of_outliers) {
           for (Count iteration_inlier = 0; iteration_inlier < _parameters->maximum_number_of_iterations; ++iteration_inlier) {
             oneRound(true);
+            ++_number_of_iterations;
 
             //ds check for convergence
             if (std::fabs(total_error_previous-_total_error) < _parameters->error_delta_for_convergence) {
@@ -237,13 +260,5 @@ namespace proslam {
                               << " inliers: " << _number_of_inliers << " outliers: " << _number_of_outliers << std::endl)
       }
     }
-
-    //ds VISUALIZATION ONLY
-    for (Index u = 0; u < _number_of_measurements; ++u) {
-      FramePoint* frame_point = _frame_current->points()[u];
-      ImageCoordinates image_coordinates(_camera_calibration_matrix*_previous_to_current*_moving[u]);
-      image_coordinates /= image_coordinates.z();
-      frame_point->setProjectionEstimateLeftOptimized(cv::Point2f(image_coordinates.x(), image_coordinates.y()));
-    }
   }
 }
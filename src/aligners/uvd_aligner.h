@@ -26,16 +26,38 @@ public:
   //ds solve alignment problem until convergence is reached
   virtual void converge();
 
+//ds helpers
+protected:
+
+  //! @brief linearizes the measurements [index_begin_, index_end_) into a partial system (called concurrently for disjoint blocks)
+  void _linearizeBlock(const Index& index_begin_,
+                       const Index& index_end_,
+                       const bool& ignore_outliers_,
+                       LinearizationBlock& block_);
+
+  //! @brief GAUSS_NEWTON convergence policy: undamped rounds (fullPivLu) until the error delta falls below error_delta_for_convergence
+  //! @brief followed by inlier only rounds
+  void _convergeGaussNewton();
+
 //ds aligner specific
 protected:
 
   //ds buffers
   CameraMatrix _camera_calibration_matrix = CameraMatrix::Zero();
 
-  //ds 3D points in camera frame
-  std::vector<Vector3, Eigen::aligned_allocator<Vector3> > _moving;
-
-  //ds translational contribution weight (disabled for points at infinity)
-  std::vector<real> _weights_translation;
+  //! @brief per-measurement fields of the packed buffers
+  enum Field {MOVING_X,             //ds 3D point in camera frame (previous)
+              MOVING_Y,
+              MOVING_Z,
+              FIXED_U,              //ds measured image coordinates and depth (current)
+              FIXED_V,
+              FIXED_DEPTH,
+              INFORMATION_UV,       //ds diagonal information values
+              INFORMATION_DEPTH,
+              WEIGHT_TRANSLATION,   //ds translational contribution weight (disabled for points at infinity)
+              NUMBER_OF_FIELDS};
+
+  //! @brief measurements packed once per frame in structure-of-arrays layout (one contiguous buffer per field)
+  std::vector<AlignerScalar> _measurements[NUMBER_OF_FIELDS];
 };
 }
@@ -20,18 +20,28 @@ namespace proslam {
     _errors.resize(_number_of_measurements);
     _inliers.resize(_number_of_measurements);
 
-    //ds construct point cloud registration problem - compute landmark coordinates in local maps
+    //ds construct point cloud registration problem - landmark coordinates in local maps
+    //ds the landmark snapshots of the local maps are used, which are not modified by tracking or map optimization (safe for asynchronous relocalization)
     _information_matrix_vector.resize(_number_of_measurements);
     _moving.resize(_number_of_measurements);
     _fixed.resize(_number_of_measurements);
-    const TransformMatrix3D& world_to_reference_local_map(context_->local_map_reference->worldToRobot());
-    const TransformMatrix3D& world_to_query_local_map(context_->local_map_query->worldToRobot());
+    const Closure::LandmarkStateMap& landmarks_reference = context_->local_map_reference->landmarks();
+    const Closure::LandmarkStateMap& landmarks_query     = context_->local_map_query->landmarks();
     for (Index u = 0; u < _number_of_measurements; ++u) {
       const Closure::Correspondence* correspondence = _context->correspondences[u];
 
       //ds point coordinates to register
-      _fixed[u]  = world_to_reference_local_map*correspondence->reference->coordinates();
-      _moving[u] = world_to_query_local_map*correspondence->query->coordinates();
+      Closure::LandmarkStateMap::const_iterator iterator_reference = landmarks_reference.find(correspondence->reference->identifier());
+      Closure::LandmarkStateMap::const_iterator iterator_query     = landmarks_query.find(correspondence->query->identifier());
+      if (iterator_reference != landmarks_reference.end() && iterator_query != landmarks_query.end()) {
+        _fixed[u]  = iterator_reference->second.coordinates_in_local_map;
+        _moving[u] = iterator_query->second.coordinates_in_local_map;
+      } else {
+
+        //ds landmark not contained in local map (should not happen by construction) - fall back to current estimates
+        _fixed[u]  = context_->local_map_reference->worldToRobot()*correspondence->reference->coordinates();
+        _moving[u] = context_->local_map_query->worldToRobot()*correspondence->query->coordinates();
+      }
 
       //ds set information matrix
       _information_matrix_vector[u].setIdentity();
@@ -107,18 +117,23 @@ namespace proslam {
 
     //ds previous error to check for convergence
     real total_error_previous = 0.0;
+    _number_of_iterations       = 0;
 
     //ds start LS
     for (Count iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
       oneRound(false);
+      ++_number_of_iterations;
 
       //ds check if converged (no descent required)
       if (_parameters->error_delta_for_convergence > std::fabs(total_error_previous-_total_error)) {
 
         //ds trigger inlier only runs
         oneRound(true);
+        ++_number_of_iterations;
         oneRound(true);
+        ++_number_of_iterations;
         oneRound(true);
+        ++_number_of_iterations;
 
         //ds system converged
         _has_system_converged = true;
@@ -71,17 +71,27 @@ void  BaseFramePointGenerator::configure(){
   //ds log chosen descriptor type and size
   LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: " << _parameters->descriptor_type
                      << " (memory: " << SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS << "b)" << std::endl)
+  LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|descriptor distance kernel: "
+                     << DescriptorDistance::kernelName(DescriptorDistance::kernelType()) << std::endl)
 
   //ds allocate and initialize detector grid structure
   _detectors           = new cv::Ptr<cv::FastFeatureDetector>*[_parameters->number_of_detectors_vertical];
   _detector_regions    = new cv::Rect*[_parameters->number_of_detectors_vertical];
-  _detector_thresholds = new real*[_parameters->number_of_detectors_vertical];
+  _detector_thresholds = new real**[_parameters->number_of_cameras];
+  for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+    _detector_thresholds[s] = new real*[_parameters->number_of_detectors_vertical];
+    for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+      _detector_thresholds[s][r] = new real[_parameters->number_of_detectors_horizontal];
+      for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+        _detector_thresholds[s][r][c] = 0;
+      }
+    }
+  }
   const real pixel_rows_per_detector = static_cast<real>(_number_of_rows_image)/_parameters->number_of_detectors_vertical;
   const real pixel_cols_per_detector = static_cast<real>(_number_of_cols_image)/_parameters->number_of_detectors_horizontal;
   for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
     _detectors[r]           = new cv::Ptr<cv::FastFeatureDetector>[_parameters->number_of_detectors_horizontal];
     _detector_regions[r]    = new cv::Rect[_parameters->number_of_detectors_horizontal];
-    _detector_thresholds[r] = new real[_parameters->number_of_detectors_horizontal];
     for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
 #if CV_MAJOR_VERSION == 2
       _detectors[r][c] = new cv::FastFeatureDetector(_parameters->detector_threshold_minimum);
@@ -124,12 +134,22 @@ void  BaseFramePointGenerator::configure(){
                                          std::round(r*pixel_rows_per_detector)+offset_r,
                                          pixel_cols_per_detector+offset_width,
                                          pixel_rows_per_detector+offset_height);
-      _detector_thresholds[r][c] = 0;
     }
   }
   _number_of_detectors = _parameters->number_of_detectors_vertical*_parameters->number_of_detectors_horizontal;
   _mean_detector_threshold = _parameters->detector_threshold_minimum;
 
+  //ds allocate keypoint buffers for each detector region and image stream (reused for every detection)
+  _keypoints_per_detector = new std::vector<cv::KeyPoint>*[_parameters->number_of_cameras];
+  for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+    _keypoints_per_detector[s] = new std::vector<cv::KeyPoint>[_number_of_detectors];
+  }
+
+  //ds initialize bookkeeping for each image stream
+  _number_of_detections.assign(_parameters->number_of_cameras, 0);
+  _time_consumption_seconds_keypoint_detection.assign(_parameters->number_of_cameras, 0);
+  _time_consumption_seconds_descriptor_extraction.assign(_parameters->number_of_cameras, 0);
+
   //ds compute binning configuration
   _number_of_cols_bin = std::floor(static_cast<real>(_camera_left->numberOfImageCols())/_parameters->bin_size_pixels)+1;
   _number_of_rows_bin = std::floor(static_cast<real>(_camera_left->numberOfImageRows())/_parameters->bin_size_pixels)+1;
@@ -142,6 +162,12 @@ void  BaseFramePointGenerator::configure(){
   _target_number_of_keypoints_per_detector = static_cast<real>(_target_number_of_keypoints)/_number_of_detectors;
   LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|current target number of points per image region: " << _target_number_of_keypoints_per_detector << std::endl)
 
+  //ds size the memory arenas of framepoints and features (a quarter of the target per block bounds the slack of frames with few points)
+  const Count arena_block_capacity = std::max(_target_number_of_keypoints/4, static_cast<Count>(64));
+  ObjectArena<FramePoint>::setBlockCapacity(arena_block_capacity);
+  ObjectArena<IntensityFeature>::setBlockCapacity(arena_block_capacity);
+  LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|arena block capacity for framepoints and features: " << arena_block_capacity << std::endl)
+
   //ds allocate and initialize bin grid
   _bin_map_left = new FramePoint**[_number_of_rows_bin];
   for (Index row = 0; row < _number_of_rows_bin; ++row) {
@@ -166,13 +192,26 @@ BaseFramePointGenerator::~BaseFramePointGenerator() {
     for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
       delete[] _detectors[r];
       delete[] _detector_regions[r];
-      delete[] _detector_thresholds[r];
+    }
+    for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+      for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+        delete[] _detector_thresholds[s][r];
+      }
+      delete[] _detector_thresholds[s];
     }
     delete [] _detectors;
     delete [] _detector_regions;
     delete [] _detector_thresholds;
   }
 
+  //ds free keypoint buffers
+  if (_keypoints_per_detector) {
+    for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+      delete[] _keypoints_per_detector[s];
+    }
+    delete[] _keypoints_per_detector;
+  }
+
   //ds free bin map
   for (Count row = 0; row < _number_of_rows_bin; ++row) {
     delete[] _bin_map_left[row];
@@ -183,102 +222,281 @@ BaseFramePointGenerator::~BaseFramePointGenerator() {
 
 void BaseFramePointGenerator::detectKeypoints(const cv::Mat& intensity_image_,
                                               std::vector<cv::KeyPoint>& keypoints_,
-                                              const bool ignore_minimum_detector_threshold_) {
-  CHRONOMETER_START(keypoint_detection)
+                                              const bool ignore_minimum_detector_threshold_,
+                                              const Index& stream_index_,
+                                              double* time_consumption_seconds_) {
+  assert(stream_index_ < _parameters->number_of_cameras);
+  const double time_start_seconds = srrg_core::getTime();
+  PROFILER_SPAN(keypoint_detection)
+
+  //ds threshold bookkeeping and keypoint buffers of this image stream (only touched by the caller for this stream)
+  real** detector_thresholds                        = _detector_thresholds[stream_index_];
+  std::vector<cv::KeyPoint>* keypoints_per_detector = _keypoints_per_detector[stream_index_];
+
+  //ds detect new keypoints in each image region - either distributed over the shared thread pool or sequentially
+  const uint32_t& number_of_detectors_horizontal = _parameters->number_of_detectors_horizontal;
+  if (_thread_pool && _parameters->enable_parallel_keypoint_detection && _number_of_detectors > 1) {
+    _thread_pool->parallelFor(0, _number_of_detectors, [&](const Index& index_) {
+      _detectKeypointsInRegion(intensity_image_,
+                               index_/number_of_detectors_horizontal,
+                               index_%number_of_detectors_horizontal,
+                               detector_thresholds,
+                               keypoints_per_detector[index_]);
+    }, ThreadPool::Stage::FEATURE_EXTRACTION);
+  } else {
+    for (uint32_t index = 0; index < _number_of_detectors; ++index) {
+      _detectKeypointsInRegion(intensity_image_,
+                               index/number_of_detectors_horizontal,
+                               index%number_of_detectors_horizontal,
+                               detector_thresholds,
+                               keypoints_per_detector[index]);
+    }
+  }
 
-  //ds detect new keypoints in each image region
-  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
-    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+  //ds merge region keypoints in fixed region order (row-major, identical to sequential detection)
+  size_t number_of_keypoints = keypoints_.size();
+  for (uint32_t index = 0; index < _number_of_detectors; ++index) {
+    number_of_keypoints += keypoints_per_detector[index].size();
+  }
+  keypoints_.reserve(number_of_keypoints);
+  for (uint32_t index = 0; index < _number_of_detectors; ++index) {
+    keypoints_.insert(keypoints_.end(), keypoints_per_detector[index].begin(), keypoints_per_detector[index].end());
+  }
+  ++_number_of_detections[stream_index_];
+
+  //ds the number of detected keypoints refers to the primary (left) image stream (set on initialize for separately extracted features)
+  if (time_consumption_seconds_) {
+    *time_consumption_seconds_ += srrg_core::getTime()-time_start_seconds;
+  } else {
+    if (stream_index_ == 0) {
+      _number_of_detected_keypoints = keypoints_.size();
+    }
+    _time_consumption_seconds_keypoint_detection[stream_index_] += srrg_core::getTime()-time_start_seconds;
+  }
+}
+
+void BaseFramePointGenerator::_detectKeypointsInRegion(const cv::Mat& intensity_image_,
+                                                       const uint32_t& row_,
+                                                       const uint32_t& col_,
+                                                       real** detector_thresholds_,
+                                                       std::vector<cv::KeyPoint>& keypoints_) {
 
-      //ds detect keypoints in current region
-      std::vector<cv::KeyPoint> keypoints_per_detector(0);
-      _detectors[r][c]->detect(intensity_image_(_detector_regions[r][c]), keypoints_per_detector);
+  //ds detect keypoints in current region (reusing the preallocated buffer)
+  keypoints_.clear();
+  _detectors[row_][col_]->detect(intensity_image_(_detector_regions[row_][col_]), keypoints_);
 
-      //ds retrieve currently set threshold for this detector
+  //ds retrieve currently set threshold for this detector
 #if CV_MAJOR_VERSION == 2
-      real detector_threshold = _detectors[r][c]->getInt("threshold");
+  real detector_threshold = _detectors[row_][col_]->getInt("threshold");
 #else
-      real detector_threshold = _detectors[r][c]->getThreshold();
+  real detector_threshold = _detectors[row_][col_]->getThreshold();
 #endif
 
-      //ds compute point delta: 100% loss > -1, 100% gain > +1
-      const real delta = (static_cast<real>(keypoints_per_detector.size())-_target_number_of_keypoints_per_detector)/_target_number_of_keypoints_per_detector;
+  //ds compute point delta: 100% loss > -1, 100% gain > +1
+  const real delta = (static_cast<real>(keypoints_.size())-_target_number_of_keypoints_per_detector)/_target_number_of_keypoints_per_detector;
 
-      //ds check if there's a significant loss of target points (delta is negative)
-      if (delta < -_parameters->target_number_of_keypoints_tolerance) {
+  //ds check if there's a significant loss of target points (delta is negative)
+  if (delta < -_parameters->target_number_of_keypoints_tolerance) {
 
-        //ds compute new, lower threshold, capped (negative value)
-        const real change = std::max(delta, -_parameters->detector_threshold_maximum_change);
+    //ds compute new, lower threshold, capped (negative value)
+    const real change = std::max(delta, -_parameters->detector_threshold_maximum_change);
 
-        //ds always lower threshold by at least 1
-        detector_threshold = detector_threshold+std::min(change*detector_threshold, -1.0);
+    //ds always lower threshold by at least 1
+    detector_threshold = detector_threshold+std::min(change*detector_threshold, -1.0);
 
-        //ds check minimum threshold
-        if (detector_threshold < _parameters->detector_threshold_minimum) {
-          detector_threshold = _parameters->detector_threshold_minimum;
-        }
-      }
+    //ds check minimum threshold
+    if (detector_threshold < _parameters->detector_threshold_minimum) {
+      detector_threshold = _parameters->detector_threshold_minimum;
+    }
+  }
 
-      //ds or if there's a significant gain of target points (delta is positive)
-      else if (delta > _parameters->target_number_of_keypoints_tolerance) {
+  //ds or if there's a significant gain of target points (delta is positive)
+  else if (delta > _parameters->target_number_of_keypoints_tolerance) {
 
-        //ds compute new, higher threshold, capped (positive value)
-        const real change = std::min(delta, _parameters->detector_threshold_maximum_change);
+    //ds compute new, higher threshold, capped (positive value)
+    const real change = std::min(delta, _parameters->detector_threshold_maximum_change);
 
-        //ds always increase threshold by at least 1
-        detector_threshold += std::max(change*detector_threshold, 1.0);
+    //ds always increase threshold by at least 1
+    detector_threshold += std::max(change*detector_threshold, 1.0);
 
-        //ds check maximum threshold
-        if (detector_threshold > _parameters->detector_threshold_maximum) {
-          detector_threshold = _parameters->detector_threshold_maximum;
-        }
-      }
+    //ds check maximum threshold
+    if (detector_threshold > _parameters->detector_threshold_maximum) {
+      detector_threshold = _parameters->detector_threshold_maximum;
+    }
+  }
 
-      //ds set treshold variable (will be effectively changed by calling adjustDetectorThresholds)
-      _detector_thresholds[r][c] += detector_threshold;
+  //ds set treshold variable (will be effectively changed by calling adjustDetectorThresholds)
+  detector_thresholds_[row_][col_] += detector_threshold;
 
-      //ds shift keypoint coordinates to whole image region
-      const cv::Point2f& offset = _detector_regions[r][c].tl();
-      std::for_each(keypoints_per_detector.begin(), keypoints_per_detector.end(), [&offset](cv::KeyPoint& keypoint_) {keypoint_.pt += offset;});
+  //ds shift keypoint coordinates to whole image region
+  const cv::Point2f& offset = _detector_regions[row_][col_].tl();
+  std::for_each(keypoints_.begin(), keypoints_.end(), [&offset](cv::KeyPoint& keypoint_) {keypoint_.pt += offset;});
+}
 
-      //ds add to complete vector
-      keypoints_.insert(keypoints_.end(), keypoints_per_detector.begin(), keypoints_per_detector.end());
-    }
+void BaseFramePointGenerator::computeDescriptors(const cv::Mat& intensity_image_,
+                                                 std::vector<cv::KeyPoint>& keypoints_,
+                                                 cv::Mat& descriptors_,
+                                                 const Index& stream_index_,
+                                                 double* time_consumption_seconds_) {
+  assert(stream_index_ < _parameters->number_of_cameras);
+  const double time_start_seconds = srrg_core::getTime();
+  PROFILER_SPAN(descriptor_extraction)
+  _descriptor_extractor->compute(intensity_image_, keypoints_, descriptors_);
+  if (time_consumption_seconds_) {
+    *time_consumption_seconds_ += srrg_core::getTime()-time_start_seconds;
+  } else {
+    _time_consumption_seconds_descriptor_extraction[stream_index_] += srrg_core::getTime()-time_start_seconds;
   }
-  ++_number_of_detections;
-  _number_of_detected_keypoints = keypoints_.size();
-  CHRONOMETER_STOP(keypoint_detection)
 }
 
-void BaseFramePointGenerator::computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) {
-  CHRONOMETER_START(descriptor_extraction)
-  _descriptor_extractor->compute(intensity_image_, keypoints_, descriptors_);
-  CHRONOMETER_STOP(descriptor_extraction)
+void BaseFramePointGenerator::addExtractionStatistics(const ExtractedFeatures& features_) {
+  for (Index stream_index = 0; stream_index < features_.time_consumption_seconds_keypoint_detection.size(); ++stream_index) {
+    _time_consumption_seconds_keypoint_detection[stream_index] += features_.time_consumption_seconds_keypoint_detection[stream_index];
+  }
+  for (Index stream_index = 0; stream_index < features_.time_consumption_seconds_descriptor_extraction.size(); ++stream_index) {
+    _time_consumption_seconds_descriptor_extraction[stream_index] += features_.time_consumption_seconds_descriptor_extraction[stream_index];
+  }
 }
 
 void BaseFramePointGenerator::adjustDetectorThresholds() {
+
+  //ds total number of detections over all image streams
+  Count number_of_detections = 0;
+  for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+    number_of_detections += _number_of_detections[s];
+  }
+  if (number_of_detections == 0) {
+    return;
+  }
+
   _mean_detector_threshold = 0;
   for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
     for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
 
+      //ds accumulate thresholds over all streams in fixed stream order (identical to sequential accumulation)
+      real detector_threshold = 0;
+      for (uint32_t s = 0; s < _parameters->number_of_cameras; ++s) {
+        detector_threshold += _detector_thresholds[s][r][c];
+
+        //ds reset bookkeeping for next detection(s)
+        _detector_thresholds[s][r][c] = 0;
+      }
+
       //ds compute average threshold over last detections
-      _detector_thresholds[r][c] /= _number_of_detections;
-      _mean_detector_threshold += _detector_thresholds[r][c];
+      detector_threshold /= number_of_detections;
+      _mean_detector_threshold += detector_threshold;
 
 #if CV_MAJOR_VERSION == 2
-      _detectors[r][c]->setInt("threshold", std::rint(_detector_thresholds[r][c]));
+      _detectors[r][c]->setInt("threshold", std::rint(detector_threshold));
 #else
-      _detectors[r][c]->setThreshold(std::rint(_detector_thresholds[r][c]));
+      _detectors[r][c]->setThreshold(std::rint(detector_threshold));
 #endif
-
-      //ds reset bookkeeping for next detection(s)
-      _detector_thresholds[r][c] = 0;
     }
   }
-  _number_of_detections = 0;
+  _number_of_detections.assign(_parameters->number_of_cameras, 0);
   _mean_detector_threshold /= _number_of_detectors;
 }
 
+IntensityFeature* BaseFramePointGenerator::_getMatchingFeatureLeft(const Vector3& point_in_camera_left_prediction_,
+                                                                   const int32_t& row_projection_left_,
+                                                                   const int32_t& col_projection_left_,
+                                                                   const BinaryDescriptor& descriptor_previous_,
+                                                                   const real& maximum_descriptor_distance_tracking_,
+                                                                   const bool& track_by_appearance_,
+                                                                   real& descriptor_distance_best_) {
+  ++_number_of_tracking_searches;
+  int32_t row_half_extent = _projection_tracking_distance_pixels;
+  int32_t col_half_extent = _projection_tracking_distance_pixels;
+
+  //ds without motion prediction uncertainty we search the square tracking window
+  if (track_by_appearance_ || !_has_motion_prediction_covariance || _parameters->search_region_shape == BaseFramePointGeneratorParameters::SQUARE) {
+    return _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left_,
+                                                                       col_projection_left_,
+                                                                       descriptor_previous_,
+                                                                       std::max(row_projection_left_-row_half_extent, 0),
+                                                                       std::min(row_projection_left_+row_half_extent+1, _number_of_rows_image),
+                                                                       std::max(col_projection_left_-col_half_extent, 0),
+                                                                       std::min(col_projection_left_+col_half_extent+1, _number_of_cols_image),
+                                                                       maximum_descriptor_distance_tracking_,
+                                                                       track_by_appearance_,
+                                                                       descriptor_distance_best_);
+  }
+
+  //ds image jacobian of the point projection with respect to the motion perturbation: [m, 2*(p x m)] per image coordinate
+  const Matrix3& camera_calibration_matrix = _camera_left->cameraMatrix();
+  const Vector3 point_in_image_left(camera_calibration_matrix*point_in_camera_left_prediction_);
+  const real inverse_depth = 1/point_in_image_left.z();
+  Matrix2_6 jacobian;
+  for (uint32_t r = 0; r < 2; ++r) {
+    const Vector3 m((camera_calibration_matrix.row(r)-point_in_image_left(r)*inverse_depth*camera_calibration_matrix.row(2))*inverse_depth);
+    jacobian.block<1,3>(r,0) = m.transpose();
+    jacobian.block<1,3>(r,3) = 2*point_in_camera_left_prediction_.cross(m).transpose();
+  }
+
+  //ds projected uncertainty (uu, uv, vv) including the keypoint localization noise
+  const real variance_minimum = _parameters->search_region_minimum_standard_deviation_pixels*_parameters->search_region_minimum_standard_deviation_pixels;
+  Eigen::Matrix<real, 2, 2> covariance_uv(jacobian*_motion_prediction_covariance*jacobian.transpose());
+  covariance_uv(0,0) += variance_minimum;
+  covariance_uv(1,1) += variance_minimum;
+
+  //ds scale to the requested confidence - and inflate along with the tracking window if the tracker widened it
+  const real inflation = std::max(static_cast<real>(_projection_tracking_distance_pixels)/_parameters->minimum_projection_tracking_distance_pixels, 1.0);
+  const real k_squared = _parameters->search_region_number_of_standard_deviations*_parameters->search_region_number_of_standard_deviations*inflation*inflation;
+  covariance_uv *= k_squared;
+
+  //ds bounding box of the uncertainty ellipse, capped by the tracking window
+  col_half_extent = std::min(static_cast<int32_t>(std::ceil(std::sqrt(covariance_uv(0,0)))), _projection_tracking_distance_pixels);
+  row_half_extent = std::min(static_cast<int32_t>(std::ceil(std::sqrt(covariance_uv(1,1)))), _projection_tracking_distance_pixels);
+  const int32_t row_start_point = std::max(row_projection_left_-row_half_extent, 0);
+  const int32_t row_end_point   = std::min(row_projection_left_+row_half_extent+1, _number_of_rows_image);
+  const int32_t col_start_point = std::max(col_projection_left_-col_half_extent, 0);
+  const int32_t col_end_point   = std::min(col_projection_left_+col_half_extent+1, _number_of_cols_image);
+  if (_parameters->search_region_shape == BaseFramePointGeneratorParameters::RECTANGLE) {
+    return _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left_,
+                                                                       col_projection_left_,
+                                                                       descriptor_previous_,
+                                                                       row_start_point,
+                                                                       row_end_point,
+                                                                       col_start_point,
+                                                                       col_end_point,
+                                                                       maximum_descriptor_distance_tracking_,
+                                                                       track_by_appearance_,
+                                                                       descriptor_distance_best_);
+  }
+
+  //ds search the ellipse inside its bounding box: information matrix with (u,v)^T*Omega*(u,v) <= 1
+  const real determinant = covariance_uv(0,0)*covariance_uv(1,1)-covariance_uv(0,1)*covariance_uv(0,1);
+  return _feature_matcher_left.getMatchingFeatureInEllipticalRegion(row_projection_left_,
+                                                                    col_projection_left_,
+                                                                    descriptor_previous_,
+                                                                    covariance_uv(1,1)/determinant,
+                                                                    -covariance_uv(0,1)/determinant,
+                                                                    covariance_uv(0,0)/determinant,
+                                                                    row_start_point,
+                                                                    row_end_point,
+                                                                    col_start_point,
+                                                                    col_end_point,
+                                                                    maximum_descriptor_distance_tracking_,
+                                                                    track_by_appearance_,
+                                                                    descriptor_distance_best_);
+}
+
+const double BaseFramePointGenerator::getTimeConsumptionSeconds_keypoint_detection() const {
+  double time_consumption_seconds = 0;
+  for (const double& time_consumption_seconds_stream: _time_consumption_seconds_keypoint_detection) {
+    time_consumption_seconds += time_consumption_seconds_stream;
+  }
+  return time_consumption_seconds;
+}
+
+const double BaseFramePointGenerator::getTimeConsumptionSeconds_descriptor_extraction() const {
+  double time_consumption_seconds = 0;
+  for (const double& time_consumption_seconds_stream: _time_consumption_seconds_descriptor_extraction) {
+    time_consumption_seconds += time_consumption_seconds_stream;
+  }
+  return time_consumption_seconds;
+}
+
 const PointCoordinates BaseFramePointGenerator::getPointInCamera(const cv::Point2f& image_point_previous_,
                                                                  const cv::Point2f& image_point_current_,
                                                                  const TransformMatrix3D& camera_previous_to_current_,
@@ -1,5 +1,7 @@
 #pragma once
+#include <functional>
 #include "types/frame.h"
+#include "types/thread_pool.h"
 #include "intensity_feature_matcher.h"
 
 
@@ -12,22 +14,71 @@ class BaseFramePointGenerator {
 //ds object handling
 PROSLAM_MAKE_PROCESSING_CLASS(BaseFramePointGenerator)
 
+//ds exported types
+public:
+
+  //! @brief keypoints and descriptors of an image pair, extracted before the corresponding frame is created (pipelined processing)
+  struct ExtractedFeatures {
+    std::vector<cv::KeyPoint> keypoints_left;
+    std::vector<cv::KeyPoint> keypoints_right;
+    cv::Mat descriptors_left;
+    cv::Mat descriptors_right;
+
+    //! @brief time consumption of the extraction (per image stream) - recorded here instead of in the generator statistics, since
+    //! @brief a pipelined extraction runs concurrently with the readers of the statistics (accumulated with addExtractionStatistics)
+    std::vector<double> time_consumption_seconds_keypoint_detection;
+    std::vector<double> time_consumption_seconds_descriptor_extraction;
+    double time_consumption_seconds_feature_extraction = 0;
+  };
+
 //ds functionality
 public:
 
   //ds initializes the framepoint generator (e.g. detects keypoints and computes descriptors)
   virtual void initialize(Frame* frame_, const bool& extract_features_ = true) = 0;
 
+  //! @brief initializes the framepoint generator with features extracted beforehand by extractFeatures
+  //! @param[in,out] frame_ frame to initialize
+  //! @param[in,out] features_ extracted features of the frame images, moved into the frame
+  virtual void initialize(Frame* frame_, ExtractedFeatures& features_) = 0;
+
+  //! @brief extracts keypoints and descriptors for an image pair without a frame (pipelined processing)
+  //! @brief may run concurrently with compute, track and recoverPoints of the current frame - but not with another extraction or initialize
+  //! @param[in] image_left_ left intensity image
+  //! @param[in] image_right_ right intensity image (stereo) or depth image (ignored)
+  //! @param[out] features_ extracted features
+  //! @param[in] ignore_minimum_detector_threshold_ see detectKeypoints
+  virtual void extractFeatures(const cv::Mat& image_left_,
+                               const cv::Mat& image_right_,
+                               ExtractedFeatures& features_,
+                               const bool& ignore_minimum_detector_threshold_) = 0;
+
+  //! @brief adds the time consumption recorded by extractFeatures to the generator statistics
+  //! @brief to be called by the thread reading the statistics, once the extraction is completed
+  //! @param[in] features_ completed extraction
+  virtual void addExtractionStatistics(const ExtractedFeatures& features_);
+
   //ds computes framepoints stored in a image-like matrix (_framepoints_in_image)
   virtual void compute(Frame* frame_) = 0;
 
   //ds detects keypoints and stores them in a vector (called within initialize)
+  //ds different image streams can be processed concurrently, as long as each of them uses its own stream index
+  //! @param[in] stream_index_ image stream index in [0, number_of_cameras) - selects the threshold and timing bookkeeping
+  //! @param[in,out] time_consumption_seconds_ if set, the time consumption is added here instead of to the generator statistics
   void detectKeypoints(const cv::Mat& intensity_image_,
                        std::vector<cv::KeyPoint>& keypoints_,
-                       const bool ignore_minimum_detector_threshold_ = false);
+                       const bool ignore_minimum_detector_threshold_ = false,
+                       const Index& stream_index_ = 0,
+                       double* time_consumption_seconds_ = nullptr);
 
   //ds extracts the defined descriptors for the given keypoints (called within compute)
-  void computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_);
+  //! @param[in] stream_index_ image stream index in [0, number_of_cameras) - selects the timing bookkeeping
+  //! @param[in,out] time_consumption_seconds_ if set, the time consumption is added here instead of to the generator statistics
+  void computeDescriptors(const cv::Mat& intensity_image_,
+                          std::vector<cv::KeyPoint>& keypoints_,
+                          cv::Mat& descriptors_,
+                          const Index& stream_index_ = 0,
+                          double* time_consumption_seconds_ = nullptr);
 
   //! @brief computes tracks between current and previous image points based on appearance
   //! @param[out] previous_points_without_tracks_ lost points
@@ -50,6 +101,39 @@ public:
                                           const TransformMatrix3D& camera_previous_to_current_,
                                           const Matrix3& camera_calibration_matrix_) const;
 
+//ds helpers
+protected:
+
+  //! @brief detects keypoints in a single detector region and adapts its threshold (thread-safe for distinct regions)
+  //! @param[in] intensity_image_ complete image
+  //! @param[in] row_ detector row in grid
+  //! @param[in] col_ detector column in grid
+  //! @param[in,out] detector_thresholds_ threshold accumulation grid of the current image stream
+  //! @param[out] keypoints_ detected keypoints in whole image coordinates
+  void _detectKeypointsInRegion(const cv::Mat& intensity_image_,
+                                const uint32_t& row_,
+                                const uint32_t& col_,
+                                real** detector_thresholds_,
+                                std::vector<cv::KeyPoint>& keypoints_);
+
+  //! @brief finds the best matching feature in the current left image for a previous point (tracking search)
+  //! @brief the search region is the square tracking window, or shaped by the motion prediction covariance if available (see search_region_shape)
+  //! @param[in] point_in_camera_left_prediction_ previous point transformed into the current left camera frame with the motion prediction
+  //! @param[in] row_projection_left_ predicted image row
+  //! @param[in] col_projection_left_ predicted image column
+  //! @param[in] descriptor_previous_ descriptor of the previous point
+  //! @param[in] maximum_descriptor_distance_tracking_ maximum descriptor distance for a match
+  //! @param[in] track_by_appearance_ see IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion
+  //! @param[out] descriptor_distance_best_ descriptor distance of the returned feature
+  //! @return best matching feature (nullptr if none found)
+  IntensityFeature* _getMatchingFeatureLeft(const Vector3& point_in_camera_left_prediction_,
+                                            const int32_t& row_projection_left_,
+                                            const int32_t& col_projection_left_,
+                                            const BinaryDescriptor& descriptor_previous_,
+                                            const real& maximum_descriptor_distance_tracking_,
+                                            const bool& track_by_appearance_,
+                                            real& descriptor_distance_best_);
+
 //ds getters/setters
 public:
 
@@ -58,22 +142,41 @@ public:
 
   //ds other properties
   void setCameraLeft(const Camera* camera_left_) {_camera_left = camera_left_;}
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
   const int32_t& numberOfRowsImage() const {return _number_of_rows_image;}
   const int32_t& numberOfColsImage() const {return _number_of_cols_image;}
   const Count& targetNumberOfKeypoints() const {return _target_number_of_keypoints;}
   void setProjectionTrackingDistancePixels(const int32_t& projection_tracking_distance_pixels_) {_projection_tracking_distance_pixels = projection_tracking_distance_pixels_;}
   void setMaximumDescriptorDistanceTracking(const real& maximum_descriptor_distance_tracking_) {_maximum_descriptor_distance_tracking = maximum_descriptor_distance_tracking_;}
 
+  //! @brief sets the covariance of the motion prediction error dx (with the true motion v2t(dx)*camera_left_previous_in_current) for the next track call
+  void setMotionPredictionCovariance(const Matrix6& motion_prediction_covariance_) {_motion_prediction_covariance = motion_prediction_covariance_; _has_motion_prediction_covariance = true;}
+  void resetMotionPredictionCovariance() {_has_motion_prediction_covariance = false;}
+
   const int32_t matchingDistanceTrackingThreshold() const {return _parameters->minimum_descriptor_distance_tracking;}
   const Count& numberOfDetectedKeypoints() const {return _number_of_detected_keypoints;}
   const Count& numberOfTrackedLandmarks() const {return _number_of_tracked_landmarks;}
   const real meanDetectorThreshold() const {return _mean_detector_threshold;}
 
+  //ds tracking search cost (accumulated over all track calls)
+  const uint64_t numberOfTrackingSearches() const {return _number_of_tracking_searches;}
+  const uint64_t numberOfSearchedCellsTracking() const {return _feature_matcher_left.number_of_searched_cells;}
+  const uint64_t numberOfComparedFeaturesTracking() const {return _feature_matcher_left.number_of_compared_features;}
+
+  //ds timing information per image stream (the overall timings are the sum over all streams)
+  const double getTimeConsumptionSeconds_keypoint_detection(const Index& stream_index_) const {return _time_consumption_seconds_keypoint_detection[stream_index_];}
+  const double getTimeConsumptionSeconds_descriptor_extraction(const Index& stream_index_) const {return _time_consumption_seconds_descriptor_extraction[stream_index_];}
+  const double getTimeConsumptionSeconds_keypoint_detection() const;
+  const double getTimeConsumptionSeconds_descriptor_extraction() const;
+
 //ds settings
 protected:
 
   const Camera* _camera_left = nullptr;
 
+  //! @brief shared thread pool (sequential processing if not set)
+  ThreadPool* _thread_pool = nullptr;
+
   //ds image dimensions
   int32_t _number_of_rows_image = 0;
   int32_t _number_of_cols_image = 0;
@@ -90,9 +193,12 @@ protected:
 
   //! @brief grid of detectors (equally distributed over the image with size=number_of_detectors_per_dimension*number_of_detectors_per_dimension)
   cv::Ptr<cv::FastFeatureDetector>** _detectors = nullptr;
-  real** _detector_thresholds                   = nullptr;
   real _mean_detector_threshold                 = 0;
 
+  //! @brief accumulated detector thresholds since last adjustDetectorThresholds() call
+  //! @brief one grid per image stream, such that streams can be detected concurrently
+  real*** _detector_thresholds = nullptr;
+
   //! @brief number of detectors
   //! @brief the same for all image streams
   uint32_t _number_of_detectors = 0;
@@ -101,8 +207,11 @@ protected:
   //! @brief the same for all image streams
   cv::Rect** _detector_regions = nullptr;
 
-  //! @brief number of detections since last adjustDetectorThresholds() call
-  Count _number_of_detections = 0;
+  //! @brief keypoint buffer for each detector (row-major), per image stream - preallocated and reused for every detection
+  std::vector<cv::KeyPoint>** _keypoints_per_detector = nullptr;
+
+  //! @brief number of detections since last adjustDetectorThresholds() call (per image stream)
+  std::vector<Count> _number_of_detections;
 
   //ds descriptor extraction
   cv::Ptr<cv::DescriptorExtractor> _descriptor_extractor;
@@ -112,7 +221,7 @@ protected:
   Count _number_of_cols_bin      = 0;
   FramePointMatrix _bin_map_left = nullptr;
 
-  //! @brief feature matching class (maintains features in a 2D lattice corresponding to the image and a vector)
+  //! @brief feature matching class (maintains features in a sparse per-row index corresponding to the image and a vector)
   IntensityFeatureMatcher _feature_matcher_left;
   std::vector<IntensityFeature> _keypoints_with_descriptors_left;
 
@@ -122,14 +231,21 @@ protected:
   //! @brief current maximum descriptor distance for tracking
   real _maximum_descriptor_distance_tracking   = 0;
 
+  //! @brief covariance of the motion prediction error in the current track call (if available)
+  Matrix6 _motion_prediction_covariance  = Matrix6::Zero();
+  bool _has_motion_prediction_covariance = false;
+
+  //! @brief number of tracking searches in the left image (informative only)
+  uint64_t _number_of_tracking_searches = 0;
+
   //! @brief status
   Count _number_of_tracked_landmarks = 0;
 
 private:
 
-  //ds informative only
-  CREATE_CHRONOMETER(keypoint_detection)
-  CREATE_CHRONOMETER(descriptor_extraction)
+  //ds informative only (per image stream)
+  std::vector<double> _time_consumption_seconds_keypoint_detection;
+  std::vector<double> _time_consumption_seconds_descriptor_extraction;
 };
 
 typedef std::shared_ptr<BaseFramePointGenerator> BaseFramePointGeneratorPtr;
@@ -42,6 +42,34 @@ void DepthFramePointGenerator::initialize(Frame* frame_, const bool& extract_fea
   _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
 }
 
+void DepthFramePointGenerator::initialize(Frame* frame_, ExtractedFeatures& features_) {
+  CHRONOMETER_START(depth_map_generation)
+  _computeDepthMap(frame_->intensityImageRight());
+  CHRONOMETER_STOP(depth_map_generation)
+
+  //ds move the features into the frame
+  frame_->keypointsLeft().swap(features_.keypoints_left);
+  frame_->descriptorsLeft() = features_.descriptors_left;
+  features_.descriptors_left.release();
+  _number_of_detected_keypoints = frame_->keypointsLeft().size();
+
+  //ds initialize matchers for left frame
+  _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
+}
+
+void DepthFramePointGenerator::extractFeatures(const cv::Mat& image_left_,
+                                               const cv::Mat& image_right_,
+                                               ExtractedFeatures& features_,
+                                               const bool& ignore_minimum_detector_threshold_) {
+
+  //ds the depth image is processed in initialize (the depth map is required for the current frame only)
+  features_.time_consumption_seconds_keypoint_detection.assign(1, 0);
+  features_.time_consumption_seconds_descriptor_extraction.assign(1, 0);
+  detectKeypoints(image_left_, features_.keypoints_left, ignore_minimum_detector_threshold_, 0, &features_.time_consumption_seconds_keypoint_detection[0]);
+  adjustDetectorThresholds();
+  computeDescriptors(image_left_, features_.keypoints_left, features_.descriptors_left, 0, &features_.time_consumption_seconds_descriptor_extraction[0]);
+}
+
 //ds computes framepoints stored in a image-like matrix (_framepoints_in_image) for provided stereo images
 void DepthFramePointGenerator::compute(Frame* frame_) {
   assert(frame_->intensityImageRight().type() == CV_16UC1);
@@ -81,8 +109,8 @@ void DepthFramePointGenerator::compute(Frame* frame_) {
       continue;
     }
 
-    //ds remove feature from lattice as we will generate a framepoint with it that takes ownership
-    _feature_matcher_left.feature_lattice[feature_left->row][feature_left->col] = nullptr;
+    //ds remove feature from index as we will generate a framepoint with it that takes ownership
+    _feature_matcher_left.removeFeature(feature_left);
     matched_indices_left.insert(feature_left->index_in_vector);
 
     //ds if depth could not be retrieved and point triangulation is enabled
@@ -214,23 +242,14 @@ void DepthFramePointGenerator::track(Frame* frame_,
     //ds TRACKING obtain matching feature in left image (if any)
     real descriptor_distance_best = _parameters->minimum_descriptor_distance_tracking;
 
-    //ds define search region (rectangular ROI)
-    int32_t row_start_point = std::max(row_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t row_end_point   = std::min(row_projection_left+_projection_tracking_distance_pixels+1, _number_of_rows_image);
-    int32_t col_start_point = std::max(col_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t col_end_point   = std::min(col_projection_left+_projection_tracking_distance_pixels+1, _number_of_cols_image);
-
-    //ds find the best match for the previous left feature (i.e. track it)
-    IntensityFeature* feature_left = _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left,
-                                                                                                 col_projection_left,
-                                                                                                 point_previous->descriptorLeft(),
-                                                                                                 row_start_point,
-                                                                                                 row_end_point,
-                                                                                                 col_start_point,
-                                                                                                 col_end_point,
-                                                                                                 _parameters->minimum_descriptor_distance_tracking,
-                                                                                                 track_by_appearance_,
-                                                                                                 descriptor_distance_best);
+    //ds find the best match for the previous left feature (i.e. track it) in its search region
+    IntensityFeature* feature_left = _getMatchingFeatureLeft(point_in_camera_left_prediction,
+                                                             row_projection_left,
+                                                             col_projection_left,
+                                                             point_previous->descriptorLeft(),
+                                                             _parameters->minimum_descriptor_distance_tracking,
+                                                             track_by_appearance_,
+                                                             descriptor_distance_best);
 
     //ds if we found a match
     if (feature_left) {
@@ -243,9 +262,9 @@ void DepthFramePointGenerator::track(Frame* frame_,
         continue;
       }
 
-      //ds remove feature from lattice as we will generate a framepoint with it that takes ownership
+      //ds remove feature from index as we will generate a framepoint with it that takes ownership
       matched_indices_left.insert(feature_left->index_in_vector);
-      _feature_matcher_left.feature_lattice[feature_left->row][feature_left->col] = nullptr;
+      _feature_matcher_left.removeFeature(feature_left);
 
       //ds if depth could not be retrieved but point triangulation is enabled
       if (depth_point[2] >= _parameters->maximum_depth_meters && _parameters->enable_point_triangulation) {
@@ -377,26 +396,27 @@ void DepthFramePointGenerator::recoverPoints(Frame* current_frame_, const FrameP
     //ds extract descriptors at this position: LEFT
     keypoint_buffer_left[0]    = point_previous->keypointLeft();
     keypoint_buffer_left[0].pt = offset_keypoint_half;
-    cv::Mat descriptor_left;
+    cv::Mat descriptor_matrix_left;
     const cv::Mat roi_left(intensity_image_left(region_of_interest_left));
-    _descriptor_extractor->compute(roi_left, keypoint_buffer_left, descriptor_left);
+    _descriptor_extractor->compute(roi_left, keypoint_buffer_left, descriptor_matrix_left);
 
     //ds if no descriptor could be computed
-    if (descriptor_left.rows == 0) {
+    if (descriptor_matrix_left.rows == 0) {
       continue;
     }
+    const BinaryDescriptor descriptor_left(descriptor_matrix_left);
 
     //ds if descriptor distance is to high
-    if (cv::norm(point_previous->descriptorLeft(), descriptor_left, SRRG_PROSLAM_DESCRIPTOR_NORM) > _parameters->minimum_descriptor_distance_tracking) {
+    if (DescriptorDistance::compute(point_previous->descriptorLeft(), descriptor_left) > _parameters->minimum_descriptor_distance_tracking) {
       continue;
     }
     keypoint_buffer_left[0].pt += corner_left;
 
-    //ds instantiate a new feature (will be owned by the framepoint)
-    IntensityFeature* feature = new IntensityFeature(keypoint_buffer_left[0], descriptor_left, 0);
+    //ds instantiate a temporary feature (the framepoint copies its content)
+    const IntensityFeature feature(keypoint_buffer_left[0], descriptor_left, 0);
 
     //ds at this point we have a valid depth measurement - obtain coordinates in the depth image
-    FramePoint* framepoint = current_frame_->createFramepoint(feature, PointCoordinates(depth_point[0], depth_point[1], depth_point[2]), point_previous);
+    FramePoint* framepoint = current_frame_->createFramepoint(&feature, PointCoordinates(depth_point[0], depth_point[1], depth_point[2]), point_previous);
 
     //ds set the point to the control structure
     current_frame_->points()[index_lost_point_recovered] = framepoint;
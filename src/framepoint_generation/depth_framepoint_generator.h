@@ -15,6 +15,15 @@ public:
   //ds initializes the framepoint generator (e.g. detects keypoints and computes descriptors)
   virtual void initialize(Frame* frame_, const bool& extract_features_ = true) override;
 
+  //! @brief initializes the framepoint generator with features extracted beforehand (pipelined processing)
+  virtual void initialize(Frame* frame_, ExtractedFeatures& features_) override;
+
+  //! @brief detects keypoints and computes descriptors in the intensity image without a frame (pipelined processing)
+  virtual void extractFeatures(const cv::Mat& image_left_,
+                               const cv::Mat& image_right_,
+                               ExtractedFeatures& features_,
+                               const bool& ignore_minimum_detector_threshold_) override;
+
   //ds computes framepoints stored in a image-like matrix (_framepoints_in_image) for provided stereo images
   virtual void compute(Frame* frame_) override;
 
@@ -12,14 +12,10 @@ IntensityFeatureMatcher::IntensityFeatureMatcher() {
 
 IntensityFeatureMatcher::~IntensityFeatureMatcher() {
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::~IntensityFeatureMatcher|destroying" << std::endl)
-  for (int32_t r = 0; r < number_of_rows; ++r) {
-    delete[] feature_lattice[r];
-  }
-  delete[] feature_lattice;
-  for (IntensityFeature* feature: feature_vector) {
-    delete feature;
-  }
+  feature_rows.clear();
+  occupied_rows.clear();
   feature_vector.clear();
+  feature_arena.clear();
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::~IntensityFeatureMatcher|destroyed" << std::endl)
 }
 
@@ -28,18 +24,13 @@ void IntensityFeatureMatcher::configure(const int32_t& rows_, const int32_t& col
   if (rows_ <= 0 || cols_ <= 0) {
     throw std::runtime_error("KeypointWithDescriptorLattice::configure|invalid image dimensions");
   }
-  if (feature_lattice) {
-    throw std::runtime_error("KeypointWithDescriptorLattice::configure|lattice already allocated");
+  if (!feature_rows.empty()) {
+    throw std::runtime_error("KeypointWithDescriptorLattice::configure|feature index already allocated");
   }
 
-  //ds initialize empty lattice
-  feature_lattice = new IntensityFeature**[rows_];
-  for (int32_t r = 0; r < rows_; ++r) {
-    feature_lattice[r] = new IntensityFeature*[cols_];
-    for (int32_t c = 0; c < cols_; ++c) {
-      feature_lattice[r][c] = nullptr;
-    }
-  }
+  //ds initialize empty feature index (one sorted feature vector per image row)
+  feature_rows.resize(rows_);
+  occupied_rows.reserve(rows_);
   number_of_rows = rows_;
   number_of_cols = cols_;
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::configure|configured" << std::endl)
@@ -50,22 +41,30 @@ void IntensityFeatureMatcher::setFeatures(const std::vector<cv::KeyPoint>& keypo
     throw std::runtime_error("KeypointWithDescriptorLattice::setFeatures|mismatching keypoints and descriptor numbers");
   }
 
-  //ds clear the lattice - freeing remaining features
-  for (int32_t r = 0; r < number_of_rows; ++r) {
-    for (int32_t c = 0; c < number_of_cols; ++c) {
-      feature_lattice[r][c] = nullptr;
-    }
-  }
-  for (IntensityFeature* feature: feature_vector) {
-    delete feature;
+  //ds clear the feature index (only occupied rows) - releasing all features of the previous image
+  for (const int32_t& row: occupied_rows) {
+    feature_rows[row].clear();
   }
+  occupied_rows.clear();
+  feature_arena.clear();
 
   //ds fill in features
   feature_vector.resize(keypoints_.size());
   for (uint32_t index = 0; index < keypoints_.size(); ++index) {
-    IntensityFeature* feature = new IntensityFeature(keypoints_[index], descriptors_.row(index), index);
+    IntensityFeature* feature = feature_arena.create(keypoints_[index], BinaryDescriptor(descriptors_.row(index)), index);
     feature_vector[index] = feature;
-    feature_lattice[feature->row][feature->col] = feature;
+    IntensityFeaturePointerVector& features_in_row = feature_rows[feature->row];
+    if (features_in_row.empty()) {
+      occupied_rows.push_back(feature->row);
+    }
+    features_in_row.push_back(feature);
+  }
+
+  //ds sort features in each row by ascending column (stable: features on the same pixel keep their vector order)
+  for (const int32_t& row: occupied_rows) {
+    std::stable_sort(feature_rows[row].begin(), feature_rows[row].end(), [](const IntensityFeature* a_, const IntensityFeature* b_){
+      return a_->col < b_->col;
+    });
   }
 }
 
@@ -80,7 +79,7 @@ void IntensityFeatureMatcher::sortFeatureVector() {
 
 IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
                                                                                  const int32_t& col_reference_,
-                                                                                 const cv::Mat& descriptor_reference_,
+                                                                                 const BinaryDescriptor& descriptor_reference_,
                                                                                  const int32_t& row_start_point,
                                                                                  const int32_t& row_end_point,
                                                                                  const int32_t& col_start_point,
@@ -89,61 +88,100 @@ IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion
                                                                                  const bool track_by_appearance_,
                                                                                  real& descriptor_distance_best_) {
   descriptor_distance_best_ = maximum_descriptor_distance_tracking_;
-  int32_t row_best = -1;
-  int32_t col_best = -1;
-
-  //ds locate best match in appearance
-  if (track_by_appearance_) {
-    for (int32_t row = row_start_point; row < row_end_point; ++row) {
-      for (int32_t col = col_start_point; col < col_end_point; ++col) {
-        if (feature_lattice[row][col]) {
-          const real descriptor_distance = cv::norm(descriptor_reference_,
-                                                    feature_lattice[row][col]->descriptor,
-                                                    SRRG_PROSLAM_DESCRIPTOR_NORM);
-
-          if (descriptor_distance < descriptor_distance_best_) {
-            descriptor_distance_best_ = descriptor_distance;
-            row_best = row;
-            col_best = col;
-          }
-        }
-      }
-    }
+  IntensityFeature* feature_best = nullptr;
+  uint32_t projection_distance_pixels_best = 10000;
 
-  //ds locate best match in projection error, within maximum appearance distance
-  } else {
-    uint32_t projection_distance_pixels_best = 10000;
-    for (int32_t row = row_start_point; row < row_end_point; ++row) {
-      for (int32_t col = col_start_point; col < col_end_point; ++col) {
-        if (feature_lattice[row][col]) {
-          const real descriptor_distance = cv::norm(descriptor_reference_,
-                                                    feature_lattice[row][col]->descriptor,
-                                                    SRRG_PROSLAM_DESCRIPTOR_NORM);
-          if (descriptor_distance < maximum_descriptor_distance_tracking_) {
-
-            //ds compute projection distance
-            const int32_t row_distance_pixels         = row_reference_-row;
-            const int32_t col_distance_pixels         = col_reference_-col;
-            const uint32_t projection_distance_pixels = row_distance_pixels*row_distance_pixels+col_distance_pixels*col_distance_pixels;
-
-            //ds if better than best so far
-            if (projection_distance_pixels < projection_distance_pixels_best) {
-              projection_distance_pixels_best = projection_distance_pixels;
-              descriptor_distance_best_       = descriptor_distance;
-              row_best = row;
-              col_best = col;
-            }
-          }
-        }
-      }
+  //ds locate best match in appearance or projection error (within maximum appearance distance)
+  for (int32_t row = row_start_point; row < row_end_point; ++row) {
+    _matchFeaturesInRow(row_reference_, col_reference_, descriptor_reference_, row, col_start_point, col_end_point,
+                        maximum_descriptor_distance_tracking_, track_by_appearance_, descriptor_distance_best_, projection_distance_pixels_best, feature_best);
+  }
+
+  //ds return best match (nullptr if none found)
+  return feature_best;
+}
+
+IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInEllipticalRegion(const int32_t& row_reference_,
+                                                                                const int32_t& col_reference_,
+                                                                                const BinaryDescriptor& descriptor_reference_,
+                                                                                const real& information_uu_,
+                                                                                const real& information_uv_,
+                                                                                const real& information_vv_,
+                                                                                const int32_t& row_start_point,
+                                                                                const int32_t& row_end_point,
+                                                                                const int32_t& col_start_point,
+                                                                                const int32_t& col_end_point,
+                                                                                const real& maximum_descriptor_distance_tracking_,
+                                                                                const bool track_by_appearance_,
+                                                                                real& descriptor_distance_best_) {
+  assert(information_uu_ > 0);
+  descriptor_distance_best_ = maximum_descriptor_distance_tracking_;
+  IntensityFeature* feature_best = nullptr;
+  uint32_t projection_distance_pixels_best = 10000;
+  const real determinant = information_uu_*information_vv_-information_uv_*information_uv_;
+
+  //ds only search the column interval covered by the ellipse in each row
+  for (int32_t row = row_start_point; row < row_end_point; ++row) {
+    const real row_offset   = row-row_reference_;
+    const real discriminant = information_uu_-row_offset*row_offset*determinant;
+    if (discriminant < 0) {
+      continue;
     }
+    const real col_center     = col_reference_-information_uv_*row_offset/information_uu_;
+    const real col_half_width = std::sqrt(discriminant)/information_uu_;
+    const int32_t col_start   = std::max(static_cast<int32_t>(std::floor(col_center-col_half_width)), col_start_point);
+    const int32_t col_end     = std::min(static_cast<int32_t>(std::ceil(col_center+col_half_width))+1, col_end_point);
+    _matchFeaturesInRow(row_reference_, col_reference_, descriptor_reference_, row, col_start, col_end,
+                        maximum_descriptor_distance_tracking_, track_by_appearance_, descriptor_distance_best_, projection_distance_pixels_best, feature_best);
   }
 
-  //ds if we found a match
-  if (row_best != -1) {
-    return feature_lattice[row_best][col_best];
-  } else {
-    return nullptr;
+  //ds return best match (nullptr if none found)
+  return feature_best;
+}
+
+void IntensityFeatureMatcher::_matchFeaturesInRow(const int32_t& row_reference_,
+                                                  const int32_t& col_reference_,
+                                                  const BinaryDescriptor& descriptor_reference_,
+                                                  const int32_t& row_,
+                                                  const int32_t& col_start_,
+                                                  const int32_t& col_end_,
+                                                  const real& maximum_descriptor_distance_tracking_,
+                                                  const bool track_by_appearance_,
+                                                  real& descriptor_distance_best_,
+                                                  uint32_t& projection_distance_pixels_best_,
+                                                  IntensityFeature*& feature_best_) {
+  if (col_start_ >= col_end_) {
+    return;
+  }
+  number_of_searched_cells += col_end_-col_start_;
+  const IntensityFeaturePointerVector& features_in_row = feature_rows[row_];
+  for (IntensityFeaturePointerVector::const_iterator iterator = _getFirstFeatureInRow(features_in_row, col_start_);
+       iterator != features_in_row.end() && (*iterator)->col < col_end_; ++iterator) {
+    const real descriptor_distance = DescriptorDistance::compute(descriptor_reference_, (*iterator)->descriptor);
+    ++number_of_compared_features;
+
+    //ds locate best match in appearance
+    if (track_by_appearance_) {
+      if (descriptor_distance < descriptor_distance_best_) {
+        descriptor_distance_best_ = descriptor_distance;
+        feature_best_ = *iterator;
+      }
+
+    //ds locate best match in projection error, within maximum appearance distance
+    } else if (descriptor_distance < maximum_descriptor_distance_tracking_) {
+
+      //ds compute projection distance
+      const int32_t row_distance_pixels         = row_reference_-row_;
+      const int32_t col_distance_pixels         = col_reference_-(*iterator)->col;
+      const uint32_t projection_distance_pixels = row_distance_pixels*row_distance_pixels+col_distance_pixels*col_distance_pixels;
+
+      //ds if better than best so far
+      if (projection_distance_pixels < projection_distance_pixels_best_) {
+        projection_distance_pixels_best_ = projection_distance_pixels;
+        descriptor_distance_best_        = descriptor_distance;
+        feature_best_ = *iterator;
+      }
+    }
   }
 }
 
@@ -164,10 +202,50 @@ void IntensityFeatureMatcher::prune(const std::set<uint32_t>& matched_indices_)
 
       //ds move on
       ++number_of_unmatched_elements;
-    } else {
-      delete feature_vector[index];
     }
   }
   feature_vector.resize(number_of_unmatched_elements);
 }
+
+void IntensityFeatureMatcher::prune(const std::vector<bool>& matched_flags_) {
+  assert(matched_flags_.size() == feature_vector.size());
+
+  //ds remove matched features from candidate pools
+  size_t number_of_unmatched_elements = 0;
+  for (size_t index = 0; index < feature_vector.size(); ++index) {
+    if (!matched_flags_[index]) {
+      feature_vector[number_of_unmatched_elements] = feature_vector[index];
+      feature_vector[number_of_unmatched_elements]->index_in_vector = number_of_unmatched_elements;
+      ++number_of_unmatched_elements;
+    }
+  }
+  feature_vector.resize(number_of_unmatched_elements);
+}
+
+void IntensityFeatureMatcher::removeFeature(const IntensityFeature* feature_) {
+  IntensityFeaturePointerVector& features_in_row = feature_rows[feature_->row];
+
+  //ds look for the feature among all features with the same column
+  for (IntensityFeaturePointerVector::iterator iterator = _getFirstFeatureInRow(features_in_row, feature_->col);
+       iterator != features_in_row.end() && (*iterator)->col == feature_->col; ++iterator) {
+    if (*iterator == feature_) {
+      features_in_row.erase(iterator);
+      return;
+    }
+  }
+}
+
+void IntensityFeatureMatcher::removeFeatures(const int32_t& row_,
+                                             const int32_t& col_start_,
+                                             const int32_t& col_end_,
+                                             std::set<uint32_t>& removed_indices_) {
+  IntensityFeaturePointerVector& features_in_row = feature_rows[row_];
+  IntensityFeaturePointerVector::iterator iterator_begin = _getFirstFeatureInRow(features_in_row, col_start_);
+  IntensityFeaturePointerVector::iterator iterator_end   = iterator_begin;
+  while (iterator_end != features_in_row.end() && (*iterator_end)->col < col_end_) {
+    removed_indices_.insert((*iterator_end)->index_in_vector);
+    ++iterator_end;
+  }
+  features_in_row.erase(iterator_begin, iterator_end);
+}
 } //namespace proslam
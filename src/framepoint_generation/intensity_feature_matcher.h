@@ -1,6 +1,7 @@
 #pragma once
 #include "intensity_feature_extractor.h"
 #include "types/frame_point.h"
+#include "types/descriptor_distance.h"
 
 
 
@@ -26,10 +27,10 @@ public:
   //ds this behavior is desired for high efficiency
   void sortFeatureVector();
 
-  //ds performs a local search in a rectangular area on the feature lattice
+  //ds performs a local search in a rectangular area on the feature index
   IntensityFeature* getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
                                                           const int32_t& col_reference_,
-                                                          const cv::Mat& descriptor_reference_,
+                                                          const BinaryDescriptor& descriptor_reference_,
                                                           const int32_t& row_start_point,
                                                           const int32_t& row_end_point,
                                                           const int32_t& col_start_point,
@@ -38,9 +39,64 @@ public:
                                                           const bool track_by_appearance_,
                                                           real& descriptor_distance_best_);
 
+  //! @brief performs a local search in an elliptical area on the feature index, bounded by a rectangular area
+  //! @param[in] information_uu_ information_uv_ information_vv_ ellipse around the reference: information_uu*du^2+2*information_uv*du*dv+information_vv*dv^2 <= 1
+  IntensityFeature* getMatchingFeatureInEllipticalRegion(const int32_t& row_reference_,
+                                                         const int32_t& col_reference_,
+                                                         const BinaryDescriptor& descriptor_reference_,
+                                                         const real& information_uu_,
+                                                         const real& information_uv_,
+                                                         const real& information_vv_,
+                                                         const int32_t& row_start_point,
+                                                         const int32_t& row_end_point,
+                                                         const int32_t& col_start_point,
+                                                         const int32_t& col_end_point,
+                                                         const real& maximum_descriptor_distance_tracking_,
+                                                         const bool track_by_appearance_,
+                                                         real& descriptor_distance_best_);
+
   //ds prunes features from feature vector if existing
   void prune(const std::set<uint32_t>& matched_indices_);
 
+  //ds prunes features from feature vector for which the matched flag is set (same size as the feature vector)
+  void prune(const std::vector<bool>& matched_flags_);
+
+  //ds removes a feature from the feature index (blocking it for further matching), the feature vector is not affected
+  void removeFeature(const IntensityFeature* feature_);
+
+  //ds removes all features in the column range [col_start_, col_end_) of a row from the feature index and collects their vector indices
+  void removeFeatures(const int32_t& row_, const int32_t& col_start_, const int32_t& col_end_, std::set<uint32_t>& removed_indices_);
+
+//ds helpers
+protected:
+
+  //! @brief evaluates all features of a row in the column range [col_start_, col_end_) as match candidates (region search building block)
+  //! @param[in,out] projection_distance_pixels_best_ squared pixel distance of the best candidate (projection based search only)
+  //! @param[in,out] feature_best_ best candidate so far
+  void _matchFeaturesInRow(const int32_t& row_reference_,
+                           const int32_t& col_reference_,
+                           const BinaryDescriptor& descriptor_reference_,
+                           const int32_t& row_,
+                           const int32_t& col_start_,
+                           const int32_t& col_end_,
+                           const real& maximum_descriptor_distance_tracking_,
+                           const bool track_by_appearance_,
+                           real& descriptor_distance_best_,
+                           uint32_t& projection_distance_pixels_best_,
+                           IntensityFeature*& feature_best_);
+
+  //ds retrieves the first feature in a sorted feature row with a column not smaller than col_ (binary search)
+  static inline IntensityFeaturePointerVector::iterator _getFirstFeatureInRow(IntensityFeaturePointerVector& features_in_row_, const int32_t& col_) {
+    return std::lower_bound(features_in_row_.begin(), features_in_row_.end(), col_, [](const IntensityFeature* feature_, const int32_t& column_) {
+      return feature_->col < column_;
+    });
+  }
+  static inline IntensityFeaturePointerVector::const_iterator _getFirstFeatureInRow(const IntensityFeaturePointerVector& features_in_row_, const int32_t& col_) {
+    return std::lower_bound(features_in_row_.begin(), features_in_row_.end(), col_, [](const IntensityFeature* feature_, const int32_t& column_) {
+      return feature_->col < column_;
+    });
+  }
+
 //ds attributes
 public:
 
@@ -51,8 +107,18 @@ public:
   //ds feature information stored in a linear array (which is sorted and exploited for e.g. rigid stereo matching)
   IntensityFeaturePointerVector feature_vector;
 
-  //ds image which contains features at pixel positions
-  IntensityFeature*** feature_lattice = nullptr;
+  //ds feature storage: all features of the current image are released in bulk when setting new features
+  ObjectArena<IntensityFeature> feature_arena;
+
+  //ds sparse feature index: features per image row sorted by ascending column (clearing and queries scale with the number of features)
+  std::vector<IntensityFeaturePointerVector> feature_rows;
+
+  //ds rows that currently contain features (to clear the index without visiting empty rows)
+  std::vector<int32_t> occupied_rows;
+
+  //! @brief search cost statistics of the region searches: accumulated searched pixels and compared candidate features
+  uint64_t number_of_searched_cells    = 0;
+  uint64_t number_of_compared_features = 0;
 
 };
 } //namespace proslam
@@ -39,6 +39,16 @@ void StereoFramePointGenerator::configure(){
     _epipolar_search_offsets_pixel.push_back(-u);
   }
 
+  //ds compute sweep lags: both the lag and the lag plus offset must not decrease with the matching priority
+  _epipolar_sweep_lags.resize(_epipolar_search_offsets_pixel.size());
+  _epipolar_sweep_lags[0] = 0;
+  for (Index k = 1; k < _epipolar_search_offsets_pixel.size(); ++k) {
+    _epipolar_sweep_lags[k] = _epipolar_sweep_lags[k-1]+std::max(_epipolar_search_offsets_pixel[k-1]-_epipolar_search_offsets_pixel[k], 0);
+  }
+  _stereo_matches_per_offset.resize(_epipolar_search_offsets_pixel.size());
+  _row_offsets_left.resize(_number_of_rows_image+1);
+  _row_offsets_right.resize(_number_of_rows_image+1);
+
   //ds info
   LOG_INFO(std::cerr << "StereoFramePointGenerator::configure|baseline (m): " << _baseline_meters << std::endl)
   LOG_INFO(std::cerr << "StereoFramePointGenerator::configure|number of epipolar lines considered for stereo matching: " << _epipolar_search_offsets_pixel.size() << std::endl)
@@ -49,6 +59,8 @@ void StereoFramePointGenerator::configure(){
 StereoFramePointGenerator::~StereoFramePointGenerator() {
   LOG_INFO(std::cerr << "StereoFramePointGenerator::~StereoFramePointGenerator|destroying" << std::endl)
   _epipolar_search_offsets_pixel.clear();
+  _epipolar_sweep_lags.clear();
+  _stereo_matches_per_offset.clear();
   LOG_INFO(std::cerr << "StereoFramePointGenerator::~StereoFramePointGenerator|destroyed" << std::endl)
 }
 
@@ -60,39 +72,134 @@ void StereoFramePointGenerator::initialize(Frame* frame_, const bool& extract_fe
   //ds check if a new feature extraction is desired (the frame might already be set up)
   if (extract_features_) {
 
-    //ds detect new features - check if we have information from a previous computation
-    if (frame_->previous()) {
-      detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->previous()->hasReliablePoseEstimate());
-      detectKeypoints(frame_->intensityImageRight(), frame_->keypointsRight(), frame_->previous()->hasReliablePoseEstimate());
-    } else {
-      detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft());
-      detectKeypoints(frame_->intensityImageRight(), frame_->keypointsRight());
-    }
-    adjustDetectorThresholds();
+    //ds check if we have information from a previous computation
+    const bool ignore_minimum_detector_threshold = (frame_->previous() && frame_->previous()->hasReliablePoseEstimate());
 
-    //ds extract descriptors for detected features
-    computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
-    computeDescriptors(frame_->intensityImageRight(), frame_->keypointsRight(), frame_->descriptorsRight());
+    //ds detect new features and extract descriptors
+    _extractFeatures(frame_->intensityImageLeft(), frame_->intensityImageRight(),
+                     frame_->keypointsLeft(), frame_->keypointsRight(),
+                     frame_->descriptorsLeft(), frame_->descriptorsRight(),
+                     ignore_minimum_detector_threshold);
     _number_of_detected_keypoints = frame_->keypointsLeft().size();
     LOG_DEBUG(std::cerr << "StereoFramePointGenerator::initialize|extracted features L: " << frame_->keypointsLeft().size()
                         << " R: " << frame_->keypointsRight().size() << std::endl)
+    _setMaximumDescriptorDistanceTriangulation(frame_->status());
+  }
+
+  //ds initialize matchers for left and right frame
+  _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
+  _feature_matcher_right.setFeatures(frame_->keypointsRight(), frame_->descriptorsRight());
+}
 
-    //ds set maximum descriptor distance for triangulation depending on on state
-    if (frame_->status() == Frame::Localizing) {
+void StereoFramePointGenerator::initialize(Frame* frame_, ExtractedFeatures& features_) {
+  if (!frame_) {
+    throw std::runtime_error("StereoFramePointGenerator::initialize|called with empty frame");
+  }
 
-      //ds be conservative while localizing
-      _current_maximum_descriptor_distance_triangulation = std::min(0.1*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS, _parameters->maximum_matching_distance_triangulation);
-    } else {
+  //ds move the features into the frame
+  frame_->keypointsLeft().swap(features_.keypoints_left);
+  frame_->keypointsRight().swap(features_.keypoints_right);
+  frame_->descriptorsLeft()  = features_.descriptors_left;
+  frame_->descriptorsRight() = features_.descriptors_right;
+  features_.descriptors_left.release();
+  features_.descriptors_right.release();
+  _number_of_detected_keypoints = frame_->keypointsLeft().size();
+  _setMaximumDescriptorDistanceTriangulation(frame_->status());
+
+  //ds initialize matchers without extraction
+  initialize(frame_, false);
+}
 
-      //ds adjust triangulation distance: few points > narrow window as we cannot permit a relatively high ratio of invalid triangulations
-      const real ratio_available_points = std::min(static_cast<real>(_number_of_detected_keypoints)/_target_number_of_keypoints, 1.0);
-      _current_maximum_descriptor_distance_triangulation = std::max(ratio_available_points*_parameters->maximum_matching_distance_triangulation, 0.1*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS);
+void StereoFramePointGenerator::extractFeatures(const cv::Mat& image_left_,
+                                                const cv::Mat& image_right_,
+                                                ExtractedFeatures& features_,
+                                                const bool& ignore_minimum_detector_threshold_) {
+  features_.time_consumption_seconds_keypoint_detection.assign(2, 0);
+  features_.time_consumption_seconds_descriptor_extraction.assign(2, 0);
+  features_.time_consumption_seconds_feature_extraction = 0;
+  _extractFeatures(image_left_, image_right_,
+                   features_.keypoints_left, features_.keypoints_right,
+                   features_.descriptors_left, features_.descriptors_right,
+                   ignore_minimum_detector_threshold_,
+                   &features_);
+}
+
+void StereoFramePointGenerator::addExtractionStatistics(const ExtractedFeatures& features_) {
+  BaseFramePointGenerator::addExtractionStatistics(features_);
+  _time_consumption_seconds_feature_extraction += features_.time_consumption_seconds_feature_extraction;
+}
+
+void StereoFramePointGenerator::_extractFeatures(const cv::Mat& image_left_,
+                                                 const cv::Mat& image_right_,
+                                                 std::vector<cv::KeyPoint>& keypoints_left_,
+                                                 std::vector<cv::KeyPoint>& keypoints_right_,
+                                                 cv::Mat& descriptors_left_,
+                                                 cv::Mat& descriptors_right_,
+                                                 const bool& ignore_minimum_detector_threshold_,
+                                                 ExtractedFeatures* features_statistics_) {
+  const double time_start_seconds = srrg_core::getTime();
+  PROFILER_SPAN(feature_extraction)
+
+  //ds per stream timings either go to the generator statistics or to the extracted features (see addExtractionStatistics)
+  double* time_consumption_seconds_keypoint_detection[2]    = {nullptr, nullptr};
+  double* time_consumption_seconds_descriptor_extraction[2] = {nullptr, nullptr};
+  if (features_statistics_) {
+    for (Index stream_index = 0; stream_index < 2; ++stream_index) {
+      time_consumption_seconds_keypoint_detection[stream_index]    = &features_statistics_->time_consumption_seconds_keypoint_detection[stream_index];
+      time_consumption_seconds_descriptor_extraction[stream_index] = &features_statistics_->time_consumption_seconds_descriptor_extraction[stream_index];
     }
   }
 
-  //ds initialize matchers for left and right frame
-  _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
-  _feature_matcher_right.setFeatures(frame_->keypointsRight(), frame_->descriptorsRight());
+  //ds if the image streams are processed in parallel
+  if (_thread_pool && _parameters->enable_parallel_feature_extraction) {
+
+    //ds detect new features and extract descriptors for both image streams on the shared thread pool
+    //ds the pool threads record their spans for the frame of the caller (which might differ from the one of the main thread)
+    const uint32_t profiler_frame_identifier = Profiler::frameIdentifier();
+    _thread_pool->parallelFor(0, 2, [&](const Index& stream_index_) {
+      Profiler::FrameScope profiler_frame_scope(profiler_frame_identifier);
+      if (stream_index_ == 0) {
+        detectKeypoints(image_left_, keypoints_left_, ignore_minimum_detector_threshold_, 0, time_consumption_seconds_keypoint_detection[0]);
+        computeDescriptors(image_left_, keypoints_left_, descriptors_left_, 0, time_consumption_seconds_descriptor_extraction[0]);
+      } else {
+        detectKeypoints(image_right_, keypoints_right_, ignore_minimum_detector_threshold_, 1, time_consumption_seconds_keypoint_detection[1]);
+        computeDescriptors(image_right_, keypoints_right_, descriptors_right_, 1, time_consumption_seconds_descriptor_extraction[1]);
+      }
+    }, ThreadPool::Stage::FEATURE_EXTRACTION);
+
+    //ds the detector thresholds are adjusted only once both streams completed detection
+    adjustDetectorThresholds();
+  } else {
+
+    //ds detect new features
+    detectKeypoints(image_left_, keypoints_left_, ignore_minimum_detector_threshold_, 0, time_consumption_seconds_keypoint_detection[0]);
+    detectKeypoints(image_right_, keypoints_right_, ignore_minimum_detector_threshold_, 1, time_consumption_seconds_keypoint_detection[1]);
+    adjustDetectorThresholds();
+
+    //ds extract descriptors for detected features
+    computeDescriptors(image_left_, keypoints_left_, descriptors_left_, 0, time_consumption_seconds_descriptor_extraction[0]);
+    computeDescriptors(image_right_, keypoints_right_, descriptors_right_, 1, time_consumption_seconds_descriptor_extraction[1]);
+  }
+  if (features_statistics_) {
+    features_statistics_->time_consumption_seconds_feature_extraction += srrg_core::getTime()-time_start_seconds;
+  } else {
+    _time_consumption_seconds_feature_extraction += srrg_core::getTime()-time_start_seconds;
+  }
+}
+
+void StereoFramePointGenerator::_setMaximumDescriptorDistanceTriangulation(const Frame::Status& status_) {
+
+  //ds set maximum descriptor distance for triangulation depending on on state
+  if (status_ == Frame::Localizing) {
+
+    //ds be conservative while localizing
+    _current_maximum_descriptor_distance_triangulation = std::min(0.1*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS, _parameters->maximum_matching_distance_triangulation);
+  } else {
+
+    //ds adjust triangulation distance: few points > narrow window as we cannot permit a relatively high ratio of invalid triangulations
+    const real ratio_available_points = std::min(static_cast<real>(_number_of_detected_keypoints)/_target_number_of_keypoints, 1.0);
+    _current_maximum_descriptor_distance_triangulation = std::max(ratio_available_points*_parameters->maximum_matching_distance_triangulation, 0.1*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS);
+  }
 }
 
 void StereoFramePointGenerator::compute(Frame* frame_) {
@@ -115,124 +222,140 @@ void StereoFramePointGenerator::compute(Frame* frame_) {
   //ds prepare for fast stereo matching - we temporally break the IntensityFeature.index_in_vector, which will be restored when pruning
   _feature_matcher_left.sortFeatureVector();
   _feature_matcher_right.sortFeatureVector();
+  const IntensityFeaturePointerVector& features_left(_feature_matcher_left.feature_vector);
+  const IntensityFeaturePointerVector& features_right(_feature_matcher_right.feature_vector);
+
+  //ds bucket the sorted features by image rows
+  _computeRowOffsets(features_left, _row_offsets_left);
+  _computeRowOffsets(features_right, _row_offsets_right);
+
+  //ds matched features (to not consider them for other offsets) NOTE: that we have to use the indices of the sorted vector instead of IntensityFeature.index_in_vector
+  //ds this because the IntensityFeature.index_in_vector gets broken after the sorting and we don't want to spend time on maintaining it for this task
+  _matched_left.assign(features_left.size(), false);
+  _matched_right.assign(features_right.size(), false);
+  for (StereoMatchVector& stereo_matches: _stereo_matches_per_offset) {
+    stereo_matches.clear();
+  }
 
-  //ds new framepoints - optionally filtered in a consecutive binning
-  FramePointPointerVector framepoints_new(_number_of_detected_keypoints);
-  Count number_of_new_points = 0;
-
-  //ds start stereo matching for all epipolar offsets
-  for (const int32_t& epipolar_offset: _epipolar_search_offsets_pixel) {
-    IntensityFeaturePointerVector& features_left(_feature_matcher_left.feature_vector);
-    IntensityFeaturePointerVector& features_right(_feature_matcher_right.feature_vector);
-
-    //ds matched features (to not consider them for the next offset search)
-    std::set<uint32_t> matched_indices_left;
-    std::set<uint32_t> matched_indices_right;
-
-    //ds running variable
-    uint32_t index_R = 0;
-
-    //ds loop over all left keypoints
-    for (uint32_t index_L = 0; index_L < features_left.size(); index_L++) {
-
-      //ds if there are no more points on the right to match against - stop
-      if (index_R == features_right.size()) {break;}
-
-      //ds the right keypoints are on an lower row - skip left
-      while (features_left[index_L]->row < features_right[index_R]->row+epipolar_offset) {
-        index_L++; if (index_L == features_left.size()) {break;}
+  //ds match all epipolar offsets in a single sweep over the image rows: at step t offset k matches left row t-lag(k) against right row t-lag(k)-offset(k)
+  //ds the lags ensure that row pairs sharing a left or right row are matched in offset priority order (identical to matching one offset after the other)
+  const int32_t number_of_sweep_steps = _number_of_rows_image+_epipolar_sweep_lags.back();
+  for (int32_t step = 0; step < number_of_sweep_steps; ++step) {
+    for (Index k = 0; k < _epipolar_search_offsets_pixel.size(); ++k) {
+      const int32_t row_left  = step-_epipolar_sweep_lags[k];
+      const int32_t row_right = row_left-_epipolar_search_offsets_pixel[k];
+      if (row_left < 0 || row_left >= _number_of_rows_image || row_right < 0 || row_right >= _number_of_rows_image) {
+        continue;
       }
-      if (index_L == features_left.size()) {break;}
-      IntensityFeature* feature_left = features_left[index_L];
 
-      //ds the right keypoints are on an upper row - skip right
-      while (feature_left->row > features_right[index_R]->row+epipolar_offset) {
-        index_R++; if (index_R == features_right.size()) {break;}
-      }
-      if (index_R == features_right.size()) {break;}
+      //ds running variable: first right candidate (candidates left of the last match are structurally conflicting)
+      uint32_t index_begin_R     = _row_offsets_right[row_right];
+      const uint32_t index_end_R = _row_offsets_right[row_right+1];
 
-      //ds search bookkeeping
-      uint32_t index_search_R       = index_R;
-      real descriptor_distance_best = _current_maximum_descriptor_distance_triangulation;
-      uint32_t index_best_R         = 0;
+      //ds loop over all left keypoints in the row
+      for (uint32_t index_L = _row_offsets_left[row_left]; index_L < _row_offsets_left[row_left+1]; ++index_L) {
 
-      //ds scan epipolar line for current keypoint at idx_L - exhaustive
-      while (feature_left->row == features_right[index_search_R]->row+epipolar_offset) {
+        //ds if there are no more points on the right to match against - stop
+        if (index_begin_R == index_end_R) {break;}
 
-        //ds invalid disparity stop condition
-        if (feature_left->col-features_right[index_search_R]->col < 0) {break;}
+        //ds skip already matched features
+        if (_matched_left[index_L]) {continue;}
+        IntensityFeature* feature_left = features_left[index_L];
 
-        //ds compute descriptor distance for the stereo match candidates
-        const real descriptor_distance = cv::norm(feature_left->descriptor, features_right[index_search_R]->descriptor, SRRG_PROSLAM_DESCRIPTOR_NORM);
-        if(descriptor_distance < descriptor_distance_best) {
-          descriptor_distance_best = descriptor_distance;
-          index_best_R             = index_search_R;
-        }
-        index_search_R++; if (index_search_R == features_right.size()) {break;}
-      }
+        //ds search bookkeeping
+        real descriptor_distance_best = _current_maximum_descriptor_distance_triangulation;
+        uint32_t index_best_R         = 0;
 
-      //ds check if something was found
-      if (descriptor_distance_best < _current_maximum_descriptor_distance_triangulation) {
-        IntensityFeature* feature_right = features_right[index_best_R];
+        //ds scan epipolar line for current keypoint at idx_L - exhaustive
+        for (uint32_t index_search_R = index_begin_R; index_search_R < index_end_R; ++index_search_R) {
+          if (_matched_right[index_search_R]) {continue;}
 
-        //ds skip points with insufficient stereo disparity
-        if (feature_left->col-feature_right->col < _parameters->minimum_disparity_pixels) {
-          continue;
+          //ds invalid disparity stop condition
+          if (feature_left->col-features_right[index_search_R]->col < 0) {break;}
+
+          //ds compute descriptor distance for the stereo match candidates
+          const real descriptor_distance = DescriptorDistance::compute(feature_left->descriptor, features_right[index_search_R]->descriptor);
+          if(descriptor_distance < descriptor_distance_best) {
+            descriptor_distance_best = descriptor_distance;
+            index_best_R             = index_search_R;
+          }
         }
 
-        //ds compute a new framepoint without track
-        FramePoint* framepoint = frame_->createFramepoint(feature_left,
-                                                          feature_right,
-                                                          descriptor_distance_best,
-                                                          getPointInLeftCamera(feature_left->keypoint.pt, feature_right->keypoint.pt));
-        framepoint->setEpipolarOffset(epipolar_offset);
+        //ds check if something was found
+        if (descriptor_distance_best < _current_maximum_descriptor_distance_triangulation) {
+          IntensityFeature* feature_right = features_right[index_best_R];
 
-        //ds store point for optional binning
-        if (_parameters->enable_keypoint_binning) {
-          const Index row_bin = std::rint(static_cast<real>(feature_left->row)/_parameters->bin_size_pixels);
-          const Index col_bin = std::rint(static_cast<real>(feature_left->col)/_parameters->bin_size_pixels);
+          //ds skip points with insufficient stereo disparity
+          if (feature_left->col-feature_right->col < _parameters->minimum_disparity_pixels) {
+            continue;
+          }
 
-          //ds if there is already a point in the bin
-          if (_bin_map_left[row_bin][col_bin]) {
-            const FramePoint* current = _bin_map_left[row_bin][col_bin];
+          //ds buffer the match and block further matching
+          _stereo_matches_per_offset[k].push_back(StereoMatch(feature_left, feature_right, descriptor_distance_best));
+          _matched_left[index_L]       = true;
+          _matched_right[index_best_R] = true;
 
-            //ds if the point in the bin is not tracked, we prefer points with maximal disparity (= maximally accurate depth estimate)
-            if (!current->previous() &&
-                framepoint->disparityPixels() > current->disparityPixels() &&
-                framepoint->descriptorDistanceTriangulation() <= current->descriptorDistanceTriangulation()) {
+          //ds reduce search space (this eliminates all structurally conflicting matches)
+          index_begin_R = index_best_R+1;
+        }
+      }
+    }
+  }
 
-              //ds overwrite the entry
-              _bin_map_left[row_bin][col_bin] = framepoint;
-            }
-          } else {
+  //ds new framepoints - optionally filtered in a consecutive binning
+  FramePointPointerVector framepoints_new(_number_of_detected_keypoints);
+  Count number_of_new_points = 0;
 
-            //ds add a new entry
+  //ds create framepoints in offset priority order
+  for (Index k = 0; k < _epipolar_search_offsets_pixel.size(); ++k) {
+    for (const StereoMatch& stereo_match: _stereo_matches_per_offset[k]) {
+      const IntensityFeature* feature_left  = stereo_match.feature_left;
+      const IntensityFeature* feature_right = stereo_match.feature_right;
+
+      //ds compute a new framepoint without track
+      FramePoint* framepoint = frame_->createFramepoint(feature_left,
+                                                        feature_right,
+                                                        stereo_match.descriptor_distance,
+                                                        getPointInLeftCamera(feature_left->keypoint.pt, feature_right->keypoint.pt));
+      framepoint->setEpipolarOffset(_epipolar_search_offsets_pixel[k]);
+
+      //ds store point for optional binning
+      if (_parameters->enable_keypoint_binning) {
+        const Index row_bin = std::rint(static_cast<real>(feature_left->row)/_parameters->bin_size_pixels);
+        const Index col_bin = std::rint(static_cast<real>(feature_left->col)/_parameters->bin_size_pixels);
+
+        //ds if there is already a point in the bin
+        if (_bin_map_left[row_bin][col_bin]) {
+          const FramePoint* current = _bin_map_left[row_bin][col_bin];
+
+          //ds if the point in the bin is not tracked, we prefer points with maximal disparity (= maximally accurate depth estimate)
+          if (!current->previous() &&
+              framepoint->disparityPixels() > current->disparityPixels() &&
+              framepoint->descriptorDistanceTriangulation() <= current->descriptorDistanceTriangulation()) {
+
+            //ds overwrite the entry
             _bin_map_left[row_bin][col_bin] = framepoint;
           }
-        }
-
-        //ds set point to buffer
-        framepoints_new[number_of_new_points] = framepoint;
-        ++number_of_new_points;
-
-        //ds block further matching NOTE: that we have to put the indices of the sorted vector instead of using IntensityFeature.index_in_vector
-        //ds this because the IntensityFeature.index_in_vector gets broken after the sorting and we don't want to spend time on maintaining it for this task
-        matched_indices_left.insert(index_L);
-        matched_indices_right.insert(index_best_R);
-        _feature_matcher_left.feature_lattice[feature_left->row][feature_left->col]    = nullptr;
-        _feature_matcher_right.feature_lattice[feature_right->row][feature_right->col] = nullptr;
+        } else {
 
-        //ds reduce search space (this eliminates all structurally conflicting matches)
-        index_R = index_best_R+1;
+          //ds add a new entry
+          _bin_map_left[row_bin][col_bin] = framepoint;
+        }
       }
-    }
 
-    //ds remove matched indices from candidate pools
-    _feature_matcher_left.prune(matched_indices_left);
-    _feature_matcher_right.prune(matched_indices_right);
-    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|epipolar offset: " << epipolar_offset
-                        << " number of unmatched features L: " << features_left.size() << " R: " << features_right.size() << std::endl)
+      //ds set point to buffer
+      framepoints_new[number_of_new_points] = framepoint;
+      ++number_of_new_points;
+      _feature_matcher_left.removeFeature(feature_left);
+      _feature_matcher_right.removeFeature(feature_right);
+    }
+    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|epipolar offset: " << _epipolar_search_offsets_pixel[k]
+                        << " number of matches: " << _stereo_matches_per_offset[k].size() << std::endl)
   }
+
+  //ds remove matched indices from candidate pools
+  _feature_matcher_left.prune(_matched_left);
+  _feature_matcher_right.prune(_matched_right);
   framepoints_new.resize(number_of_new_points);
   LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|number of new stereo points: " << number_of_new_points << "/" << _number_of_detected_keypoints << std::endl)
 
@@ -310,23 +433,14 @@ void StereoFramePointGenerator::track(Frame* frame_,
     //ds TRACKING obtain matching feature in left image (if any)
     real descriptor_distance_best = _maximum_descriptor_distance_tracking;
 
-    //ds define search region (rectangular ROI)
-    int32_t row_start_point = std::max(row_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t row_end_point   = std::min(row_projection_left+_projection_tracking_distance_pixels+1, _number_of_rows_image);
-    int32_t col_start_point = std::max(col_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t col_end_point   = std::min(col_projection_left+_projection_tracking_distance_pixels+1, _number_of_cols_image);
-
-    //ds find the best match for the previous left feature (i.e. track it)
-    IntensityFeature* feature_left = _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left,
-                                                                                                 col_projection_left,
-                                                                                                 point_previous->descriptorLeft(),
-                                                                                                 row_start_point,
-                                                                                                 row_end_point,
-                                                                                                 col_start_point,
-                                                                                                 col_end_point,
-                                                                                                 _maximum_descriptor_distance_tracking,
-                                                                                                 track_by_appearance_,
-                                                                                                 descriptor_distance_best);
+    //ds find the best match for the previous left feature (i.e. track it) in its search region
+    IntensityFeature* feature_left = _getMatchingFeatureLeft(point_in_camera_left_prediction,
+                                                             row_projection_left,
+                                                             col_projection_left,
+                                                             point_previous->descriptorLeft(),
+                                                             _maximum_descriptor_distance_tracking,
+                                                             track_by_appearance_,
+                                                             descriptor_distance_best);
 
     //ds if we found a match
     if (feature_left) {
@@ -348,10 +462,10 @@ void StereoFramePointGenerator::track(Frame* frame_,
       //ds TRIANGULATION: obtain matching feature in right image (if any)
       //ds we reduce the vertical matching space to the epipolar range - we search only to the left of the measure left camera coordinate
       const int32_t epipolar_offset_previous = std::fabs(point_previous->epipolarOffset());
-      row_start_point = std::max(row_projection_right_corrected-epipolar_offset_previous, 0);
-      row_end_point   = std::min(row_projection_right_corrected+epipolar_offset_previous+1, _number_of_rows_image);
-      col_start_point = std::max(col_projection_right_corrected-_projection_tracking_distance_pixels, 0);
-      col_end_point   = std::min(col_projection_right_corrected+_projection_tracking_distance_pixels+1, feature_left->col);
+      const int32_t row_start_point = std::max(row_projection_right_corrected-epipolar_offset_previous, 0);
+      const int32_t row_end_point   = std::min(row_projection_right_corrected+epipolar_offset_previous+1, _number_of_rows_image);
+      const int32_t col_start_point = std::max(col_projection_right_corrected-_projection_tracking_distance_pixels, 0);
+      const int32_t col_end_point   = std::min(col_projection_right_corrected+_projection_tracking_distance_pixels+1, feature_left->col);
 
       //ds we might increase the matching tolerance (maximum_matching_distance_triangulation) since we have a strong prior on location
       IntensityFeature* feature_right = _feature_matcher_right.getMatchingFeatureInRectangularRegion(row_projection_right_corrected,
@@ -375,17 +489,12 @@ void StereoFramePointGenerator::track(Frame* frame_,
         }
 
         //ds skip feature if descriptor distance to previous is violated
-        if (cv::norm(feature_right->descriptor, point_previous->descriptorRight(), SRRG_PROSLAM_DESCRIPTOR_NORM) > _maximum_descriptor_distance_tracking) {
+        if (DescriptorDistance::compute(feature_right->descriptor, point_previous->descriptorRight()) > _maximum_descriptor_distance_tracking) {
           continue;
         }
 
         //ds remove remaining matches in parallax between left and right point in the right image
-        for (int32_t col = feature_right->col+1; col < feature_left->col; ++col) {
-          if (_feature_matcher_right.feature_lattice[feature_right->row][col]) {
-            matched_indices_right.insert(_feature_matcher_right.feature_lattice[feature_right->row][col]->index_in_vector);
-            _feature_matcher_right.feature_lattice[feature_right->row][col] = nullptr;
-          }
-        }
+        _feature_matcher_right.removeFeatures(feature_right->row, feature_right->col+1, feature_left->col, matched_indices_right);
 
         //ds create a stereo match
         FramePoint* framepoint = frame_->createFramepoint(feature_left,
@@ -408,8 +517,8 @@ void StereoFramePointGenerator::track(Frame* frame_,
         //ds block matching in exhaustive matching (later)
         matched_indices_left.insert(feature_left->index_in_vector);
         matched_indices_right.insert(feature_right->index_in_vector);
-        _feature_matcher_left.feature_lattice[feature_left->row][feature_left->col]    = nullptr;
-        _feature_matcher_right.feature_lattice[feature_right->row][feature_right->col] = nullptr;
+        _feature_matcher_left.removeFeature(feature_left);
+        _feature_matcher_right.removeFeature(feature_right);
 
         if (point_previous->landmark()) {
           ++_number_of_tracked_landmarks;
@@ -513,20 +622,21 @@ void StereoFramePointGenerator::recoverPoints(Frame* current_frame_, const Frame
     //ds extract descriptors at this position: LEFT
     keypoint_buffer_left[0]    = point_previous->keypointLeft();
     keypoint_buffer_left[0].pt = offset_keypoint_half;
-    cv::Mat descriptor_left;
+    cv::Mat descriptor_matrix_left;
     const cv::Mat roi_left(intensity_image_left(region_of_interest_left));
-    _descriptor_extractor->compute(roi_left, keypoint_buffer_left, descriptor_left);
+    _descriptor_extractor->compute(roi_left, keypoint_buffer_left, descriptor_matrix_left);
 
     //ds if no descriptor could be computed
-    if (descriptor_left.rows == 0) {
+    if (descriptor_matrix_left.rows == 0) {
       continue;
     }
+    const BinaryDescriptor descriptor_left(descriptor_matrix_left);
 
     //ds move keypoint to global image coordinates
     keypoint_buffer_left[0].pt += corner_left;
 
     //ds if descriptor distance is to high
-    if (cv::norm(point_previous->descriptorLeft(), descriptor_left, SRRG_PROSLAM_DESCRIPTOR_NORM) > _maximum_descriptor_distance_tracking) {
+    if (DescriptorDistance::compute(point_previous->descriptorLeft(), descriptor_left) > _maximum_descriptor_distance_tracking) {
       continue;
     }
 
@@ -537,14 +647,15 @@ void StereoFramePointGenerator::recoverPoints(Frame* current_frame_, const Frame
     //ds extract descriptors at this position: RIGHT
     keypoint_buffer_right[0]    = point_previous->keypointRight();
     keypoint_buffer_right[0].pt = offset_keypoint_half;
-    cv::Mat descriptor_right;
+    cv::Mat descriptor_matrix_right;
     const cv::Mat roi_right(intensity_image_right(region_of_interest_right));
-    _descriptor_extractor->compute(roi_right, keypoint_buffer_right, descriptor_right);
+    _descriptor_extractor->compute(roi_right, keypoint_buffer_right, descriptor_matrix_right);
 
     //ds if no descriptor could be computed
-    if (descriptor_right.rows == 0) {
+    if (descriptor_matrix_right.rows == 0) {
       continue;
     }
+    const BinaryDescriptor descriptor_right(descriptor_matrix_right);
 
     //ds move keypoint to global image coordinates
     keypoint_buffer_right[0].pt += corner_right;
@@ -555,30 +666,27 @@ void StereoFramePointGenerator::recoverPoints(Frame* current_frame_, const Frame
     }
 
     //ds if descriptor distance is to high
-    if (cv::norm(point_previous->descriptorRight(), descriptor_right, SRRG_PROSLAM_DESCRIPTOR_NORM) > _maximum_descriptor_distance_tracking) {
+    if (DescriptorDistance::compute(point_previous->descriptorRight(), descriptor_right) > _maximum_descriptor_distance_tracking) {
       continue;
     }
 
     //ds check stereo triangulation distance
-    const real descriptor_distance_triangulation = cv::norm(descriptor_left, descriptor_right, SRRG_PROSLAM_DESCRIPTOR_NORM);
+    const real descriptor_distance_triangulation = DescriptorDistance::compute(descriptor_left, descriptor_right);
     if (descriptor_distance_triangulation > _current_maximum_descriptor_distance_triangulation) {
       continue;
     }
 
-    //ds instantiate features (will be owned by the framepoint)
-    IntensityFeature* feature_left  = new IntensityFeature(keypoint_buffer_left[0], descriptor_left, 0);
-    IntensityFeature* feature_right = new IntensityFeature(keypoint_buffer_right[0], descriptor_right, 0);
+    //ds instantiate temporary features (the framepoint copies their content)
+    const IntensityFeature feature_left(keypoint_buffer_left[0], descriptor_left, 0);
+    const IntensityFeature feature_right(keypoint_buffer_right[0], descriptor_right, 0);
 
     //ds allocate a new point connected to the previous one
-    FramePoint* current_point = current_frame_->createFramepoint(feature_left,
-                                                                 feature_right,
+    FramePoint* current_point = current_frame_->createFramepoint(&feature_left,
+                                                                 &feature_right,
                                                                  descriptor_distance_triangulation,
                                                                  getPointInLeftCamera(keypoint_buffer_left[0].pt, keypoint_buffer_right[0].pt),
                                                                  point_previous);
 
-    delete feature_left;
-    delete feature_right;
-
     //ds set the point to the control structure
     current_frame_->points()[index_lost_point_recovered] = current_point;
     ++index_lost_point_recovered;
@@ -588,6 +696,19 @@ void StereoFramePointGenerator::recoverPoints(Frame* current_frame_, const Frame
                       << current_frame_->points().size()-number_of_tracked_points << "/" << lost_points_.size() << std::endl)
 }
 
+void StereoFramePointGenerator::_computeRowOffsets(const IntensityFeaturePointerVector& features_, std::vector<uint32_t>& row_offsets_) const {
+  assert(row_offsets_.size() == static_cast<size_t>(_number_of_rows_image+1));
+
+  //ds count features per row and accumulate (features are sorted by ascending rows)
+  std::fill(row_offsets_.begin(), row_offsets_.end(), 0);
+  for (const IntensityFeature* feature: features_) {
+    ++row_offsets_[feature->row+1];
+  }
+  for (int32_t row = 0; row < _number_of_rows_image; ++row) {
+    row_offsets_[row+1] += row_offsets_[row];
+  }
+}
+
 const PointCoordinates StereoFramePointGenerator::getPointInLeftCamera(const cv::Point2f& image_coordinates_left_, const cv::Point2f& image_coordinates_right_) const {
   assert(image_coordinates_left_.x >= image_coordinates_right_.x);
   assert(image_coordinates_left_.x-image_coordinates_right_.x >= _parameters->minimum_disparity_pixels);
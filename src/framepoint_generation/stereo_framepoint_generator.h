@@ -15,6 +15,18 @@ public:
   //ds initializes the framepoint generator (e.g. detects keypoints and computes descriptors in the left and right camera image)
   virtual void initialize(Frame* frame_, const bool& extract_features_ = true) override;
 
+  //! @brief initializes the framepoint generator with features extracted beforehand (pipelined processing)
+  virtual void initialize(Frame* frame_, ExtractedFeatures& features_) override;
+
+  //! @brief detects keypoints and computes descriptors in the left and right camera image without a frame (pipelined processing)
+  virtual void extractFeatures(const cv::Mat& image_left_,
+                               const cv::Mat& image_right_,
+                               ExtractedFeatures& features_,
+                               const bool& ignore_minimum_detector_threshold_) override;
+
+  //! @brief adds the time consumption recorded by extractFeatures to the generator statistics (including the overall extraction)
+  virtual void addExtractionStatistics(const ExtractedFeatures& features_) override;
+
   //! @brief computes framepoints based on exhaustive, rigid stereo matching on multiple epipolar lines without prior
   //! @param[in, out] frame_ frame that will be filled with framepoints
   virtual void compute(Frame* frame_) override;
@@ -44,6 +56,26 @@ public:
   inline void setCameraRight(const Camera* camera_right_) {_camera_right = camera_right_;}
   const real& meanTriangulationSuccessRatio() const {return _mean_triangulation_success_ratio;}
 
+//ds helpers
+protected:
+
+  //! @brief detects keypoints and computes descriptors in both images (streams processed in parallel if enabled)
+  //! @param[in,out] features_statistics_ if set, the time consumption is recorded there instead of in the generator statistics
+  void _extractFeatures(const cv::Mat& image_left_,
+                        const cv::Mat& image_right_,
+                        std::vector<cv::KeyPoint>& keypoints_left_,
+                        std::vector<cv::KeyPoint>& keypoints_right_,
+                        cv::Mat& descriptors_left_,
+                        cv::Mat& descriptors_right_,
+                        const bool& ignore_minimum_detector_threshold_,
+                        ExtractedFeatures* features_statistics_ = nullptr);
+
+  //! @brief sets the maximum descriptor distance for triangulation depending on the frame status and the number of detected keypoints
+  void _setMaximumDescriptorDistanceTriangulation(const Frame::Status& status_);
+
+  //! @brief computes row buckets for a feature vector sorted by ascending rows
+  void _computeRowOffsets(const IntensityFeaturePointerVector& features_, std::vector<uint32_t>& row_offsets_) const;
+
 //ds settings
 protected:
 
@@ -69,15 +101,44 @@ protected:
   real _mean_triangulation_success_ratio = 1;
   Count _number_of_triangulations = 1;
 
-  //! @brief horizontal epipolar stereo matching search offsets (to consider for stereo matching)
+  //! @brief horizontal epipolar stereo matching search offsets (to consider for stereo matching), ordered by matching priority
   std::vector<int32_t> _epipolar_search_offsets_pixel;
 
-  //! @brief feature matching class (maintains features in a 2D lattice corresponding to the image and a vector)
+  //! @brief row lag of each epipolar offset in the single stereo matching sweep over all image rows
+  //! @brief guarantees that each row pair is matched after all row pairs of higher priority offsets that share one of its rows
+  std::vector<int32_t> _epipolar_sweep_lags;
+
+  //! @brief stereo match buffered during the sweep (framepoints are created afterwards in offset priority order)
+  struct StereoMatch {
+    StereoMatch(IntensityFeature* feature_left_,
+                IntensityFeature* feature_right_,
+                const real& descriptor_distance_): feature_left(feature_left_),
+                                                   feature_right(feature_right_),
+                                                   descriptor_distance(descriptor_distance_) {}
+    IntensityFeature* feature_left;
+    IntensityFeature* feature_right;
+    real descriptor_distance;
+  };
+  typedef std::vector<StereoMatch> StereoMatchVector;
+
+  //! @brief stereo matches per epipolar offset (same order as _epipolar_search_offsets_pixel)
+  std::vector<StereoMatchVector> _stereo_matches_per_offset;
+
+  //! @brief row buckets of the sorted feature vectors: features of row r are in [offsets[r], offsets[r+1])
+  std::vector<uint32_t> _row_offsets_left;
+  std::vector<uint32_t> _row_offsets_right;
+
+  //! @brief dense blocking bitmaps for already matched features (indexed like the sorted feature vectors)
+  std::vector<bool> _matched_left;
+  std::vector<bool> _matched_right;
+
+  //! @brief feature matching class (maintains features in a sparse per-row index corresponding to the image and a vector)
   IntensityFeatureMatcher _feature_matcher_right;
 
 private:
 
   //ds informative only
   CREATE_CHRONOMETER(point_triangulation)
+  CREATE_CHRONOMETER(feature_extraction)
 };
 }
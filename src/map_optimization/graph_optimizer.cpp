@@ -1,5 +1,6 @@
 #include "graph_optimizer.h"
 #include "g2o/core/robust_kernel_impl.h"
+#include "g2o/core/jacobian_workspace.h"
 
 //ds backwards compatibility with g2o
 #ifdef SRRG_PROSLAM_G2O_HAS_NEW_OWNERSHIP_MODEL
@@ -92,6 +93,7 @@ void GraphOptimizer::configure() {
   //ds clean bookkeeping
   _vertex_local_map_last_added = 0;
   _frames_in_pose_graph.clear();
+  _frames_in_window.clear();
   _local_maps_in_graph.clear();
   _landmarks_in_pose_graph.clear();
 
@@ -129,7 +131,7 @@ void GraphOptimizer::writePoseGraphToFile(const WorldMap* world_map_, const std:
   //ds get a graph handle
   g2o::OptimizableGraph* pose_graph = new g2o::OptimizableGraph();
   g2o::VertexSE3* vertex_frame_last_added = 0;
-  std::map<Landmark*, g2o::VertexPointXYZ*, std::less<Landmark*>, Eigen::aligned_allocator<std::pair<Landmark*, g2o::VertexPointXYZ*>>> landmarks_in_pose_graph;
+  IdentifierMap<g2o::VertexPointXYZ> landmarks_in_pose_graph;
 
   //ds set world parameter (required for landmark EdgeSE3PointXYZ measurements)
   g2o::ParameterSE3Offset* parameter_world_offset = new g2o::ParameterSE3Offset();
@@ -166,10 +168,10 @@ void GraphOptimizer::writePoseGraphToFile(const WorldMap* world_map_, const std:
       //ds if the framepoint is linked to a landmark
       Landmark* landmark = framepoint->landmark();
       if (landmark) {
-        g2o::VertexPointXYZ* vertex_landmark = 0;
+        g2o::VertexPointXYZ* vertex_landmark = landmarks_in_pose_graph.get(landmark->identifier());
 
         //ds check if the landmark not yet present in the graph
-        if (landmarks_in_pose_graph.find(landmark) == landmarks_in_pose_graph.end()) {
+        if (!vertex_landmark) {
 
           //ds allocate a new point vertex and add it to the graph
           vertex_landmark = new g2o::VertexPointXYZ( );
@@ -178,11 +180,7 @@ void GraphOptimizer::writePoseGraphToFile(const WorldMap* world_map_, const std:
           pose_graph->addVertex(vertex_landmark);
 
           //ds bookkeep the landmark
-          landmarks_in_pose_graph.insert(std::make_pair(landmark, vertex_landmark));
-        } else {
-
-          //ds retrieve existing vertex using our bookkeeping container
-          vertex_landmark = landmarks_in_pose_graph[landmark];
+          landmarks_in_pose_graph.insert(std::make_pair(landmark->identifier(), vertex_landmark));
         }
 
         //ds add framepoint position as measurement for the landmark
@@ -249,23 +247,14 @@ void GraphOptimizer::addPose(LocalMap* local_map_) {
   }
 
   //ds if the local map has not been checked in a previous frame
-  assert(_local_maps_in_graph.find(local_map_->identifier()) == _local_maps_in_graph.end());
+  assert(!_local_maps_in_graph.get(local_map_->identifier()));
 
   //ds add a new local map
   _local_maps_in_graph.insert(std::make_pair(local_map_->identifier(), local_map_));
 
   //ds for all loop closures on this local map
   for (const Closure::ClosureConstraint& closure: local_map_->closures()) {
-
-    //ds compute information value (closure edges weight much more than pose edges to be able to deform the graph properly)
-    const real information_factor = _parameters->base_information_frame*closure.omega*10;
-
-    //ds retrieve reference frame (must be present)
-    g2o::VertexSE3* vertex_reference = dynamic_cast<g2o::VertexSE3*>(_optimizer->vertex(closure.local_map->identifier()));
-    assert(vertex_reference);
-
-    //ds introduce loop closure constraint between the two local maps
-    _setPoseEdge(_optimizer, vertex_current, vertex_reference, closure.relation, information_factor);
+    _setClosureEdge(_optimizer, vertex_current, closure);
   }
 
   //ds bookkeep the added frame
@@ -273,6 +262,20 @@ void GraphOptimizer::addPose(LocalMap* local_map_) {
   CHRONOMETER_STOP(addition)
 }
 
+void GraphOptimizer::addLoopClosure(LocalMap* local_map_query_, const Closure::ClosureConstraint& closure_) {
+  CHRONOMETER_START(addition)
+
+  //ds retrieve query frame (must be present)
+  g2o::VertexSE3* vertex_query = dynamic_cast<g2o::VertexSE3*>(_optimizer->vertex(local_map_query_->identifier()));
+  if (!vertex_query) {
+    LOG_WARNING(std::cerr << "GraphOptimizer::addLoopClosure|local map not in pose graph: " << local_map_query_->identifier() << std::endl)
+    CHRONOMETER_STOP(addition)
+    return;
+  }
+  _setClosureEdge(_optimizer, vertex_query, closure_);
+  CHRONOMETER_STOP(addition)
+}
+
 void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
   CHRONOMETER_START(addition)
 
@@ -291,10 +294,10 @@ void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
       //ds if the framepoint is linked to a landmark
       Landmark* landmark = framepoint->landmark();
       if (landmark) {
-        g2o::VertexPointXYZ* vertex_landmark = 0;
+        g2o::VertexPointXYZ* vertex_landmark = _landmarks_in_pose_graph.get(landmark->identifier());
 
         //ds check if the landmark not yet present in the graph
-        if (_landmarks_in_pose_graph.find(landmark) == _landmarks_in_pose_graph.end()) {
+        if (!vertex_landmark) {
 
           //ds allocate a new point vertex and add it to the graph
           vertex_landmark = new g2o::VertexPointXYZ( );
@@ -303,11 +306,7 @@ void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
           _optimizer->addVertex(vertex_landmark);
 
           //ds bookkeep the landmark
-          _landmarks_in_pose_graph.insert(std::make_pair(landmark, vertex_landmark));
-        } else {
-
-          //ds retrieve existing vertex using our bookkeeping container
-          vertex_landmark = _landmarks_in_pose_graph[landmark];
+          _landmarks_in_pose_graph.insert(std::make_pair(landmark->identifier(), vertex_landmark));
         }
 
         //ds add framepoint position as measurement for the landmark - porting weight from previous optimization
@@ -325,10 +324,10 @@ void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
       //ds if the framepoint is linked to a landmark
       Landmark* landmark = framepoint->landmark();
       if (landmark) {
-        g2o::VertexPointXYZ* vertex_landmark = 0;
+        g2o::VertexPointXYZ* vertex_landmark = _landmarks_in_pose_graph.get(landmark->identifier());
 
         //ds check if the landmark not yet present in the graph
-        if (_landmarks_in_pose_graph.find(landmark) == _landmarks_in_pose_graph.end()) {
+        if (!vertex_landmark) {
 
           //ds allocate a new point vertex and add it to the graph
           vertex_landmark = new g2o::VertexPointXYZ( );
@@ -337,11 +336,7 @@ void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
           _optimizer->addVertex(vertex_landmark);
 
           //ds bookkeep the landmark
-          _landmarks_in_pose_graph.insert(std::make_pair(landmark, vertex_landmark));
-        } else {
-
-          //ds retrieve existing vertex using our bookkeeping container
-          vertex_landmark = _landmarks_in_pose_graph[landmark];
+          _landmarks_in_pose_graph.insert(std::make_pair(landmark->identifier(), vertex_landmark));
         }
 
         //ds add framepoint position as measurement for the landmark
@@ -349,17 +344,18 @@ void GraphOptimizer::addPoseWithFactors(Frame* frame_) {
       }
     }
 
-    //ds we can connect it to the preceeding frame by adding the odometry measurement
+    //ds we can connect it to the preceeding frame by adding the odometry measurement (relative to the last added frame)
     _setPoseEdge(_optimizer,
                 vertex_frame_current,
                 _vertex_local_map_last_added,
-                frame_->previous()->worldToRobot()*frame_->robotToWorld(),
+                _frames_in_window.back()->worldToRobot()*frame_->robotToWorld(),
                 _parameters->base_information_frame);
   }
 
   //ds bookkeep the added frame
   _vertex_local_map_last_added = vertex_frame_current;
-  _frames_in_pose_graph.insert(std::make_pair(frame_, vertex_frame_current));
+  _frames_in_pose_graph.insert(std::make_pair(frame_->identifier(), vertex_frame_current));
+  _frames_in_window.push_back(frame_);
   CHRONOMETER_STOP(addition)
 }
 
@@ -421,12 +417,10 @@ void GraphOptimizer::optimizeFactorGraph(WorldMap* world_map_) {
   _optimizer->optimize(_parameters->maximum_number_of_iterations);
 
   //ds directly backpropagate solution to frames and landmarks
-  for(std::pair<Frame*, g2o::VertexSE3*> frame_in_pose_graph: _frames_in_pose_graph) {
-    frame_in_pose_graph.first->setRobotToWorld(frame_in_pose_graph.second->estimate().cast<real>());
-  }
-  for(std::pair<Landmark*, g2o::VertexPointXYZ*> landmark_in_pose_graph: _landmarks_in_pose_graph) {
-    landmark_in_pose_graph.first->setCoordinates(landmark_in_pose_graph.second->estimate().cast<real>());
+  for (Frame* frame: _frames_in_window) {
+    frame->setRobotToWorld(_frames_in_pose_graph.at(frame->identifier())->estimate().cast<real>());
   }
+  _updateLandmarks(world_map_);
   world_map_->setRobotToWorld(world_map_->currentFrame()->robotToWorld());
   ++_number_of_optimizations;
 
@@ -434,10 +428,195 @@ void GraphOptimizer::optimizeFactorGraph(WorldMap* world_map_) {
   _optimizer->clear();
   _vertex_local_map_last_added = 0;
   _frames_in_pose_graph.clear();
+  _frames_in_window.clear();
   _landmarks_in_pose_graph.clear();
   CHRONOMETER_STOP(optimization)
 }
 
+void GraphOptimizer::optimizeSlidingWindow(WorldMap* world_map_) {
+  CHRONOMETER_START(optimization)
+
+  //ds nothing to adjust for a single (fixed) keyframe
+  if (_frames_in_window.size() < 2) {
+    CHRONOMETER_STOP(optimization)
+    return;
+  }
+
+  //ds optimize the active window (the graph is kept between calls)
+  _optimizer->initializeOptimization();
+  _optimizer->optimize(_parameters->maximum_number_of_iterations);
+
+  //ds directly backpropagate solution to the frames and landmarks in the window
+  for (Frame* frame: _frames_in_window) {
+    frame->setRobotToWorld(_frames_in_pose_graph.at(frame->identifier())->estimate().cast<real>());
+  }
+  _updateLandmarks(world_map_);
+  world_map_->setRobotToWorld(world_map_->currentFrame()->robotToWorld());
+  ++_number_of_optimizations;
+
+  //ds bound the window - marginalizing the oldest keyframe (its factors are linearized at the estimates optimized above)
+  //ds at most one keyframe per optimization: the next one is linearized after the window has been re-optimized with the new prior
+  //ds since a single keyframe is added per optimization, this keeps the window at its size
+  if (_frames_in_window.size() > std::max(_parameters->number_of_keyframes_in_sliding_window, static_cast<Count>(2))) {
+    _marginalizeOldestFrame();
+  }
+  CHRONOMETER_STOP(optimization)
+}
+
+void GraphOptimizer::_updateLandmarks(WorldMap* world_map_) {
+  _landmarks_to_update.assign(_landmarks_in_pose_graph.begin(), _landmarks_in_pose_graph.end());
+  const std::function<void(const Index&)> update_landmark = [&](const Index& index_) {
+
+    //ds the landmark might have been merged or removed since it was added to the graph
+    Landmark* landmark = world_map_->landmarks().get(_landmarks_to_update[index_].first);
+    if (landmark) {
+      landmark->setCoordinates(_landmarks_to_update[index_].second->estimate().cast<real>());
+    }
+  };
+
+  //ds every landmark is updated independently
+  if (_thread_pool) {
+    _thread_pool->parallelFor(0, _landmarks_to_update.size(), update_landmark, ThreadPool::Stage::OPTIMIZATION);
+  } else {
+    for (Index index = 0; index < _landmarks_to_update.size(); ++index) {
+      update_landmark(index);
+    }
+  }
+}
+
+void GraphOptimizer::_marginalizeOldestFrame() {
+  assert(_frames_in_window.size() > 1);
+  Frame* frame_oldest = _frames_in_window.front();
+  _frames_in_window.pop_front();
+  g2o::VertexSE3* vertex_oldest = _frames_in_pose_graph.at(frame_oldest->identifier());
+  g2o::VertexSE3* vertex_next   = _frames_in_pose_graph.at(_frames_in_window.front()->identifier());
+
+  //ds information carried forward: Schur complement of the factors attached to the oldest keyframe only (the factors
+  //ds remaining in the window are not counted twice), projected onto the new oldest keyframe - landmark correlations are dropped
+  Matrix6 information_prior(_parameters->base_information_frame*Matrix6::Identity());
+  if (!_computeMarginalizedInformation(vertex_oldest, vertex_next, information_prior)) {
+    LOG_WARNING(std::cerr << "GraphOptimizer::_marginalizeOldestFrame|unable to marginalize information for frame: "
+                          << _frames_in_window.front()->identifier() << " (using base information)" << std::endl)
+  }
+
+  //ds collect the landmarks observed by the oldest keyframe
+  std::set<g2o::VertexPointXYZ*> vertices_landmarks;
+  for (g2o::HyperGraph::Edge* edge: vertex_oldest->edges()) {
+    g2o::EdgeSE3PointXYZ* edge_landmark = dynamic_cast<g2o::EdgeSE3PointXYZ*>(edge);
+    if (edge_landmark) {
+      vertices_landmarks.insert(dynamic_cast<g2o::VertexPointXYZ*>(edge_landmark->vertex(1)));
+    }
+  }
+
+  //ds remove the oldest keyframe including all its factors (landmark measurements, odometry and its prior)
+  _optimizer->removeVertex(vertex_oldest);
+  _frames_in_pose_graph.erase(frame_oldest->identifier());
+
+  //ds remove landmarks that are not observed in the window anymore (their last estimate has already been written back)
+  for (g2o::VertexPointXYZ* vertex_landmark: vertices_landmarks) {
+    if (vertex_landmark->edges().empty()) {
+      _landmarks_in_pose_graph.erase(vertex_landmark->id()-_parameters->identifier_space);
+      _optimizer->removeVertex(vertex_landmark);
+    }
+  }
+
+  //ds anchor the window at the new oldest keyframe with the marginalized information
+  g2o::EdgeSE3Prior* edge_prior = new g2o::EdgeSE3Prior();
+  edge_prior->setVertex(0, vertex_next);
+  edge_prior->setMeasurement(vertex_next->estimate());
+  edge_prior->setInformation(information_prior.cast<double>());
+  edge_prior->setParameterId(0, G2oParameter::WORLD_OFFSET);
+  _optimizer->addEdge(edge_prior);
+  vertex_next->setFixed(false);
+  ++_number_of_marginalized_frames;
+}
+
+bool GraphOptimizer::_computeMarginalizedInformation(g2o::VertexSE3* vertex_oldest_,
+                                                     g2o::VertexSE3* vertex_next_,
+                                                     Matrix6& information_next_) const {
+
+  //ds layout of the local system: the oldest keyframe first, followed by all vertices sharing a factor with it
+  std::map<const g2o::HyperGraph::Vertex*, Index> offsets;
+  offsets.insert(std::make_pair(vertex_oldest_, 0));
+  Index dimension = vertex_oldest_->dimension();
+  for (g2o::HyperGraph::Edge* edge: vertex_oldest_->edges()) {
+    for (g2o::HyperGraph::Vertex* vertex: edge->vertices()) {
+      if (offsets.insert(std::make_pair(vertex, dimension)).second) {
+        dimension += static_cast<g2o::OptimizableGraph::Vertex*>(vertex)->dimension();
+      }
+    }
+  }
+  if (offsets.count(vertex_next_) == 0) {
+    return false;
+  }
+
+  //ds accumulate J^T*Omega*J of the attached factors (odometry, landmark measurements and the previous prior)
+  //ds linearized at the current estimates, robust kernels weighted as in the optimization
+  Eigen::MatrixXd H(Eigen::MatrixXd::Zero(dimension, dimension));
+  g2o::JacobianWorkspace workspace;
+  for (g2o::HyperGraph::Edge* edge: vertex_oldest_->edges()) {
+    workspace.updateSize(edge);
+  }
+  workspace.allocate();
+  auto add_factor = [&](g2o::OptimizableGraph::Edge* edge_,
+                        const std::vector<const g2o::HyperGraph::Vertex*>& vertices_,
+                        const std::vector<Eigen::MatrixXd>& jacobians_,
+                        const Eigen::MatrixXd& information_) {
+    double weight = 1;
+    if (edge_->robustKernel()) {
+      Eigen::Vector3d rho;
+      edge_->robustKernel()->robustify(edge_->chi2(), rho);
+      weight = rho[1];
+    }
+    for (Index a = 0; a < vertices_.size(); ++a) {
+      for (Index b = 0; b < vertices_.size(); ++b) {
+        H.block(offsets.at(vertices_[a]), offsets.at(vertices_[b]), jacobians_[a].cols(), jacobians_[b].cols()) +=
+          weight*jacobians_[a].transpose()*information_*jacobians_[b];
+      }
+    }
+  };
+  for (g2o::HyperGraph::Edge* edge: vertex_oldest_->edges()) {
+    if (g2o::EdgeSE3* edge_pose = dynamic_cast<g2o::EdgeSE3*>(edge)) {
+      edge_pose->computeError();
+      edge_pose->linearizeOplus(workspace);
+      add_factor(edge_pose, {edge_pose->vertex(0), edge_pose->vertex(1)},
+                 {edge_pose->jacobianOplusXi(), edge_pose->jacobianOplusXj()}, edge_pose->information());
+    } else if (g2o::EdgeSE3PointXYZ* edge_landmark = dynamic_cast<g2o::EdgeSE3PointXYZ*>(edge)) {
+      edge_landmark->computeError();
+      edge_landmark->linearizeOplus(workspace);
+      add_factor(edge_landmark, {edge_landmark->vertex(0), edge_landmark->vertex(1)},
+                 {edge_landmark->jacobianOplusXi(), edge_landmark->jacobianOplusXj()}, edge_landmark->information());
+    } else if (g2o::EdgeSE3Prior* edge_prior = dynamic_cast<g2o::EdgeSE3Prior*>(edge)) {
+      edge_prior->computeError();
+      edge_prior->linearizeOplus(workspace);
+      add_factor(edge_prior, {edge_prior->vertex(0)}, {edge_prior->jacobianOplusXi()}, edge_prior->information());
+    } else {
+      LOG_WARNING(std::cerr << "GraphOptimizer::_computeMarginalizedInformation|ignoring unsupported factor type" << std::endl)
+    }
+  }
+
+  //ds a fixed oldest keyframe (the gauge) is known exactly: its removal conditions the remaining factors on it
+  const Index offset_next = offsets.at(vertex_next_);
+  Matrix6 information(H.block<6,6>(offset_next, offset_next).cast<real>());
+  if (!vertex_oldest_->fixed()) {
+
+    //ds Schur complement on the pose block of the new oldest keyframe: H_nn-H_no*H_oo^-1*H_on
+    const Eigen::MatrixXd H_oo(H.topLeftCorner(6, 6));
+    const Eigen::MatrixXd H_on(H.block(0, offset_next, 6, 6));
+    const Eigen::LDLT<Eigen::MatrixXd> H_oo_decomposition(H_oo);
+    if (H_oo_decomposition.info() != Eigen::Success || !H_oo_decomposition.isPositive()) {
+      return false;
+    }
+    information -= (H_on.transpose()*H_oo_decomposition.solve(H_on)).cast<real>();
+  }
+  information = (information+information.transpose())/2;
+  if (!information.allFinite()) {
+    return false;
+  }
+  information_next_ = information;
+  return true;
+}
+
 void GraphOptimizer::_setPoseEdge(g2o::OptimizableGraph* optimizer_,
                                   g2o::VertexSE3* vertex_from_,
                                   g2o::VertexSE3* vertex_to_,
@@ -458,6 +637,21 @@ void GraphOptimizer::_setPoseEdge(g2o::OptimizableGraph* optimizer_,
   optimizer_->addEdge(edge_pose);
 }
 
+void GraphOptimizer::_setClosureEdge(g2o::OptimizableGraph* optimizer_,
+                                     g2o::VertexSE3* vertex_query_,
+                                     const Closure::ClosureConstraint& closure_) const {
+
+  //ds compute information value (closure edges weight much more than pose edges to be able to deform the graph properly)
+  const real information_factor = _parameters->base_information_frame*closure_.omega*10;
+
+  //ds retrieve reference frame (must be present)
+  g2o::VertexSE3* vertex_reference = dynamic_cast<g2o::VertexSE3*>(optimizer_->vertex(closure_.local_map->identifier()));
+  assert(vertex_reference);
+
+  //ds introduce loop closure constraint between the two local maps
+  _setPoseEdge(optimizer_, vertex_query_, vertex_reference, closure_.relation, information_factor);
+}
+
 void GraphOptimizer::_setPointEdge(g2o::OptimizableGraph* optimizer_,
                                    g2o::VertexSE3* vertex_frame_,
                                    g2o::VertexPointXYZ* vertex_landmark_,
@@ -1,4 +1,5 @@
 #pragma once
+#include <deque>
 
 //ds g2o
 #include "g2o/core/optimizable_graph.h"
@@ -14,6 +15,7 @@
 
 //ds proslam
 #include "types/world_map.h"
+#include "types/thread_pool.h"
 #include "relocalization/closure.h"
 
 namespace proslam {
@@ -61,6 +63,11 @@ public:
   //! @param[in] frame_ the local map to add to the graph
   void addPose(LocalMap* frame_);
 
+  //! @brief adds a loop closure constraint for a local map that is already contained in the pose graph
+  //! @param[in] local_map_query_ the query local map of the closure (present in the graph)
+  //! @param[in] closure_ the closure constraint to a reference local map (present in the graph)
+  void addLoopClosure(LocalMap* local_map_query_, const Closure::ClosureConstraint& closure_);
+
   //! @brief adds a new frame to the factor graph with all connected landmarks
   //! @param[in] frame_ the frame to add including its captured landmarks
   void addPoseWithFactors(Frame* frame_);
@@ -73,10 +80,36 @@ public:
   //! @param[in] world_map_ map in which the optimization takes place
   void optimizeFactorGraph(WorldMap* world_map_);
 
+  //! @brief optimizes the active window of the factor graph, keyframes exceeding the window size are marginalized into a prior on the oldest remaining keyframe
+  //! @param[in] world_map_ map in which the optimization takes place
+  void optimizeSlidingWindow(WorldMap* world_map_);
+
 //ds getters/setters
 public:
 
   const Count numberOfOptimizations() const {return _number_of_optimizations;}
+  const Count numberOfMarginalizedFrames() const {return _number_of_marginalized_frames;}
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
+
+//ds helpers
+protected:
+
+  //! @brief writes the current landmark estimates of the graph back to the world map (landmarks freed in the meantime are skipped)
+  //! @param[in] world_map_ map holding the landmarks
+  void _updateLandmarks(WorldMap* world_map_);
+
+  //! @brief removes the oldest keyframe from the window and replaces its factors with a pose prior on the new oldest keyframe
+  void _marginalizeOldestFrame();
+
+  //! @brief computes the information the factors attached to the oldest keyframe carry onto the next keyframe (Schur complement
+  //! @brief of the oldest keyframe in the system of its own factors, correlations with landmarks are dropped)
+  //! @param[in] vertex_oldest_ keyframe to be marginalized
+  //! @param[in] vertex_next_ keyframe receiving the prior
+  //! @param[out] information_next_ information matrix of the prior (unchanged on failure)
+  //! @return true if the information could be computed
+  bool _computeMarginalizedInformation(g2o::VertexSE3* vertex_oldest_,
+                                       g2o::VertexSE3* vertex_next_,
+                                       Matrix6& information_next_) const;
 
 //ds g2o wrapper functions
 protected:
@@ -87,6 +120,10 @@ protected:
                     const TransformMatrix3D& transform_from_to_,
                     const real& information_factor_) const;
 
+  void _setClosureEdge(g2o::OptimizableGraph* optimizer_,
+                       g2o::VertexSE3* vertex_query_,
+                       const Closure::ClosureConstraint& closure_) const;
+
   void _setPointEdge(g2o::OptimizableGraph* optimizer_,
                      g2o::VertexSE3* vertex_frame_,
                      g2o::VertexPointXYZ* vertex_landmark_,
@@ -102,18 +139,28 @@ protected:
   //! @brief last frame vertex added (to be locked for optimization)
   g2o::VertexSE3* _vertex_local_map_last_added;
 
-  //! @brief bookkeeping: added frames
-  std::map<Frame*, g2o::VertexSE3*> _frames_in_pose_graph;
+  //! @brief bookkeeping: added frames (by frame identifier)
+  IdentifierMap<g2o::VertexSE3> _frames_in_pose_graph;
 
   //! @brief bookkeeping: added local maps
-  std::map<const Identifier, LocalMap*> _local_maps_in_graph;
+  IdentifierMap<LocalMap> _local_maps_in_graph;
+
+  //! @brief bookkeeping: added frames in order of addition (the active window for sliding window bundle adjustment)
+  std::deque<Frame*> _frames_in_window;
+
+  //! @brief bookkeeping: added landmarks (by identifier, landmarks might be freed by the world map in between optimizations)
+  IdentifierMap<g2o::VertexPointXYZ> _landmarks_in_pose_graph;
+
+  //! @brief added landmarks in identifier order (buffer for the parallel landmark update)
+  std::vector<std::pair<Identifier, g2o::VertexPointXYZ*>> _landmarks_to_update;
 
-  //! @brief bookkeeping: added landmarks
-  std::map<Landmark*, g2o::VertexPointXYZ*> _landmarks_in_pose_graph;
+  //! @brief shared thread pool for the landmark update after optimization (sequential update if not set)
+  ThreadPool* _thread_pool = nullptr;
 
   //ds informative only
   CREATE_CHRONOMETER(addition)
   CREATE_CHRONOMETER(optimization)
   Count _number_of_optimizations = 0;
+  Count _number_of_marginalized_frames = 0;
 };
 }
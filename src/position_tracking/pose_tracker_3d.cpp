@@ -35,6 +35,14 @@ void PoseTracker3D::compute() {
 
   //ds reset point configurations
   _number_of_tracked_points = 0;
+
+  //ds reset per-frame statistics
+  _number_of_recovered_points             = 0;
+  _number_of_created_points               = 0;
+  _number_of_pose_optimization_iterations = 0;
+  _pose_optimization_inlier_ratio         = 0;
+  _is_recovering                          = false;
+  _is_registered                          = false;
   _context->currentlyTrackedLandmarks().clear();
 
   //ds check if initial guess can be refined with a motion model or other input
@@ -76,8 +84,13 @@ void PoseTracker3D::compute() {
   //ds the new frame is automatically linked to the previous
   Frame* previous_frame = current_frame->previous();
 
-  //ds initialize framepoint generator (specific)
-  _framepoint_generator->initialize(current_frame);
+  //ds initialize framepoint generator (specific) - with the features extracted beforehand if available
+  if (_extracted_features) {
+    _framepoint_generator->initialize(current_frame, *_extracted_features);
+    _extracted_features = nullptr;
+  } else {
+    _framepoint_generator->initialize(current_frame);
+  }
 
   //ds if possible - attempt to track the points from the previous frame
   if (previous_frame) {
@@ -85,6 +98,18 @@ void PoseTracker3D::compute() {
     //ds see if we're tracking by appearance (expecting large photometric displacements between images)
     //ds always do it for the first 2 frames (repeats after track is lost)
     bool track_by_appearance = (_status == Frame::Localizing);
+    _motion_prediction       = _previous_to_current_camera;
+    _is_motion_predicted     = !track_by_appearance;
+    if (track_by_appearance) {
+      _beginRecovery();
+
+      //ds attempt to seed the motion with a global pose initialization - on success we track within the regular window
+      if (_parameters->enable_ransac_initialization &&
+          _parameters->motion_model != Parameters::MotionModel::CAMERA_ODOMETRY &&
+          _initializeMotionByAppearance(previous_frame, current_frame)) {
+        track_by_appearance = false;
+      }
+    }
 
     //ds search point tracks
     CHRONOMETER_START(tracking);
@@ -118,6 +143,7 @@ void PoseTracker3D::compute() {
       _pose_optimizer->parameters()->enable_inverse_depth_as_information = false;
       _pose_optimizer->initialize(previous_frame, current_frame, _previous_to_current_camera);
       _pose_optimizer->converge();
+      _updatePoseOptimizationStatistics();
       CHRONOMETER_STOP(pose_optimization);
 
       //ds if the pose computation result is not acceptable
@@ -138,6 +164,7 @@ void PoseTracker3D::compute() {
 
         //ds update motion estimate
         _previous_to_current_camera = previous_to_current_camera;
+        _is_registered              = true;
 
         //ds compute current robot pose
         const TransformMatrix3D camera_left_to_world = previous_frame->cameraLeftToWorld()*_previous_to_current_camera.inverse();
@@ -163,6 +190,14 @@ void PoseTracker3D::compute() {
     }
   }
 
+  //ds track recovery bookkeeping
+  if (_is_recovering) {
+    _recovery_duration_seconds += srrg_core::getTime()-_time_begin_recovery_seconds;
+    if (_is_registered) {
+      ++_number_of_successful_recoveries;
+    }
+  }
+
   //ds update context pose
   _context->setRobotToWorld(current_frame->robotToWorld());
 
@@ -175,8 +210,10 @@ void PoseTracker3D::compute() {
     //ds recover lost points based on refined pose
     if (_parameters->enable_landmark_recovery) {
       CHRONOMETER_START(point_recovery)
+      const Count number_of_points_before_recovery = current_frame->points().size();
       _framepoint_generator->recoverPoints(current_frame, _lost_points);
-      _number_of_tracked_points = current_frame->points().size();
+      _number_of_tracked_points   = current_frame->points().size();
+      _number_of_recovered_points = _number_of_tracked_points-number_of_points_before_recovery;
       CHRONOMETER_STOP(point_recovery)
     }
 
@@ -194,7 +231,9 @@ void PoseTracker3D::compute() {
 
   //ds compute remaining points in frame
   CHRONOMETER_START(track_creation)
+  const Count number_of_points_before_creation = current_frame->points().size();
   _framepoint_generator->compute(current_frame);
+  _number_of_created_points = current_frame->points().size()-number_of_points_before_creation;
   CHRONOMETER_STOP(track_creation)
   current_frame->setStatus(_status);
 
@@ -203,7 +242,8 @@ void PoseTracker3D::compute() {
   _total_number_of_tracked_points      += _number_of_tracked_points;
 
   //ds update stats
-  _mean_number_of_framepoints = (_mean_number_of_framepoints*(_context->frames().size()-1)+current_frame->points().size())/_context->frames().size();
+  const Count number_of_frames = _context->frames().size()+_context->numberOfEvictedFrames();
+  _mean_number_of_framepoints = (_mean_number_of_framepoints*(number_of_frames-1)+current_frame->points().size())/number_of_frames;
   _intensity_image_left.release();
   _image_secondary.release();
 }
@@ -223,6 +263,13 @@ void PoseTracker3D::_track(Frame* previous_frame_,
   //ds configure and track points in current frame
   _framepoint_generator->setProjectionTrackingDistancePixels(_projection_tracking_distance_pixels);
   _framepoint_generator->setMaximumDescriptorDistanceTracking(_current_descriptor_distance_tracking);
+
+  //ds shape the search regions by the motion prediction uncertainty once enough samples are available
+  if (!track_by_appearance_ && _number_of_motion_prediction_samples >= 10) {
+    _framepoint_generator->setMotionPredictionCovariance(_motion_prediction_covariance);
+  } else {
+    _framepoint_generator->resetMotionPredictionCovariance();
+  }
   _framepoint_generator->track(current_frame_, previous_frame_, _previous_to_current_camera, _lost_points, track_by_appearance_);
 
   //ds adjust bookkeeping
@@ -275,7 +322,8 @@ void PoseTracker3D::_track(Frame* previous_frame_,
   }
 
   //ds stats
-  _mean_tracking_ratio = (_context->frames().size()*_mean_tracking_ratio+_tracking_ratio)/(1+_context->frames().size());
+  const Count number_of_frames = _context->frames().size()+_context->numberOfEvictedFrames();
+  _mean_tracking_ratio = (number_of_frames*_mean_tracking_ratio+_tracking_ratio)/(1+number_of_frames);
 
   //ds update frame with current points
   _total_number_of_landmarks += _number_of_tracked_landmarks;
@@ -301,6 +349,15 @@ void PoseTracker3D::_registerRecursive(Frame* previous_frame_,
 
       //ds fallback to no motion model if no external info is available
       if (_parameters->motion_model != Parameters::MotionModel::CAMERA_ODOMETRY) {
+        _beginRecovery();
+
+        //ds attempt a global pose initialization first - on success a single tracking pass with the seeded motion is performed
+        if (recursion_ == 0 && _parameters->enable_ransac_initialization && _initializeMotionByAppearance(previous_frame_, current_frame_)) {
+          _framepoint_generator->initialize(current_frame_, false);
+          _track(previous_frame_, current_frame_);
+          _registerRecursive(previous_frame_, current_frame_, 2);
+          return;
+        }
         _previous_to_current_camera.setIdentity();
 
         //ds attempt tracking by appearance (maximum window size)
@@ -342,6 +399,7 @@ void PoseTracker3D::_registerRecursive(Frame* previous_frame_,
   _pose_optimizer->parameters()->enable_inverse_depth_as_information = true;
   _pose_optimizer->initialize(previous_frame_, current_frame_, _previous_to_current_camera);
   _pose_optimizer->converge();
+  _updatePoseOptimizationStatistics();
   CHRONOMETER_STOP(pose_optimization)
 
   //ds solver deltas
@@ -364,6 +422,12 @@ void PoseTracker3D::_registerRecursive(Frame* previous_frame_,
     //ds if the posit result is significant enough
     if (delta_angular > _parameters->minimum_delta_angular_for_movement || delta_translational > _parameters->minimum_delta_translational_for_movement) {
       _previous_to_current_camera = previous_to_current_camera;
+      _is_registered              = true;
+
+      //ds the motion model prediction was good enough for a direct registration - learn from its error
+      if (recursion_ == 0 && _is_motion_predicted) {
+        _updateMotionPredictionCovariance();
+      }
 
       //ds compute current robot pose
       const TransformMatrix3D camera_left_to_world = previous_frame_->cameraLeftToWorld()*_previous_to_current_camera.inverse();
@@ -380,6 +444,17 @@ void PoseTracker3D::_registerRecursive(Frame* previous_frame_,
     //ds if we have recursions left (currently only two)
     if (recursion_ < 2) {
 
+      //ds attempt a global pose initialization first - on success a single tracking pass with the seeded motion is performed
+      if (_parameters->motion_model != Parameters::MotionModel::CAMERA_ODOMETRY) {
+        _beginRecovery();
+        if (recursion_ == 0 && _parameters->enable_ransac_initialization && _initializeMotionByAppearance(previous_frame_, current_frame_)) {
+          _framepoint_generator->initialize(current_frame_, false);
+          _track(previous_frame_, current_frame_);
+          _registerRecursive(previous_frame_, current_frame_, 2);
+          return;
+        }
+      }
+
       //ds if we still can increase the tracking window size
       if (_projection_tracking_distance_pixels < _framepoint_generator->parameters()->maximum_projection_tracking_distance_pixels) {
         ++_projection_tracking_distance_pixels;
@@ -405,6 +480,155 @@ void PoseTracker3D::_registerRecursive(Frame* previous_frame_,
   }
 }
 
+void PoseTracker3D::_updatePoseOptimizationStatistics() {
+  _number_of_pose_optimization_iterations += _pose_optimizer->numberOfIterations();
+  _total_number_of_linearized_measurements += _pose_optimizer->numberOfIterations()*_pose_optimizer->numberOfCorrespondences();
+
+  //ds logarithmic iteration histogram
+  Index bin = 0;
+  while ((_pose_optimizer->numberOfIterations() >> (bin+1)) > 0) {
+    ++bin;
+  }
+  if (bin >= _pose_optimization_iteration_histogram.size()) {
+    _pose_optimization_iteration_histogram.resize(bin+1, 0);
+  }
+  ++_pose_optimization_iteration_histogram[bin];
+  if (_pose_optimizer->hasExceededTimeBudget()) {
+    ++_number_of_pose_optimization_timeouts;
+  }
+  if (_pose_optimizer->numberOfCorrespondences() > 0) {
+    _pose_optimization_inlier_ratio = _pose_optimizer->inlierRatio();
+  }
+}
+
+const bool PoseTracker3D::_initializeMotionByAppearance(Frame* previous_frame_,
+                                                       Frame* current_frame_) {
+  CHRONOMETER_START(motion_initialization)
+  ++_number_of_motion_initializations;
+  const FramePointPointerVector& points_previous     = previous_frame_->points();
+  const std::vector<cv::KeyPoint>& keypoints_current = current_frame_->keypointsLeft();
+  const cv::Mat& descriptors_current                 = current_frame_->descriptorsLeft();
+  const Count number_of_features_current             = std::min(keypoints_current.size(), static_cast<size_t>(descriptors_current.rows));
+
+  //ds match each previous point with measured depth to its nearest current feature in descriptor space (exhaustive, no motion prior)
+  std::vector<int32_t> matched_feature_indices(points_previous.size(), -1);
+  const std::function<void(const Index&)> match_point = [&](const Index& index_point_) {
+    const FramePoint* point_previous = points_previous[index_point_];
+    if (point_previous->hasUnreliableDepth()) {
+      return;
+    }
+    real descriptor_distance_best = _parameters->maximum_descriptor_distance_initialization;
+    for (Index index_feature = 0; index_feature < number_of_features_current; ++index_feature) {
+      const real descriptor_distance = DescriptorDistance::compute(point_previous->descriptorLeft().data(), descriptors_current.ptr<uint8_t>(index_feature));
+      if (descriptor_distance < descriptor_distance_best) {
+        descriptor_distance_best              = descriptor_distance;
+        matched_feature_indices[index_point_] = index_feature;
+      }
+    }
+  };
+  if (_thread_pool) {
+    _thread_pool->parallelFor(0, points_previous.size(), match_point, ThreadPool::Stage::TRACKING);
+  } else {
+    for (Index index_point = 0; index_point < points_previous.size(); ++index_point) {
+      match_point(index_point);
+    }
+  }
+
+  //ds collect 3D-2D correspondences - using the landmark position estimates where available
+  std::vector<cv::Point3f> points_in_camera_previous;
+  std::vector<cv::Point2f> points_in_image_current;
+  points_in_camera_previous.reserve(points_previous.size());
+  points_in_image_current.reserve(points_previous.size());
+  for (Index index_point = 0; index_point < points_previous.size(); ++index_point) {
+    if (matched_feature_indices[index_point] != -1) {
+      const FramePoint* point_previous       = points_previous[index_point];
+      const PointCoordinates point_in_camera = (point_previous->landmark())? point_previous->cameraCoordinatesLeftLandmark():
+                                                                             point_previous->cameraCoordinatesLeft();
+      points_in_camera_previous.push_back(cv::Point3f(point_in_camera.x(), point_in_camera.y(), point_in_camera.z()));
+      points_in_image_current.push_back(keypoints_current[matched_feature_indices[index_point]].pt);
+    }
+  }
+  if (points_in_camera_previous.size() < _parameters->minimum_number_of_inliers_initialization) {
+    LOG_DEBUG(std::cerr << "PoseTracker3D::_initializeMotionByAppearance|insufficient matches: " << points_in_camera_previous.size() << std::endl)
+    CHRONOMETER_STOP(motion_initialization)
+    return false;
+  }
+
+  //ds rectified images - no distortion
+  cv::Mat camera_matrix(3, 3, CV_64F);
+  for (Index row = 0; row < 3; ++row) {
+    for (Index col = 0; col < 3; ++col) {
+      camera_matrix.at<double>(row, col) = _camera_left->cameraMatrix()(row, col);
+    }
+  }
+
+  //ds minimal pose hypotheses in RANSAC, the best hypothesis is refined on its inliers
+  cv::Mat rotation_rodrigues;
+  cv::Mat translation;
+  std::vector<int32_t> inlier_indices;
+#if CV_MAJOR_VERSION == 2
+  //ds OpenCV 2 samples EPnP hypotheses (its P3P solver is limited to exactly 4 points)
+  cv::solvePnPRansac(points_in_camera_previous, points_in_image_current, camera_matrix, cv::Mat(), rotation_rodrigues, translation, false,
+                     _parameters->number_of_ransac_iterations_initialization,
+                     _parameters->maximum_reprojection_error_pixels_initialization,
+                     points_in_camera_previous.size(), inlier_indices, cv::EPNP);
+#elif CV_MAJOR_VERSION == 3
+  //ds P3P hypotheses (with EPnP refinement on the inliers) are supported in RANSAC since OpenCV 3.3
+#if CV_MINOR_VERSION >= 3
+  const int32_t solver = cv::SOLVEPNP_P3P;
+#else
+  const int32_t solver = cv::SOLVEPNP_EPNP;
+#endif
+  if (!cv::solvePnPRansac(points_in_camera_previous, points_in_image_current, camera_matrix, cv::Mat(), rotation_rodrigues, translation, false,
+                          _parameters->number_of_ransac_iterations_initialization,
+                          _parameters->maximum_reprojection_error_pixels_initialization,
+                          0.99, inlier_indices, solver)) {
+    inlier_indices.clear();
+  }
+#endif
+  if (inlier_indices.size() < _parameters->minimum_number_of_inliers_initialization) {
+    LOG_DEBUG(std::cerr << "PoseTracker3D::_initializeMotionByAppearance|insufficient inliers: " << inlier_indices.size()
+                        << "/" << points_in_camera_previous.size() << std::endl)
+    CHRONOMETER_STOP(motion_initialization)
+    return false;
+  }
+
+  //ds seed the motion estimate
+  cv::Mat rotation;
+  cv::Rodrigues(rotation_rodrigues, rotation);
+  _previous_to_current_camera.setIdentity();
+  for (Index row = 0; row < 3; ++row) {
+    for (Index col = 0; col < 3; ++col) {
+      _previous_to_current_camera.linear()(row, col) = rotation.at<double>(row, col);
+    }
+    _previous_to_current_camera.translation()(row) = translation.at<double>(row);
+  }
+  ++_number_of_successful_motion_initializations;
+  LOG_INFO(std::cerr << current_frame_->identifier() << "|PoseTracker3D::_initializeMotionByAppearance|inliers: " << inlier_indices.size()
+                     << "/" << points_in_camera_previous.size() << std::endl)
+  CHRONOMETER_STOP(motion_initialization)
+  return true;
+}
+
+void PoseTracker3D::_updateMotionPredictionCovariance() {
+
+  //ds prediction error as perturbation: refined = v2t(error)*prediction
+  const Vector6 error(srrg_core::t2v(_previous_to_current_camera*_motion_prediction.inverse()));
+
+  //ds running mean for the first samples, exponential moving average afterwards (follows changing motion characteristics)
+  ++_number_of_motion_prediction_samples;
+  const real weight = 1.0/std::min(_number_of_motion_prediction_samples, static_cast<Count>(10));
+  _motion_prediction_covariance += weight*(error*error.transpose()-_motion_prediction_covariance);
+}
+
+void PoseTracker3D::_beginRecovery() {
+  if (!_is_recovering) {
+    _is_recovering               = true;
+    _time_begin_recovery_seconds = srrg_core::getTime();
+    ++_number_of_recoveries;
+  }
+}
+
 //! @breaks the track at the current frame
 void PoseTracker3D::breakTrack(Frame* frame_) {
 
@@ -468,6 +692,8 @@ void PoseTracker3D::_updatePoints(WorldMap* context_, Frame* frame_) {
   //ds start landmark generation/update
   _context->currentlyTrackedLandmarks().reserve(_number_of_tracked_landmarks);
   _number_of_active_landmarks = 0;
+  _points_with_landmark.clear();
+  _is_landmark_updated.clear();
   for (FramePoint* point: frame_->points()) {
     point->setWorldCoordinates(robot_to_world*point->robotCoordinates());
 
@@ -479,21 +705,35 @@ void PoseTracker3D::_updatePoints(WorldMap* context_, Frame* frame_) {
     assert(point->previous());
 
     //ds check if the point is linked to a landmark (we can have holes in the framepoint chain for low confidence)
-    Landmark* landmark = point->origin()->landmark();
-
-    //ds if there's no landmark yet
-    if (!landmark) {
-
-      //ds create a landmark and associate it with the current framepoint
-      landmark = context_->createLandmark(point);
+    //ds if there's no landmark yet create a landmark and associate it with the current framepoint (modifies the map, hence sequential)
+    const bool has_landmark = (point->origin()->landmark() != nullptr);
+    if (!has_landmark) {
+      context_->createLandmark(point);
     }
+    _points_with_landmark.push_back(point);
+    _is_landmark_updated.push_back(has_landmark);
+  }
 
-    //ds otherwise update the landmark with the framepoint measurement
-    else {
+  //ds otherwise update the landmark with the framepoint measurement (every landmark is updated by a single framepoint)
+  const std::function<void(const Index&)> update_landmark = [&](const Index& index_) {
+    if (_is_landmark_updated[index_]) {
+      FramePoint* point = _points_with_landmark[index_];
 
       //ds update landmark position based on current point (triggered as we linked the landmark to the point)
-      landmark->update(point);
+      point->origin()->landmark()->update(point);
+    }
+  };
+  if (_thread_pool) {
+    _thread_pool->parallelFor(0, _points_with_landmark.size(), update_landmark, ThreadPool::Stage::TRACKING);
+  } else {
+    for (Index index = 0; index < _points_with_landmark.size(); ++index) {
+      update_landmark(index);
     }
+  }
+
+  //ds collect active landmarks in framepoint order
+  for (FramePoint* point: _points_with_landmark) {
+    Landmark* landmark = point->origin()->landmark();
 
     //ds lock current landmark position estimate to framepoint measurement, will be use for the subsequent frame registration
     point->setCameraCoordinatesLeftLandmark(frame_->worldToCameraLeft()*landmark->coordinates());
@@ -31,17 +31,45 @@ public:
   void setAligner(BaseFrameAligner* pose_optimizer_) {_pose_optimizer = pose_optimizer_;}
   void setFramePointGenerator(BaseFramePointGenerator * framepoint_generator_) {_framepoint_generator = framepoint_generator_;}
   void setWorldMap(WorldMap* context_) {_context = context_;}
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
   void setIntensityImageLeft(const cv::Mat& image_) {_intensity_image_left = image_;}
   void setImageSecondary(const cv::Mat& image_) {_image_secondary = image_;}
+
+  //! @brief sets features extracted beforehand for the images of the next compute call (pipelined processing), consumed by compute
+  void setExtractedFeatures(BaseFramePointGenerator::ExtractedFeatures* features_) {_extracted_features = features_;}
   BaseFrameAligner* aligner() {return _pose_optimizer;}
   void setMotionPreviousToCurrent(const TransformMatrix3D& motion_previous_to_current_) {_previous_to_current_camera = motion_previous_to_current_;}
   BaseFramePointGenerator* framepointGenerator() {return _framepoint_generator;}
   const BaseFramePointGenerator* framepointGenerator() const {return _framepoint_generator;}
   const Count totalNumberOfTrackedPoints() const {return _total_number_of_tracked_points;}
+  const Count totalNumberOfLinearizedMeasurements() const {return _total_number_of_linearized_measurements;}
+
+  //! @brief number of pose optimizations (alignments) per number of iterations: bin i counts alignments with [2^i, 2^(i+1)) iterations (bin 0: at most 1)
+  const std::vector<Count>& poseOptimizationIterationHistogram() const {return _pose_optimization_iteration_histogram;}
+
+  //! @brief number of pose optimizations stopped by the aligner time budget
+  const Count numberOfPoseOptimizationTimeouts() const {return _number_of_pose_optimization_timeouts;}
+
+  //! @brief global pose initialization (PnP RANSAC) statistics: attempts and attempts yielding a pose seed
+  const Count numberOfMotionInitializations() const {return _number_of_motion_initializations;}
+  const Count numberOfSuccessfulMotionInitializations() const {return _number_of_successful_motion_initializations;}
+
+  //! @brief track recovery statistics (localizing or failed registration): attempts, attempts ending with a registered pose and their total duration
+  const Count numberOfRecoveries() const {return _number_of_recoveries;}
+  const Count numberOfSuccessfulRecoveries() const {return _number_of_successful_recoveries;}
+  const double recoveryDurationSeconds() const {return _recovery_duration_seconds;}
   const Count totalNumberOfLandmarks() const {return _total_number_of_landmarks;}
   const real meanTrackingRatio() const {return _mean_tracking_ratio;}
   const real meanNumberOfFramepoints() const {return _mean_number_of_framepoints;}
 
+  //! @brief statistics of the last compute call
+  const Count numberOfTrackedPoints() const {return _number_of_tracked_points;}
+  const Count numberOfTrackedLandmarks() const {return _number_of_tracked_landmarks;}
+  const Count numberOfRecoveredPoints() const {return _number_of_recovered_points;}
+  const Count numberOfCreatedPoints() const {return _number_of_created_points;}
+  const Count numberOfPoseOptimizationIterations() const {return _number_of_pose_optimization_iterations;}
+  const real poseOptimizationInlierRatio() const {return _pose_optimization_inlier_ratio;}
+
 //ds helpers
 protected:
 
@@ -63,6 +91,23 @@ protected:
   //ds updates existing or creates new landmarks for framepoints of the provided frame
   void _updatePoints(WorldMap* context_, Frame* frame_);
 
+  //! @brief accumulates the iterations and retrieves the inlier ratio of the last pose optimization
+  void _updatePoseOptimizationStatistics();
+
+  //! @brief estimates the motion between previous and current frame without motion prior: P3P (OpenCV 3) or EPnP (OpenCV 2) in RANSAC
+  //! on exhaustive descriptor matches of the previous framepoints (landmark estimates where available) against the current features
+  //! @param [in] previous_frame_ the previous frame
+  //! @param [in] current_frame_ the current frame with initialized features
+  //! @return true if a motion with sufficient inliers was found, which is then set as _previous_to_current_camera
+  const bool _initializeMotionByAppearance(Frame* previous_frame_,
+                                           Frame* current_frame_);
+
+  //! @brief starts a track recovery for the current frame (no effect if already recovering)
+  void _beginRecovery();
+
+  //! @brief updates the motion prediction error covariance with the accepted motion estimate of the current frame
+  void _updateMotionPredictionCovariance();
+
   //! @brief resets the pose estimate to a fallback estimate
   //! depending on the selected motion model and/or additinal sensors (e.g. odometry)
   void _fallbackEstimate(Frame* current_frame_,
@@ -93,10 +138,20 @@ protected:
   cv::Mat _image_secondary;
   WorldMap* _context = nullptr;
 
+  //! @brief features of the current images extracted beforehand (pipelined processing only)
+  BaseFramePointGenerator::ExtractedFeatures* _extracted_features = nullptr;
+
   //gg processing objects
   BaseFrameAligner* _pose_optimizer              = nullptr;
   BaseFramePointGenerator* _framepoint_generator = nullptr;
 
+  //! @brief shared thread pool for landmark updates (sequential processing if not set)
+  ThreadPool* _thread_pool = nullptr;
+
+  //! @brief framepoints with landmarks of the current frame and whether their landmark is updated (buffers of _updatePoints)
+  FramePointPointerVector _points_with_landmark;
+  std::vector<bool> _is_landmark_updated;
+
   //! @brief position tracking bookkeeping: after optimization
   TransformMatrix3D _previous_to_current_camera = TransformMatrix3D::Identity();
 
@@ -112,6 +167,25 @@ protected:
   Count _number_of_recursive_registrations = 0;
   real _mean_number_of_framepoints = 0;
 
+  //! @brief per-frame statistics (reset by compute)
+  Count _number_of_recovered_points             = 0;
+  Count _number_of_created_points               = 0;
+  Count _number_of_pose_optimization_iterations = 0;
+  real _pose_optimization_inlier_ratio          = 0;
+
+  //! @brief track recovery state of the current frame: whether a recovery is ongoing, its start and whether the pose was registered
+  bool _is_recovering                 = false;
+  double _time_begin_recovery_seconds = 0;
+  bool _is_registered                 = false;
+
+  //! @brief motion prediction of the current frame (before any pose optimization) and whether it stems from the motion model
+  TransformMatrix3D _motion_prediction = TransformMatrix3D::Identity();
+  bool _is_motion_predicted            = false;
+
+  //! @brief running covariance of the motion prediction error (perturbation to the refined motion) for the tracking search regions
+  Matrix6 _motion_prediction_covariance      = Matrix6::Zero();
+  Count _number_of_motion_prediction_samples = 0;
+
 private:
 
   //ds informative only
@@ -120,8 +194,23 @@ private:
   CREATE_CHRONOMETER(pose_optimization)
   CREATE_CHRONOMETER(landmark_optimization)
   CREATE_CHRONOMETER(point_recovery)
+  CREATE_CHRONOMETER(motion_initialization)
   Count _total_number_of_tracked_points = 0;
   Count _total_number_of_landmarks      = 0;
+
+  //! @brief number of measurements linearized by the pose optimizer (correspondences times iterations) - for throughput only
+  Count _total_number_of_linearized_measurements = 0;
+
+  //! @brief pose optimization convergence statistics
+  std::vector<Count> _pose_optimization_iteration_histogram;
+  Count _number_of_pose_optimization_timeouts = 0;
+
+  //! @brief global pose initialization and track recovery statistics
+  Count _number_of_motion_initializations            = 0;
+  Count _number_of_successful_motion_initializations = 0;
+  Count _number_of_recoveries                        = 0;
+  Count _number_of_successful_recoveries             = 0;
+  double _recovery_duration_seconds                  = 0;
 };
 
 typedef std::shared_ptr<PoseTracker3D> PoseTracker3DPtr;
@@ -16,6 +16,8 @@ void Relocalizer::configure() {
   //ds allocate and configure aligner unit
   _aligner = XYZAlignerPtr(new XYZAligner(_parameters->aligner));
   _aligner->configure();
+  _aligners.clear();
+  _aligners.push_back(_aligner);
   LOG_INFO(std::cerr << "Relocalizer::configure|configured" << std::endl)
 }
 
@@ -36,12 +38,15 @@ void Relocalizer::detectClosures(LocalMap* local_map_query_) {
   //ds always add the entry (only matching is optional)
   _added_local_maps.push_back(local_map_query_);
   const Count number_of_query_matchables = local_map_query_->appearances().size();
+  _number_of_added_appearances += number_of_query_matchables;
 
   //ds if we are not yet in query range - only add matchables and nothing else to do
   if (_place_database.size() < _parameters->preliminary_minimum_interspace_queries) {
 
     //ds add matchables
+    CHRONOMETER_START(database_addition)
     _place_database.add(local_map_query_->appearances(), srrg_hbst::SplittingStrategy::SplitEven);
+    CHRONOMETER_STOP(database_addition)
     local_map_query_->appearances().clear();
   }
 
@@ -52,7 +57,10 @@ void Relocalizer::detectClosures(LocalMap* local_map_query_) {
     HBSTTree::MatchVectorMap matches_per_reference_image;
 
     //ds query database for current matchables and integrate current image simultaneously
+    CHRONOMETER_START(database_query)
     _place_database.matchAndAdd(local_map_query_->appearances(), matches_per_reference_image, _parameters->maximum_descriptor_distance);
+    CHRONOMETER_STOP(database_query)
+    ++_number_of_queries;
     local_map_query_->appearances().clear();
 
     //ds evaluate matches for each reference image in the range
@@ -138,32 +146,80 @@ void Relocalizer::detectClosures(LocalMap* local_map_query_) {
 
 #ifdef SRRG_MERGE_DESCRIPTORS
   //ds always check for absorbed matchables (we need to update our bookkeeping) of the last add call (this local map)
-  HBSTTree::MatchableMergeVector merges = _place_database.getMerges();
-  if (!merges.empty()) {
-
-    //ds evaluate each merge
-    for (HBSTTree::MatchableMerge& merge: merges) {
+  //ds the landmarks are updated in integrateAppearanceMerges
+  const HBSTTree::MatchableMergeVector& merges = _place_database.getMerges();
+  _appearance_merges.insert(_appearance_merges.end(), merges.begin(), merges.end());
+  LOG_DEBUG(std::cerr << "Relocalizer::detectClosures|merged appearances: " << merges.size()
+                      << " (" << static_cast<real>(merges.size())/number_of_query_matchables << ")" << std::endl)
+#endif
+  CHRONOMETER_STOP(overall)
+}
 
-      //ds the absorbed landmark must be contained in the merged objects for this local map ID by design
-      //ds recall that merge.query is already freed
-      Landmark* landmark = merge.query_object;
+void Relocalizer::add(LocalMap* local_map_) {
+  CHRONOMETER_START(overall)
 
-      //ds replace the matchable in the landmark list, note that the memory for query is already freed
-      landmark->replace(merge.query, merge.reference);
-    }
-    LOG_DEBUG(std::cerr << "Relocalizer::detectClosures|merged appearances: " << merges.size()
-                        << " (" << static_cast<real>(merges.size())/number_of_query_matchables << ")" << std::endl)
+  //ds the place database indexes references by local map identifier
+  if (local_map_->identifier() != _added_local_maps.size()) {
+    throw std::runtime_error("Relocalizer::add|local map identifier: "+std::to_string(local_map_->identifier())+
+                             " does not match place database index: "+std::to_string(_added_local_maps.size()));
   }
+  _added_local_maps.push_back(local_map_);
+  _number_of_added_appearances += local_map_->appearances().size();
+  _place_database.add(local_map_->appearances(), srrg_hbst::SplittingStrategy::SplitEven);
+  local_map_->appearances().clear();
+
+#ifdef SRRG_MERGE_DESCRIPTORS
+  const HBSTTree::MatchableMergeVector& merges = _place_database.getMerges();
+  _appearance_merges.insert(_appearance_merges.end(), merges.begin(), merges.end());
 #endif
   CHRONOMETER_STOP(overall)
 }
 
+void Relocalizer::integrateAppearanceMerges() {
+#ifdef SRRG_MERGE_DESCRIPTORS
+  CHRONOMETER_START(overall)
+
+  //ds evaluate each merge
+  for (HBSTTree::MatchableMerge& merge: _appearance_merges) {
+
+    //ds the absorbed landmark must be contained in the merged objects for this local map ID by design
+    //ds recall that merge.query is already freed
+    Landmark* landmark = merge.query_object;
+
+    //ds replace the matchable in the landmark list, note that the memory for query is already freed
+    landmark->replace(merge.query, merge.reference);
+  }
+  _appearance_merges.clear();
+  CHRONOMETER_STOP(overall)
+#endif
+}
+
 //ds geometric verification and determination of spatial relation between a set of closures
 void Relocalizer::registerClosures() {
   CHRONOMETER_START(overall)
-  for(Closure* closure: _closures) {
-    _aligner->initialize(closure);
-    _aligner->converge();
+
+  //ds closures are registered independently - distribute them over the shared thread pool with an aligner per participating thread
+  const Count number_of_aligners = (_thread_pool) ? std::min(_thread_pool->maximumParallelism(ThreadPool::Stage::RELOCALIZATION),
+                                                             static_cast<Count>(_closures.size())) : 1;
+  if (number_of_aligners > 1) {
+    while (_aligners.size() < number_of_aligners) {
+      XYZAlignerPtr aligner(new XYZAligner(_parameters->aligner));
+      aligner->configure();
+      _aligners.push_back(aligner);
+    }
+
+    //ds static assignment of closures to aligners (the registration results do not depend on the scheduling)
+    _thread_pool->parallelFor(0, number_of_aligners, [&](const Index& index_aligner_) {
+      for (Index index_closure = index_aligner_; index_closure < _closures.size(); index_closure += number_of_aligners) {
+        _aligners[index_aligner_]->initialize(_closures[index_closure]);
+        _aligners[index_aligner_]->converge();
+      }
+    }, ThreadPool::Stage::RELOCALIZATION);
+  } else {
+    for(Closure* closure: _closures) {
+      _aligner->initialize(closure);
+      _aligner->converge();
+    }
   }
   CHRONOMETER_STOP(overall)
 }
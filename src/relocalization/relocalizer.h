@@ -1,5 +1,6 @@
 #pragma once
 #include "aligners/xyz_aligner.h"
+#include "types/thread_pool.h"
 #include "closure.h"
 
 namespace proslam {
@@ -16,9 +17,18 @@ public:
   //ds retrieve loop closure candidates for the given local map, containing descriptors for its landmarks
   void detectClosures(LocalMap* local_map_query_);
 
+  //! @brief adds the appearances of a local map to the place database without querying it (e.g. for local maps of a loaded map)
+  //! @brief local maps have to be added in the order of their identifiers, call integrateAppearanceMerges afterwards
+  //! @param[in] local_map_ the local map to add
+  void add(LocalMap* local_map_);
+
   //ds geometric verification and determination of spatial relation between closure set
   void registerClosures();
 
+  //! @brief updates landmark appearances for descriptors merged in the place database during the last detectClosures call
+  //! @brief modifies landmarks: has to be called from the thread that owns the world map (e.g. tracking)
+  void integrateAppearanceMerges();
+
   //ds clear currently available closure buffer
   void clear();
 
@@ -30,6 +40,13 @@ public:
 
   inline const ClosurePointerVector& closures() const {return _closures;}
   XYZAlignerPtr aligner() {return _aligner;}
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
+
+  //! @brief number of appearances (HBST matchables) added to the place database
+  const Count& numberOfAddedAppearances() const {return _number_of_added_appearances;}
+
+  //! @brief number of place database queries (local maps matched against the database)
+  const Count& numberOfQueries() const {return _number_of_queries;}
 
 //ds helpers
 protected:
@@ -45,6 +62,12 @@ protected:
   //ds local map to local map alignment
   XYZAlignerPtr _aligner = nullptr;
 
+  //! @brief aligner units for parallel closure registration (the first one is _aligner)
+  std::vector<XYZAlignerPtr> _aligners;
+
+  //! @brief shared thread pool for closure registration (sequential registration if not set)
+  ThreadPool* _thread_pool = nullptr;
+
   //ds database of visited places (= local maps), storing a descriptor vector for each place
   HBSTTree _place_database;
 
@@ -54,9 +77,20 @@ protected:
   //ds correspondence retrieval buffer
   std::set<Identifier> _mask_id_references_for_correspondences;
 
+  //! @brief place database statistics (appearances are counted before a possible merge in the database)
+  Count _number_of_added_appearances = 0;
+  Count _number_of_queries           = 0;
+
+#ifdef SRRG_MERGE_DESCRIPTORS
+  //! @brief appearances merged in the place database that have not been integrated into the landmarks yet
+  HBSTTree::MatchableMergeVector _appearance_merges;
+#endif
+
 private:
 
   CREATE_CHRONOMETER(overall)
+  CREATE_CHRONOMETER(database_query)
+  CREATE_CHRONOMETER(database_addition)
 
 };
 }
@@ -0,0 +1,349 @@
+#include "dataset_reader.h"
+
+#include <fstream>
+#include <sstream>
+#include "yaml-cpp/yaml.h"
+
+namespace proslam {
+
+//ds removes trailing whitespace and carriage returns (e.g. of csv files with windows line endings)
+static std::string trim(const std::string& line_) {
+  const size_t end = line_.find_last_not_of(" \t\r\n");
+  return (end == std::string::npos) ? "" : line_.substr(0, end+1);
+}
+
+DatasetReader::DatasetReader(const CommandLineParameters* parameters_): _parameters(parameters_) {
+  LOG_INFO(std::cerr << "DatasetReader::DatasetReader|constructed" << std::endl)
+}
+
+DatasetReader::~DatasetReader() {
+  _image_pairs.clear();
+  _batch.clear();
+  LOG_INFO(std::cerr << "DatasetReader::~DatasetReader|destroyed" << std::endl)
+}
+
+DatasetReader* DatasetReader::create(const std::string& dataset_directory_, const CommandLineParameters* parameters_) {
+  if (srrg_core::isAccessible(dataset_directory_+"/calib.txt") && srrg_core::isAccessible(dataset_directory_+"/times.txt")) {
+    LOG_INFO(std::cerr << "DatasetReader::create|detected KITTI sequence: " << dataset_directory_ << std::endl)
+    return new KITTIDatasetReader(parameters_);
+  } else if (srrg_core::isAccessible(dataset_directory_+"/mav0/cam0/sensor.yaml") || srrg_core::isAccessible(dataset_directory_+"/cam0/sensor.yaml")) {
+    LOG_INFO(std::cerr << "DatasetReader::create|detected EuRoC sequence: " << dataset_directory_ << std::endl)
+    return new EuRoCDatasetReader(parameters_);
+  } else if (srrg_core::isAccessible(dataset_directory_+"/associations.txt") || srrg_core::isAccessible(dataset_directory_+"/associate.txt")) {
+    LOG_INFO(std::cerr << "DatasetReader::create|detected TUM RGB-D sequence: " << dataset_directory_ << std::endl)
+    return new TUMDatasetReader(parameters_);
+  }
+  return nullptr;
+}
+
+const bool DatasetReader::next(cv::Mat& image_left_, cv::Mat& image_right_, double& timestamp_seconds_) {
+
+  //ds decode the next batch if the current one is consumed
+  if (_index_in_batch >= _batch.size()) {
+    _decodeBatch();
+    if (_batch.empty()) {
+      return false;
+    }
+  }
+
+  //ds hand over the images (the batch does not keep references)
+  DecodedImagePair& decoded_image_pair = _batch[_index_in_batch];
+  image_left_        = decoded_image_pair.image_left;
+  image_right_       = decoded_image_pair.image_right;
+  timestamp_seconds_ = decoded_image_pair.timestamp_seconds;
+  decoded_image_pair.image_left.release();
+  decoded_image_pair.image_right.release();
+  ++_index_in_batch;
+  return true;
+}
+
+void DatasetReader::_decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const {
+  decoded_image_pair_.image_left        = _readImage(image_pair_.file_name_left, cv::IMREAD_GRAYSCALE);
+  decoded_image_pair_.image_right       = _readImage(image_pair_.file_name_right, cv::IMREAD_GRAYSCALE);
+  decoded_image_pair_.timestamp_seconds = image_pair_.timestamp_seconds;
+}
+
+void DatasetReader::_decodeBatch() {
+  const Count batch_size = std::max(_parameters->dataset_decoding_batch_size, Count(1));
+  const Count number_of_image_pairs = std::min(batch_size, static_cast<Count>(_image_pairs.size()-_index_next_batch));
+  _batch.resize(number_of_image_pairs);
+  _index_in_batch = 0;
+  if (number_of_image_pairs == 0) {
+    return;
+  }
+
+  //ds decode the pairs of the batch - either distributed over the shared thread pool or sequentially
+  const Index index_begin = _index_next_batch;
+  if (_thread_pool) {
+    _thread_pool->parallelFor(0, number_of_image_pairs, [&](const Index& index_) {
+      _decode(_image_pairs[index_begin+index_], _batch[index_]);
+    }, ThreadPool::Stage::DATASET_DECODING);
+  } else {
+    for (Index index = 0; index < number_of_image_pairs; ++index) {
+      _decode(_image_pairs[index_begin+index], _batch[index]);
+    }
+  }
+  _index_next_batch += number_of_image_pairs;
+}
+
+void DatasetReader::_setStereoCameras(const Count& number_of_image_rows_,
+                                      const Count& number_of_image_cols_,
+                                      const CameraMatrix& camera_matrix_,
+                                      const real& baseline_meters_) {
+  if (baseline_meters_ <= 0) {
+    throw std::runtime_error("DatasetReader::_setStereoCameras|invalid stereo baseline: "+std::to_string(baseline_meters_));
+  }
+
+  //ds left camera defines the robot frame
+  ProjectionMatrix projection_matrix(ProjectionMatrix::Zero());
+  projection_matrix.block<3,3>(0,0) = camera_matrix_;
+  _camera_left = new Camera(number_of_image_rows_, number_of_image_cols_, camera_matrix_);
+  _camera_left->setProjectionMatrix(projection_matrix);
+
+  //ds right camera with baseline offset (as reconstructed for txt_io message files)
+  TransformMatrix3D camera_right_to_robot(TransformMatrix3D::Identity());
+  camera_right_to_robot.translation() = Vector3(baseline_meters_, 0, 0);
+  _camera_right = new Camera(number_of_image_rows_, number_of_image_cols_, camera_matrix_, camera_right_to_robot);
+  projection_matrix.block<3,1>(0,3) = camera_matrix_*_camera_right->robotToCamera().translation();
+  _camera_right->setProjectionMatrix(projection_matrix);
+  _camera_right->setBaselineHomogeneous(projection_matrix.col(3));
+  LOG_INFO(std::cerr << "DatasetReader::_setStereoCameras|image resolution: " << number_of_image_cols_ << "x" << number_of_image_rows_
+                     << " baseline: " << baseline_meters_ << "m" << std::endl)
+}
+
+cv::Mat DatasetReader::_readImage(const std::string& file_name_, const int32_t& flags_) {
+  cv::Mat image = cv::imread(file_name_, flags_);
+  if (image.empty()) {
+    throw std::runtime_error("DatasetReader::_readImage|unable to read image: "+file_name_);
+  }
+  return image;
+}
+
+void KITTIDatasetReader::open(const std::string& dataset_directory_) {
+  if (_parameters->tracker_mode != CommandLineParameters::TrackerMode::RGB_STEREO) {
+    throw std::runtime_error("KITTIDatasetReader::open|KITTI sequences require stereo tracking");
+  }
+
+  //ds parse grayscale camera projection matrices (P0: left, P1: right)
+  std::ifstream calibration_file(dataset_directory_+"/calib.txt");
+  ProjectionMatrix projection_matrix_left(ProjectionMatrix::Zero());
+  ProjectionMatrix projection_matrix_right(ProjectionMatrix::Zero());
+  std::string line;
+  while (std::getline(calibration_file, line)) {
+    std::istringstream stream(line);
+    std::string key;
+    stream >> key;
+    ProjectionMatrix* projection_matrix = nullptr;
+    if (key == "P0:") {
+      projection_matrix = &projection_matrix_left;
+    } else if (key == "P1:") {
+      projection_matrix = &projection_matrix_right;
+    } else {
+      continue;
+    }
+    for (Index row = 0; row < 3; ++row) {
+      for (Index col = 0; col < 4; ++col) {
+        stream >> (*projection_matrix)(row, col);
+      }
+    }
+  }
+  if (projection_matrix_left(0,0) == 0 || projection_matrix_right(0,0) == 0) {
+    throw std::runtime_error("KITTIDatasetReader::open|unable to parse P0/P1 from: "+dataset_directory_+"/calib.txt");
+  }
+
+  //ds image list from timestamps (image_0: left, image_1: right)
+  std::ifstream timestamps_file(dataset_directory_+"/times.txt");
+  double timestamp_seconds = 0;
+  char file_name[32];
+  while (timestamps_file >> timestamp_seconds) {
+    std::snprintf(file_name, sizeof(file_name), "%06lu.png", static_cast<unsigned long>(_image_pairs.size()));
+    _image_pairs.push_back(ImagePair({timestamp_seconds,
+                                      dataset_directory_+"/image_0/"+file_name,
+                                      dataset_directory_+"/image_1/"+file_name}));
+  }
+  if (_image_pairs.empty()) {
+    throw std::runtime_error("KITTIDatasetReader::open|no timestamps in: "+dataset_directory_+"/times.txt");
+  }
+
+  //ds the image resolution is not part of the calibration
+  const cv::Mat image = _readImage(_image_pairs.front().file_name_left, cv::IMREAD_GRAYSCALE);
+  _setStereoCameras(image.rows, image.cols,
+                    projection_matrix_left.block<3,3>(0,0),
+                    -projection_matrix_right(0,3)/projection_matrix_right(0,0));
+  LOG_INFO(std::cerr << "KITTIDatasetReader::open|image pairs: " << _image_pairs.size() << std::endl)
+}
+
+//ds parses camera calibration and image list of a single EuRoC camera
+static void readEuRoCCamera(const std::string& camera_directory_,
+                            cv::Mat& camera_matrix_,
+                            cv::Mat& distortion_coefficients_,
+                            cv::Mat& camera_to_body_,
+                            cv::Size& image_size_,
+                            std::map<uint64_t, std::string>& images_) {
+  const YAML::Node sensor = YAML::LoadFile(camera_directory_+"/sensor.yaml");
+  const YAML::Node intrinsics = sensor["intrinsics"];
+  const YAML::Node distortion = sensor["distortion_coefficients"];
+  const YAML::Node resolution = sensor["resolution"];
+  const YAML::Node transform  = sensor["T_BS"]["data"];
+  if (intrinsics.size() != 4 || distortion.size() != 4 || resolution.size() != 2 || transform.size() != 16) {
+    throw std::runtime_error("readEuRoCCamera|invalid sensor configuration: "+camera_directory_+"/sensor.yaml");
+  }
+  camera_matrix_ = cv::Mat::eye(3, 3, CV_64F);
+  camera_matrix_.at<double>(0,0) = intrinsics[0].as<double>();
+  camera_matrix_.at<double>(1,1) = intrinsics[1].as<double>();
+  camera_matrix_.at<double>(0,2) = intrinsics[2].as<double>();
+  camera_matrix_.at<double>(1,2) = intrinsics[3].as<double>();
+  distortion_coefficients_ = cv::Mat::zeros(1, 4, CV_64F);
+  for (Index u = 0; u < 4; ++u) {
+    distortion_coefficients_.at<double>(u) = distortion[u].as<double>();
+  }
+  camera_to_body_ = cv::Mat::zeros(4, 4, CV_64F);
+  for (Index u = 0; u < 16; ++u) {
+    camera_to_body_.at<double>(u/4, u%4) = transform[u].as<double>();
+  }
+  image_size_ = cv::Size(resolution[0].as<int32_t>(), resolution[1].as<int32_t>());
+
+  //ds image list: timestamp [ns], file name
+  std::ifstream image_list(camera_directory_+"/data.csv");
+  std::string line;
+  while (std::getline(image_list, line)) {
+    line = trim(line);
+    const size_t separator = line.find(',');
+    if (line.empty() || line[0] == '#' || separator == std::string::npos) {
+      continue;
+    }
+    images_.insert(std::make_pair(std::stoull(line.substr(0, separator)), camera_directory_+"/data/"+line.substr(separator+1)));
+  }
+}
+
+void EuRoCDatasetReader::open(const std::string& dataset_directory_) {
+  if (_parameters->tracker_mode != CommandLineParameters::TrackerMode::RGB_STEREO) {
+    throw std::runtime_error("EuRoCDatasetReader::open|EuRoC sequences require stereo tracking");
+  }
+  const std::string root_directory = (srrg_core::isAccessible(dataset_directory_+"/mav0/cam0/sensor.yaml")) ? dataset_directory_+"/mav0" : dataset_directory_;
+
+  //ds parse both cameras
+  cv::Mat camera_matrix_left, camera_matrix_right;
+  cv::Mat distortion_coefficients_left, distortion_coefficients_right;
+  cv::Mat camera_left_to_body, camera_right_to_body;
+  cv::Size image_size_left, image_size_right;
+  std::map<uint64_t, std::string> images_left, images_right;
+  readEuRoCCamera(root_directory+"/cam0", camera_matrix_left, distortion_coefficients_left, camera_left_to_body, image_size_left, images_left);
+  readEuRoCCamera(root_directory+"/cam1", camera_matrix_right, distortion_coefficients_right, camera_right_to_body, image_size_right, images_right);
+  if (image_size_left != image_size_right) {
+    throw std::runtime_error("EuRoCDatasetReader::open|mismatching image resolutions");
+  }
+
+  //ds pair images with identical timestamps (the cameras are hardware synchronized)
+  for (const std::pair<const uint64_t, std::string>& image_left: images_left) {
+    const std::map<uint64_t, std::string>::const_iterator image_right = images_right.find(image_left.first);
+    if (image_right != images_right.end()) {
+      _image_pairs.push_back(ImagePair({image_left.first*1e-9, image_left.second, image_right->second}));
+    }
+  }
+  if (_image_pairs.empty()) {
+    throw std::runtime_error("EuRoCDatasetReader::open|no synchronized images in: "+root_directory);
+  }
+
+  //ds relative transform from left to right camera
+  const cv::Mat camera_left_to_right = camera_right_to_body.inv()*camera_left_to_body;
+  const cv::Mat rotation_left_to_right    = camera_left_to_right(cv::Rect(0, 0, 3, 3)).clone();
+  const cv::Mat translation_left_to_right = camera_left_to_right(cv::Rect(3, 0, 1, 3)).clone();
+
+  //ds compute rectification and the undistortion/rectification maps
+  cv::Mat rectification_left, rectification_right;
+  cv::Mat projection_left, projection_right;
+  cv::Mat disparity_to_depth;
+  cv::stereoRectify(camera_matrix_left, distortion_coefficients_left,
+                    camera_matrix_right, distortion_coefficients_right,
+                    image_size_left,
+                    rotation_left_to_right, translation_left_to_right,
+                    rectification_left, rectification_right,
+                    projection_left, projection_right,
+                    disparity_to_depth,
+                    cv::CALIB_ZERO_DISPARITY, 0);
+  cv::initUndistortRectifyMap(camera_matrix_left, distortion_coefficients_left,
+                              rectification_left, projection_left,
+                              image_size_left, CV_16SC2,
+                              _undistort_rectify_maps_left[0], _undistort_rectify_maps_left[1]);
+  cv::initUndistortRectifyMap(camera_matrix_right, distortion_coefficients_right,
+                              rectification_right, projection_right,
+                              image_size_right, CV_16SC2,
+                              _undistort_rectify_maps_right[0], _undistort_rectify_maps_right[1]);
+
+  //ds set rectified cameras
+  CameraMatrix camera_matrix(CameraMatrix::Identity());
+  for (Index row = 0; row < 3; ++row) {
+    for (Index col = 0; col < 3; ++col) {
+      camera_matrix(row, col) = projection_left.at<double>(row, col);
+    }
+  }
+  _setStereoCameras(image_size_left.height, image_size_left.width,
+                    camera_matrix,
+                    -projection_right.at<double>(0,3)/projection_right.at<double>(0,0));
+  LOG_INFO(std::cerr << "EuRoCDatasetReader::open|image pairs: " << _image_pairs.size() << std::endl)
+}
+
+void EuRoCDatasetReader::_decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const {
+  cv::remap(_readImage(image_pair_.file_name_left, cv::IMREAD_GRAYSCALE), decoded_image_pair_.image_left,
+            _undistort_rectify_maps_left[0], _undistort_rectify_maps_left[1], cv::INTER_LINEAR);
+  cv::remap(_readImage(image_pair_.file_name_right, cv::IMREAD_GRAYSCALE), decoded_image_pair_.image_right,
+            _undistort_rectify_maps_right[0], _undistort_rectify_maps_right[1], cv::INTER_LINEAR);
+  decoded_image_pair_.timestamp_seconds = image_pair_.timestamp_seconds;
+}
+
+void TUMDatasetReader::open(const std::string& dataset_directory_) {
+  if (_parameters->tracker_mode != CommandLineParameters::TrackerMode::RGB_DEPTH) {
+    throw std::runtime_error("TUMDatasetReader::open|TUM RGB-D sequences require depth tracking (-depth-mode)");
+  }
+
+  //ds image list: timestamp rgb file timestamp depth file (output of the TUM associate.py script)
+  const std::string file_name_associations = (srrg_core::isAccessible(dataset_directory_+"/associations.txt")) ?
+                                             dataset_directory_+"/associations.txt" : dataset_directory_+"/associate.txt";
+  std::ifstream associations_file(file_name_associations);
+  std::string line;
+  while (std::getline(associations_file, line)) {
+    line = trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream stream(line);
+    double timestamp_seconds_rgb = 0;
+    double timestamp_seconds_depth = 0;
+    std::string file_name_rgb, file_name_depth;
+    if (stream >> timestamp_seconds_rgb >> file_name_rgb >> timestamp_seconds_depth >> file_name_depth) {
+      _image_pairs.push_back(ImagePair({timestamp_seconds_rgb, dataset_directory_+"/"+file_name_rgb, dataset_directory_+"/"+file_name_depth}));
+    }
+  }
+  if (_image_pairs.empty()) {
+    throw std::runtime_error("TUMDatasetReader::open|no associations in: "+file_name_associations);
+  }
+
+  //ds factory calibration of the sensor (the sequences provide no calibration file)
+  CameraMatrix camera_matrix(CameraMatrix::Identity());
+  if (dataset_directory_.find("freiburg1") != std::string::npos) {
+    camera_matrix << 517.3, 0, 318.6, 0, 516.5, 255.3, 0, 0, 1;
+  } else if (dataset_directory_.find("freiburg2") != std::string::npos) {
+    camera_matrix << 520.9, 0, 325.1, 0, 521.0, 249.7, 0, 0, 1;
+  } else if (dataset_directory_.find("freiburg3") != std::string::npos) {
+    camera_matrix << 535.4, 0, 320.1, 0, 539.2, 247.6, 0, 0, 1;
+  } else {
+    LOG_WARNING(std::cerr << "TUMDatasetReader::open|unable to determine sensor from directory name - using default calibration" << std::endl)
+    camera_matrix << 525.0, 0, 319.5, 0, 525.0, 239.5, 0, 0, 1;
+  }
+
+  //ds registered depth: identical cameras
+  const cv::Mat image = _readImage(_image_pairs.front().file_name_left, cv::IMREAD_GRAYSCALE);
+  _camera_left  = new Camera(image.rows, image.cols, camera_matrix);
+  _camera_right = new Camera(image.rows, image.cols, camera_matrix);
+  LOG_INFO(std::cerr << "TUMDatasetReader::open|image pairs: " << _image_pairs.size() << std::endl)
+}
+
+void TUMDatasetReader::_decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const {
+  decoded_image_pair_.image_left = _readImage(image_pair_.file_name_left, cv::IMREAD_GRAYSCALE);
+
+  //ds convert depth from 1/5000 meters to millimeters (as in the txt_io conversions)
+  _readImage(image_pair_.file_name_right, cv::IMREAD_UNCHANGED).convertTo(decoded_image_pair_.image_right, CV_16UC1, 0.2);
+  decoded_image_pair_.timestamp_seconds = image_pair_.timestamp_seconds;
+}
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include "types/camera.h"
+#include "types/thread_pool.h"
+
+namespace proslam {
+
+//! @class base class for native dataset directory readers: parses calibration and image lists, decodes images in batches on the shared thread pool
+//! @class images are provided rectified and undistorted, the cameras are configured like the ones loaded from a txt_io message file
+class DatasetReader {
+
+//ds object management
+public: EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! @brief constructor
+  //! @param[in] parameters_ command line parameters (tracker mode and decoding batch size)
+  DatasetReader(const CommandLineParameters* parameters_);
+
+  //! @brief destructor - the cameras are not freed (ownership is passed with cameraLeft/cameraRight)
+  virtual ~DatasetReader();
+
+  //! @brief prohibit default construction
+  DatasetReader() = delete;
+
+//ds exported types
+public:
+
+  //! @brief a single entry of the image list (decoded on demand)
+  struct ImagePair {
+    double timestamp_seconds;
+    std::string file_name_left;
+    std::string file_name_right;
+  };
+
+  //! @brief a decoded image pair
+  struct DecodedImagePair {
+    cv::Mat image_left;
+    cv::Mat image_right;
+    double timestamp_seconds = 0;
+  };
+
+//ds interface
+public:
+
+  //! @brief allocates a reader matching the layout of the provided directory
+  //! @param[in] dataset_directory_ KITTI sequence (calib.txt, times.txt), EuRoC (mav0 or cam0/cam1 with sensor.yaml and data.csv) or TUM RGB-D sequence (associations.txt)
+  //! @param[in] parameters_ command line parameters
+  //! @return the reader or nullptr if the directory layout is not recognized (e.g. for a txt_io message file)
+  static DatasetReader* create(const std::string& dataset_directory_, const CommandLineParameters* parameters_);
+
+  //! @brief parses calibration and image list and creates the cameras (throws on failure)
+  //! @param[in] dataset_directory_ dataset root directory
+  virtual void open(const std::string& dataset_directory_) = 0;
+
+  //! @brief retrieves the next image pair, the next batch of images is decoded in parallel once the current batch is consumed
+  //! @param[out] image_left_ left intensity image
+  //! @param[out] image_right_ right intensity image (stereo) or depth image (depth)
+  //! @param[out] timestamp_seconds_ left image timestamp
+  //! @return false if the dataset is exhausted
+  const bool next(cv::Mat& image_left_, cv::Mat& image_right_, double& timestamp_seconds_);
+
+//ds getters/setters
+public:
+
+  void setThreadPool(ThreadPool* thread_pool_) {_thread_pool = thread_pool_;}
+  Camera* cameraLeft() const {return _camera_left;}
+  Camera* cameraRight() const {return _camera_right;}
+  const Count numberOfImagePairs() const {return _image_pairs.size();}
+
+//ds helpers
+protected:
+
+  //! @brief decodes a single image pair (called concurrently for the pairs of a batch)
+  //! @param[in] image_pair_ the pair to decode
+  //! @param[out] decoded_image_pair_ decoded (and rectified) images
+  virtual void _decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const;
+
+  //! @brief decodes the next batch of image pairs in parallel
+  void _decodeBatch();
+
+  //! @brief sets stereo cameras for rectified images with a horizontal baseline (robot frame = left camera frame)
+  //! @param[in] number_of_image_rows_ image height
+  //! @param[in] number_of_image_cols_ image width
+  //! @param[in] camera_matrix_ rectified camera matrix
+  //! @param[in] baseline_meters_ horizontal distance between the camera centers
+  void _setStereoCameras(const Count& number_of_image_rows_,
+                         const Count& number_of_image_cols_,
+                         const CameraMatrix& camera_matrix_,
+                         const real& baseline_meters_);
+
+  //! @brief loads an image or throws
+  static cv::Mat _readImage(const std::string& file_name_, const int32_t& flags_);
+
+//ds attributes
+protected:
+
+  //! @brief image list of the dataset
+  std::vector<ImagePair> _image_pairs;
+
+  //! @brief index of the next image pair to decode
+  Index _index_next_batch = 0;
+
+  //! @brief currently decoded batch and its next pair to provide
+  std::vector<DecodedImagePair> _batch;
+  Index _index_in_batch = 0;
+
+  //! @brief cameras created by open
+  Camera* _camera_left  = nullptr;
+  Camera* _camera_right = nullptr;
+
+  //! @brief shared thread pool for batch decoding (sequential decoding if not set)
+  ThreadPool* _thread_pool = nullptr;
+
+  //! @brief configurable parameters
+  const CommandLineParameters* _parameters;
+};
+
+//! @class KITTI odometry sequence: grayscale stereo images image_0/image_1, projection matrices P0/P1 in calib.txt and timestamps in times.txt
+class KITTIDatasetReader: public DatasetReader {
+public:
+  KITTIDatasetReader(const CommandLineParameters* parameters_): DatasetReader(parameters_) {}
+  virtual void open(const std::string& dataset_directory_);
+};
+
+//! @class EuRoC MAV sequence: raw stereo images cam0/cam1 with sensor.yaml (intrinsics, distortion, extrinsics) and data.csv image lists
+//! @class images are undistorted and rectified after decoding
+class EuRoCDatasetReader: public DatasetReader {
+public:
+  EuRoCDatasetReader(const CommandLineParameters* parameters_): DatasetReader(parameters_) {}
+  virtual void open(const std::string& dataset_directory_);
+protected:
+  virtual void _decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const;
+
+  //! @brief undistortion and rectification maps for left and right camera
+  cv::Mat _undistort_rectify_maps_left[2];
+  cv::Mat _undistort_rectify_maps_right[2];
+};
+
+//! @class TUM RGB-D sequence: rgb and depth images listed in an association file (associations.txt or associate.txt)
+//! @class the intrinsics are selected from the sensor name in the directory name (freiburg1/2/3), depth is provided in millimeters
+class TUMDatasetReader: public DatasetReader {
+public:
+  TUMDatasetReader(const CommandLineParameters* parameters_): DatasetReader(parameters_) {}
+  virtual void open(const std::string& dataset_directory_);
+protected:
+  virtual void _decode(const ImagePair& image_pair_, DecodedImagePair& decoded_image_pair_) const;
+};
+}
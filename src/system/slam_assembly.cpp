@@ -6,8 +6,14 @@
 #include "aligners/stereouv_aligner.h"
 #include "aligners/uvd_aligner.h"
 
+#include <fstream>
+#include <numeric>
+#include <sys/resource.h>
+#include <unistd.h>
+
 namespace proslam {
 SLAMAssembly::SLAMAssembly(ParameterCollection* parameters_): _parameters(parameters_),
+                                                              _thread_pool(new ThreadPool(_parameters->thread_pool_parameters)),
                                                               _world_map(new WorldMap(_parameters->world_map_parameters)),
                                                               _graph_optimizer(new GraphOptimizer(_parameters->graph_optimizer_parameters)),
                                                               _relocalizer(new Relocalizer(_parameters->relocalizer_parameters)),
@@ -25,6 +31,12 @@ SLAMAssembly::SLAMAssembly(ParameterCollection* parameters_): _parameters(parame
   _processing_times_seconds.clear();
   _tracker->setWorldMap(_world_map);
 
+  //ds start the shared thread pool and pass it to all modules
+  _thread_pool->configure();
+  _tracker->setThreadPool(_thread_pool);
+  _relocalizer->setThreadPool(_thread_pool);
+  _graph_optimizer->setThreadPool(_thread_pool);
+
   //ds reset all static object counters
   Frame::reset();
   FramePoint::reset();
@@ -35,14 +47,20 @@ SLAMAssembly::SLAMAssembly(ParameterCollection* parameters_): _parameters(parame
 
 SLAMAssembly::~SLAMAssembly() {
   LOG_INFO(std::cerr << "SLAMAssembly::~SLAMAssembly|destroying assembly" << std::endl)
+  _stopPrefetchThread();
+  _stopRelocalizationThread();
   delete _tracker;
   delete _graph_optimizer;
   delete _relocalizer;
   delete _world_map;
   delete _camera_left;
   delete _camera_right;
+  delete _dataset_reader;
   _message_reader.close();
   _synchronizer.reset();
+
+  //ds the thread pool is released after all modules that use it
+  delete _thread_pool;
   LOG_INFO(std::cerr << "SLAMAssembly::~SLAMAssembly|destroyed" << std::endl)
 }
 
@@ -62,12 +80,14 @@ void SLAMAssembly::_createStereoTracker(Camera* camera_left_, Camera* camera_rig
   StereoFramePointGenerator* framepoint_generator = new StereoFramePointGenerator(_parameters->stereo_framepoint_generator_parameters);
   framepoint_generator->setCameraLeft(camera_left_);
   framepoint_generator->setCameraRight(camera_right_);
+  framepoint_generator->setThreadPool(_thread_pool);
   framepoint_generator->configure();
 
   //ds allocate and configure the aligner for motion estimation
   StereoUVAligner* pose_optimizer = new StereoUVAligner(_parameters->tracker_parameters->aligner);
   pose_optimizer->setMaximumReliableDepthMeters(_parameters->stereo_framepoint_generator_parameters->maximum_reliable_depth_meters);
   pose_optimizer->setMinimumReliableDepthMeters(_parameters->stereo_framepoint_generator_parameters->minimum_depth_meters);
+  pose_optimizer->setThreadPool(_thread_pool);
   pose_optimizer->configure();
 
   //ds configure the tracker
@@ -82,12 +102,14 @@ void SLAMAssembly::_createDepthTracker(Camera* camera_left_, Camera* camera_righ
   DepthFramePointGenerator* framepoint_generator = new DepthFramePointGenerator(_parameters->depth_framepoint_generator_parameters);
   framepoint_generator->setCameraLeft(camera_left_);
   framepoint_generator->setCameraRight(camera_right_);
+  framepoint_generator->setThreadPool(_thread_pool);
   framepoint_generator->configure();
 
   //ds allocate and configure the aligner for motion estimation
   UVDAligner* pose_optimizer = new UVDAligner(_parameters->tracker_parameters->aligner);
   pose_optimizer->setMaximumReliableDepthMeters(_parameters->depth_framepoint_generator_parameters->maximum_reliable_depth_meters);
   pose_optimizer->setMinimumReliableDepthMeters(_parameters->depth_framepoint_generator_parameters->minimum_depth_meters);
+  pose_optimizer->setThreadPool(_thread_pool);
   pose_optimizer->configure();
 
   //ds configure the tracker
@@ -96,6 +118,25 @@ void SLAMAssembly::_createDepthTracker(Camera* camera_left_, Camera* camera_righ
   _tracker->configure();
 }
 
+void SLAMAssembly::loadCamerasFromDataset() {
+  const double time_begin_seconds = srrg_core::getTime();
+
+  //ds check for a native dataset directory - otherwise we expect a message file
+  _dataset_reader = DatasetReader::create(_parameters->command_line_parameters->dataset_file_name, _parameters->command_line_parameters);
+  if (!_dataset_reader) {
+    loadCamerasFromMessageFile();
+  } else {
+
+    //ds parse calibration and image lists (no images are decoded besides the first one)
+    _dataset_reader->setThreadPool(_thread_pool);
+    _dataset_reader->open(_parameters->command_line_parameters->dataset_file_name);
+    _camera_left  = _dataset_reader->cameraLeft();
+    _camera_right = _dataset_reader->cameraRight();
+    loadCameras(_camera_left, _camera_right);
+  }
+  LOG_INFO(std::cerr << "SLAMAssembly::loadCamerasFromDataset|startup time: " << srrg_core::getTime()-time_begin_seconds << "s" << std::endl)
+}
+
 void SLAMAssembly::loadCamerasFromMessageFile() {
 
   //ds configure sensor message source
@@ -237,6 +278,9 @@ void SLAMAssembly::loadCameras(Camera* camera_left_, Camera* camera_right_) {
   //ds configure remaining components
   _graph_optimizer->configure();
   _relocalizer->configure();
+
+  //ds launch relocalization in the background if desired
+  _startRelocalizationThread();
 }
 
 void SLAMAssembly::initializeGUI(std::shared_ptr<QApplication> ui_server_) {
@@ -334,6 +378,38 @@ void SLAMAssembly::draw() {
   }
 }
 
+void SLAMAssembly::loadMap(const std::string& file_name_) {
+  if (!_camera_left || !_camera_right) {
+    throw std::runtime_error("SLAMAssembly::loadMap|cameras have to be loaded before a map");
+  }
+  const double time_begin_seconds = srrg_core::getTime();
+  _world_map->read(file_name_);
+
+  //ds loaded frames carry no framepoints but are linked to the current cameras (visualization)
+  for (const FramePointerMapElement& frame: _world_map->frames()) {
+    frame.second->setCameraLeft(_camera_left);
+    frame.second->setCameraRight(_camera_right);
+  }
+
+  //ds register the loaded local maps for relocalization and pose graph optimization (in order of creation)
+  for (LocalMap* local_map: _world_map->localMaps()) {
+    if (!_parameters->command_line_parameters->option_disable_relocalization) {
+      _relocalizer->add(local_map);
+    }
+    if (_parameters->command_line_parameters->option_disable_bundle_adjustment) {
+      _graph_optimizer->addPose(local_map);
+    }
+  }
+  _relocalizer->integrateAppearanceMerges();
+  LOG_INFO(std::cerr << "SLAMAssembly::loadMap|map ready for relocalization after: " << srrg_core::getTime()-time_begin_seconds << "s" << std::endl)
+}
+
+void SLAMAssembly::saveMap(const std::string& file_name_) const {
+  if (_world_map) {
+    _world_map->write(file_name_);
+  }
+}
+
 void SLAMAssembly::writePoseGraphToFile(const std::string& file_name_) const {
   if (_graph_optimizer && _world_map) {
     _graph_optimizer->writePoseGraphToFile(_world_map, file_name_);
@@ -342,21 +418,307 @@ void SLAMAssembly::writePoseGraphToFile(const std::string& file_name_) const {
 
 void SLAMAssembly::playbackMessageFile() {
 
-  //ds restart stream
-  _message_reader.open(_parameters->command_line_parameters->dataset_file_name);
+  //ds restart stream (native dataset directories are read by the dataset reader)
+  if (!_dataset_reader) {
+    _message_reader.open(_parameters->command_line_parameters->dataset_file_name);
+  }
 
   //ds frame counts
   _number_of_processed_frames              = 0;
+  _number_of_retrieved_stereo_images       = 0;
+  _number_of_dropped_stereo_images         = 0;
   Count number_of_processed_frames_current = 0;
 
   //ds time measurement
   const double runtime_info_update_frequency_seconds = 5;
   double processing_time_seconds_current             = 0;
+  const double time_begin_playback_seconds           = srrg_core::getTime();
 
   //ds visualization/start point
   const TransformMatrix3D robot_to_camera_left(_camera_left->robotToCamera());
 
+  //ds if desired - read and decode images in the background
+  _startPrefetchThread();
+
+  //ds if desired - stream per-frame telemetry
+  if (!_parameters->command_line_parameters->telemetry_file_name.empty()) {
+    _telemetry.open(_parameters->command_line_parameters->telemetry_file_name);
+  }
+
+  //ds pipelined processing: the features of the next image pair are extracted while the current image pair is processed
+  const bool is_pipelined = _parameters->command_line_parameters->option_pipelined_processing;
+  BaseFramePointGenerator::ExtractedFeatures features_current;
+  BaseFramePointGenerator::ExtractedFeatures features_next;
+  double time_start_extraction_current_seconds = 0;
+
   //ds start playback
+  StereoImagePackage* stereo_images = _nextStereoImages();
+  if (is_pipelined && stereo_images) {
+    time_start_extraction_current_seconds = srrg_core::getTime();
+    _tracker->framepointGenerator()->extractFeatures(stereo_images->image_left, stereo_images->image_right, features_current, false);
+    _tracker->framepointGenerator()->addExtractionStatistics(features_current);
+  }
+  while (stereo_images) {
+
+    //ds if termination is requested - terminate
+    if (_is_termination_requested) {
+      delete stereo_images;
+      break;
+    }
+
+    //ds odometry guess integration (if available)
+    TransformMatrix3D camera_left_to_world_guess(TransformMatrix3D::Identity());
+    if (stereo_images->has_odometry) {
+
+      //ds get odometry into camera frame
+      camera_left_to_world_guess = stereo_images->robot_to_world*_camera_left->cameraToRobot();
+
+      //ds if we just started - move current robot pose to odometry estimate (this only has an effect if the odometry starts not in the world origin)
+      if (_world_map->frames().empty()) {
+        _world_map->setRobotToWorld(stereo_images->robot_to_world);
+        if (_parameters->command_line_parameters->option_use_gui) {
+          _map_viewer->setWorldToRobotOrigin(_world_map->robotToWorld().inverse());
+        }
+      }
+    }
+
+    //ds module statistics before processing (telemetry: per-frame deltas)
+    //ds in pipelined processing the feature extraction stage contains the extraction of the next image pair
+    TelemetryRecorder::FrameRecord telemetry;
+    double stage_seconds_before[TelemetryRecorder::NUMBER_OF_STAGES] = {0};
+    Count number_of_recursive_registrations_before = 0;
+    Count number_of_local_maps_before              = 0;
+    Count number_of_closures_before                = 0;
+    Count number_of_optimizations_before           = 0;
+    if (_telemetry.isOpen()) {
+      _sampleStageTimes(stage_seconds_before);
+      number_of_recursive_registrations_before = _tracker->numberOfRecursiveRegistrations();
+      number_of_local_maps_before              = _world_map->localMaps().size();
+      number_of_closures_before                = _world_map->numberOfClosures();
+      number_of_optimizations_before           = _graph_optimizer->numberOfOptimizations();
+    }
+
+    //ds pipelined processing: retrieve the next image pair and start its feature extraction
+    //ds the pose reliability of the current frame is not known yet - the detector threshold policy uses the one of the previous frame
+    StereoImagePackage* stereo_images_next = nullptr;
+    ThreadPool::TaskGroup extraction_next;
+    bool is_extracting_next = false;
+    double time_start_extraction_next_seconds = 0;
+    if (is_pipelined) {
+      stereo_images_next = _nextStereoImages();
+      if (stereo_images_next) {
+        const bool ignore_minimum_detector_threshold = (_world_map->currentFrame() && _world_map->currentFrame()->hasReliablePoseEstimate());
+        time_start_extraction_next_seconds = srrg_core::getTime();
+
+        //ds the extraction runs concurrently with the processing of the current frame - its spans belong to the next frame
+        const uint32_t frame_identifier_next = _number_of_processed_frames+1;
+        _thread_pool->submit(extraction_next, [&, ignore_minimum_detector_threshold, frame_identifier_next] {
+          Profiler::FrameScope profiler_frame_scope(frame_identifier_next);
+          _tracker->framepointGenerator()->extractFeatures(stereo_images_next->image_left,
+                                                           stereo_images_next->image_right,
+                                                           features_next,
+                                                           ignore_minimum_detector_threshold);
+        });
+        is_extracting_next = true;
+      }
+    }
+
+    //ds start measuring time (spans recorded from now on are assigned to this frame)
+    const double time_start_seconds = srrg_core::getTime();
+    Profiler::setFrameIdentifier(_number_of_processed_frames);
+
+    //ds progress SLAM with the new images
+    try {
+      process(stereo_images->image_left, stereo_images->image_right,
+              stereo_images->timestamp_image_left_seconds,
+              stereo_images->has_odometry,
+              camera_left_to_world_guess,
+              (is_pipelined) ? &features_current : nullptr);
+    } catch (...) {
+
+      //ds the feature extraction of the next image pair references this scope - it has to complete before we leave
+      if (is_extracting_next) {
+        try {
+          _thread_pool->wait(extraction_next);
+        } catch (...) {}
+      }
+      delete stereo_images;
+      delete stereo_images_next;
+      throw;
+    }
+
+    //ds set ground truth to generated frame if available
+    if (stereo_images->has_odometry) {
+      _world_map->setRobotToWorldGroundTruth(stereo_images->robot_to_world);
+    }
+
+    //ds pipelined processing: synchronize with the feature extraction of the next image pair
+    if (is_extracting_next) {
+      try {
+        _thread_pool->wait(extraction_next);
+      } catch (...) {
+        delete stereo_images;
+        delete stereo_images_next;
+        throw;
+      }
+
+      //ds the extraction statistics are accumulated here, as the main thread reads them concurrently to the extraction
+      _tracker->framepointGenerator()->addExtractionStatistics(features_next);
+      std::swap(features_current, features_next);
+    }
+
+    //ds update timing stats (pipelined: the frame latency includes the feature extraction that overlapped the previous frame)
+    const double time_stop_seconds       = srrg_core::getTime();
+    const double processing_time_seconds = time_stop_seconds-time_start_seconds;
+    _frame_latencies_seconds.push_back(time_stop_seconds-((is_pipelined) ? time_start_extraction_current_seconds : time_start_seconds));
+    time_start_extraction_current_seconds = time_start_extraction_next_seconds;
+    _processing_times_seconds.push_back(processing_time_seconds);
+    _processing_time_total_seconds  += processing_time_seconds;
+    processing_time_seconds_current += processing_time_seconds;
+    ++_number_of_processed_frames;
+    ++number_of_processed_frames_current;
+    _current_fps = _number_of_processed_frames/_processing_time_total_seconds;
+
+    //ds per-frame telemetry
+    if (_telemetry.isOpen()) {
+      const Frame* frame = _world_map->currentFrame();
+      telemetry.frame_identifier        = (frame) ? frame->identifier() : _number_of_processed_frames-1;
+      telemetry.timestamp_seconds       = stereo_images->timestamp_image_left_seconds;
+      telemetry.processing_time_seconds = processing_time_seconds;
+      telemetry.latency_seconds         = _frame_latencies_seconds.back();
+      _sampleStageTimes(telemetry.stage_seconds);
+      for (Index stage = 0; stage < TelemetryRecorder::NUMBER_OF_STAGES; ++stage) {
+        telemetry.stage_seconds[stage] -= stage_seconds_before[stage];
+      }
+      if (frame) {
+        telemetry.status                = frame->status();
+        telemetry.number_of_framepoints = frame->points().size();
+      }
+      telemetry.number_of_detected_keypoints      = _tracker->framepointGenerator()->numberOfDetectedKeypoints();
+      telemetry.number_of_tracked_points          = _tracker->numberOfTrackedPoints();
+      telemetry.number_of_tracked_landmarks       = _tracker->numberOfTrackedLandmarks();
+      telemetry.number_of_created_points          = _tracker->numberOfCreatedPoints();
+      telemetry.number_of_recovered_points        = _tracker->numberOfRecoveredPoints();
+      telemetry.number_of_recursive_registrations = _tracker->numberOfRecursiveRegistrations()-number_of_recursive_registrations_before;
+      telemetry.number_of_aligner_iterations      = _tracker->numberOfPoseOptimizationIterations();
+      telemetry.aligner_inlier_ratio              = _tracker->poseOptimizationInlierRatio();
+      telemetry.is_local_map_created              = (_world_map->localMaps().size() > number_of_local_maps_before);
+      telemetry.number_of_added_closures          = _world_map->numberOfClosures()-number_of_closures_before;
+      telemetry.is_bundle_adjustment_performed    = (_graph_optimizer->numberOfOptimizations() > number_of_optimizations_before);
+      telemetry.number_of_landmarks               = _world_map->landmarks().size();
+      telemetry.number_of_local_maps              = _world_map->localMaps().size();
+      telemetry.number_of_frames                  = _world_map->frames().size();
+      telemetry.resident_memory_megabytes         = _residentMemoryMegabytes();
+      _telemetry.add(telemetry);
+    }
+
+    //ds runtime info
+    if (processing_time_seconds_current > runtime_info_update_frequency_seconds) {
+
+      //ds runtime info - depending on set modes and available information
+      if (!_parameters->command_line_parameters->option_disable_relocalization && !_world_map->localMaps().empty()) {
+        LOG_INFO(std::printf("SLAMAssembly::playbackMessageFile|frames: %5u <FPS: %6.2f>|landmarks: %6lu|local maps: %4lu (%3.2f)|closures: %3u (%3.2f)\n",
+                    _number_of_processed_frames,
+                    number_of_processed_frames_current/processing_time_seconds_current,
+                    _world_map->landmarks().size(),
+                    _world_map->localMaps().size(),
+                    _world_map->localMaps().size()/static_cast<real>(_number_of_processed_frames),
+                    _world_map->numberOfClosures(),
+                    _world_map->numberOfClosures()/static_cast<real>(_world_map->localMaps().size())))
+      } else {
+        LOG_INFO(std::printf("SLAMAssembly::playbackMessageFile|frames: %5u <FPS: %6.2f>|landmarks: %6lu|map updates: %3u|frames in memory: %5lu|memory (MB): %7.1f\n",
+                    _number_of_processed_frames,
+                    number_of_processed_frames_current/processing_time_seconds_current,
+                    _world_map->landmarks().size(),
+                    _graph_optimizer->numberOfOptimizations(),
+                    _world_map->frames().size(),
+                    _residentMemoryMegabytes()))
+      }
+
+      //ds reset stats for new measurement window
+      processing_time_seconds_current    = 0;
+      number_of_processed_frames_current = 0;
+    }
+
+    //ds update gui (no effect if no GUI is active)
+    updateGUI();
+
+    //ds free image references (GUI gets copies)
+    delete stereo_images;
+    stereo_images = (is_pipelined) ? stereo_images_next : _nextStereoImages();
+  }
+  _stopPrefetchThread();
+  _message_reader.close();
+
+  //ds integrate closures of local maps still being relocalized in the background
+  finishRelocalization();
+
+  //ds write the telemetry summary (no effect if telemetry is disabled)
+  _telemetry.close(_parameters->command_line_parameters->telemetry_number_of_slowest_frames);
+
+  //ds overall throughput including message reading and image decoding
+  const double duration_playback_seconds = srrg_core::getTime()-time_begin_playback_seconds;
+  LOG_INFO(std::cerr << "SLAMAssembly::playbackMessageFile|dataset completed (playback FPS: "
+                     << _number_of_processed_frames/duration_playback_seconds << ")" << std::endl)
+}
+
+void SLAMAssembly::_sampleStageTimes(double stage_seconds_[TelemetryRecorder::NUMBER_OF_STAGES]) const {
+  stage_seconds_[TelemetryRecorder::FEATURE_EXTRACTION]      = _tracker->framepointGenerator()->getTimeConsumptionSeconds_keypoint_detection()
+                                                              +_tracker->framepointGenerator()->getTimeConsumptionSeconds_descriptor_extraction();
+  stage_seconds_[TelemetryRecorder::TRACKING]                = _tracker->getTimeConsumptionSeconds_tracking();
+  stage_seconds_[TelemetryRecorder::POSE_OPTIMIZATION]       = _tracker->getTimeConsumptionSeconds_pose_optimization();
+  stage_seconds_[TelemetryRecorder::POINT_RECOVERY]          = _tracker->getTimeConsumptionSeconds_point_recovery();
+  stage_seconds_[TelemetryRecorder::LANDMARK_OPTIMIZATION]   = _tracker->getTimeConsumptionSeconds_landmark_optimization();
+  stage_seconds_[TelemetryRecorder::TRACK_CREATION]          = _tracker->getTimeConsumptionSeconds_track_creation();
+  stage_seconds_[TelemetryRecorder::POSE_GRAPH_ADDITION]     = _graph_optimizer->getTimeConsumptionSeconds_addition();
+  stage_seconds_[TelemetryRecorder::POSE_GRAPH_OPTIMIZATION] = _graph_optimizer->getTimeConsumptionSeconds_optimization();
+  stage_seconds_[TelemetryRecorder::LANDMARK_MERGING]        = _world_map->getTimeConsumptionSeconds_landmark_merging();
+  stage_seconds_[TelemetryRecorder::WINDOW_EVICTION]         = _world_map->getTimeConsumptionSeconds_window_eviction();
+
+  //ds the relocalizer chronometer is written by the background thread in asynchronous relocalization
+  stage_seconds_[TelemetryRecorder::RELOCALIZATION] = (_relocalization_thread) ? 0 : _relocalizer->getTimeConsumptionSeconds_overall();
+}
+
+double SLAMAssembly::_residentMemoryMegabytes() {
+#ifdef __linux__
+
+  //ds resident pages are the second entry of statm
+  std::ifstream statm("/proc/self/statm");
+  uint64_t number_of_pages_total = 0;
+  uint64_t number_of_pages_resident = 0;
+  if (statm >> number_of_pages_total >> number_of_pages_resident) {
+    return number_of_pages_resident*static_cast<double>(sysconf(_SC_PAGESIZE))/(1024*1024);
+  }
+#endif
+  return 0;
+}
+
+double SLAMAssembly::_peakResidentMemoryMegabytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss/(1024.0*1024.0);
+#else
+  return usage.ru_maxrss/1024.0;
+#endif
+}
+
+SLAMAssembly::StereoImagePackage* SLAMAssembly::_readStereoImages() {
+
+  //ds native dataset directory: images are decoded in parallel batches by the reader
+  if (_dataset_reader) {
+    StereoImagePackage* stereo_images = new StereoImagePackage();
+    if (_is_termination_requested || !_dataset_reader->next(stereo_images->image_left, stereo_images->image_right, stereo_images->timestamp_image_left_seconds)) {
+      delete stereo_images;
+      return nullptr;
+    }
+    _preprocessStereoImages(stereo_images);
+    return stereo_images;
+  }
+
+  //ds txt_io message file
   srrg_core::BaseMessage* message = 0;
   while ((message = _message_reader.readMessage())) {
     srrg_core::BaseSensorMessage* sensor_message = dynamic_cast<srrg_core::BaseSensorMessage*>(message);
@@ -377,7 +739,7 @@ void SLAMAssembly::playbackMessageFile() {
 
       //ds if termination is requested - terminate
       if (_is_termination_requested) {
-        break;
+        return nullptr;
       }
 
       //ds buffer sensor data
@@ -386,119 +748,184 @@ void SLAMAssembly::playbackMessageFile() {
       if (!image_message_left || !image_message_right) {
         throw std::runtime_error("SLAMAssembly::playbackMessageFile|unable to retrieve image data from srrg messages");
       }
+      StereoImagePackage* stereo_images = new StereoImagePackage();
 
-      //ds buffer images
-      cv::Mat image_left;
+      //ds buffer images (accessing the image triggers loading and decoding)
       if(image_message_left->image().type() == CV_8UC3){
-        cvtColor(image_message_left->image(), image_left, CV_BGR2GRAY);
+        cvtColor(image_message_left->image(), stereo_images->image_left, CV_BGR2GRAY);
       } else {
-        image_left = image_message_left->image();
+        stereo_images->image_left = image_message_left->image();
       }
-      cv::Mat image_right;
       if (_parameters->command_line_parameters->tracker_mode == CommandLineParameters::TrackerMode::RGB_STEREO && image_message_right->image().type() == CV_8UC3) {
-        cvtColor(image_message_right->image(), image_right, CV_BGR2GRAY);
+        cvtColor(image_message_right->image(), stereo_images->image_right, CV_BGR2GRAY);
       } else {
-        image_right = image_message_right->image();
+        stereo_images->image_right = image_message_right->image();
       }
 
-      //ds preprocess the images if desired
-      if (_parameters->command_line_parameters->option_equalize_histogram) {
-        cv::equalizeHist(image_left, image_left);
-        if (_parameters->command_line_parameters->tracker_mode == CommandLineParameters::TrackerMode::RGB_STEREO) {
-          cv::equalizeHist(image_right, image_right);
-        }
+      _preprocessStereoImages(stereo_images);
+
+      //ds buffer odometry (if available)
+      stereo_images->timestamp_image_left_seconds = image_message_left->timestamp();
+      stereo_images->has_odometry                 = image_message_left->hasOdom();
+      if (stereo_images->has_odometry) {
+        stereo_images->robot_to_world = image_message_left->odometry().cast<real>();
       }
+      image_message_left->release();
+      image_message_right->release();
+      _synchronizer.reset();
+      return stereo_images;
+    }
+  }
+  return nullptr;
+}
 
-      //ds odometry guess integration (if available)
-      TransformMatrix3D camera_left_to_world_guess(TransformMatrix3D::Identity());
-      if (image_message_left->hasOdom()) {
+SLAMAssembly::StereoImagePackage* SLAMAssembly::_nextStereoImages() {
+  StereoImagePackage* stereo_images = (_prefetch_thread) ? _retrievePrefetchedStereoImages() : _readStereoImages();
+
+  //ds if desired - inject frame drops: skip a burst of image pairs after every interval (the first interval is always processed)
+  const Count image_drop_interval = _parameters->command_line_parameters->image_drop_interval;
+  if (image_drop_interval > 0) {
+    const Count image_drop_burst_length = std::min(_parameters->command_line_parameters->image_drop_burst_length, image_drop_interval-1);
+    while (stereo_images &&
+           _number_of_retrieved_stereo_images >= image_drop_interval &&
+           _number_of_retrieved_stereo_images%image_drop_interval < image_drop_burst_length) {
+      delete stereo_images;
+      ++_number_of_retrieved_stereo_images;
+      ++_number_of_dropped_stereo_images;
+      stereo_images = (_prefetch_thread) ? _retrievePrefetchedStereoImages() : _readStereoImages();
+    }
+  }
+  if (stereo_images) {
+    ++_number_of_retrieved_stereo_images;
+  }
+  return stereo_images;
+}
 
-        //ds get odometry into camera frame
-        const TransformMatrix3D robot_to_world = image_message_left->odometry().cast<real>();
-        camera_left_to_world_guess             = robot_to_world*_camera_left->cameraToRobot();
+void SLAMAssembly::_preprocessStereoImages(StereoImagePackage* stereo_images_) const {
 
-        //ds if we just started - move current robot pose to odometry estimate (this only has an effect if the odometry starts not in the world origin)
-        if (_world_map->frames().empty()) {
-          _world_map->setRobotToWorld(robot_to_world);
-          if (_parameters->command_line_parameters->option_use_gui) {
-            _map_viewer->setWorldToRobotOrigin(_world_map->robotToWorld().inverse());
-          }
-        }
-      }
+  //ds preprocess the images if desired
+  if (_parameters->command_line_parameters->option_equalize_histogram) {
+    cv::equalizeHist(stereo_images_->image_left, stereo_images_->image_left);
+    if (_parameters->command_line_parameters->tracker_mode == CommandLineParameters::TrackerMode::RGB_STEREO) {
+      cv::equalizeHist(stereo_images_->image_right, stereo_images_->image_right);
+    }
+  }
+}
 
-      //ds start measuring time
-      const double time_start_seconds = srrg_core::getTime();
+void SLAMAssembly::_startPrefetchThread() {
+  if (_prefetch_thread || !_parameters->command_line_parameters->option_prefetch_images) {
+    return;
+  }
+  _is_prefetching_completed          = false;
+  _is_prefetch_termination_requested = false;
+  _prefetched_bytes                  = 0;
+  _prefetch_exception                = nullptr;
+  _prefetch_thread = std::make_shared<std::thread>([=] {_prefetchInThread();});
+  LOG_INFO(std::cerr << "SLAMAssembly::_startPrefetchThread|launched image prefetching (queue size: "
+                     << _parameters->command_line_parameters->prefetch_queue_size << ", maximum memory: "
+                     << _parameters->command_line_parameters->prefetch_maximum_megabytes << "MB)" << std::endl)
+}
 
-      //ds progress SLAM with the new images
-      process(image_left, image_right,
-              image_message_left->timestamp(),
-              image_message_left->hasOdom(),
-              camera_left_to_world_guess);
+void SLAMAssembly::_stopPrefetchThread() {
+  if (!_prefetch_thread) {
+    return;
+  }
 
-      //ds set ground truth to generated frame if available
-      if (image_message_left->hasOdom()) {
-        _world_map->setRobotToWorldGroundTruth(image_message_left->odometry().cast<real>());
-      }
+  //ds signal termination and wait for the thread to finish its current image pair
+  {
+    std::lock_guard<std::mutex> lock(_prefetch_mutex);
+    _is_prefetch_termination_requested = true;
+  }
+  _prefetch_condition.notify_all();
+  _prefetch_thread->join();
+  _prefetch_thread = nullptr;
 
-      //ds update timing stats
-      const double processing_time_seconds = srrg_core::getTime()-time_start_seconds;
-      _processing_times_seconds.push_back(processing_time_seconds);
-      _processing_time_total_seconds  += processing_time_seconds;
-      processing_time_seconds_current += processing_time_seconds;
-      ++_number_of_processed_frames;
-      ++number_of_processed_frames_current;
-      _current_fps = _number_of_processed_frames/_processing_time_total_seconds;
-
-      //ds runtime info
-      if (processing_time_seconds_current > runtime_info_update_frequency_seconds) {
-
-        //ds runtime info - depending on set modes and available information
-        if (!_parameters->command_line_parameters->option_disable_relocalization && !_world_map->localMaps().empty()) {
-          LOG_INFO(std::printf("SLAMAssembly::playbackMessageFile|frames: %5u <FPS: %6.2f>|landmarks: %6lu|local maps: %4lu (%3.2f)|closures: %3u (%3.2f)\n",
-                      _number_of_processed_frames,
-                      number_of_processed_frames_current/processing_time_seconds_current,
-                      _world_map->landmarks().size(),
-                      _world_map->localMaps().size(),
-                      _world_map->localMaps().size()/static_cast<real>(_number_of_processed_frames),
-                      _world_map->numberOfClosures(),
-                      _world_map->numberOfClosures()/static_cast<real>(_world_map->localMaps().size())))
-        } else {
-          LOG_INFO(std::printf("SLAMAssembly::playbackMessageFile|frames: %5u <FPS: %6.2f>|landmarks: %6lu|map updates: %3u\n",
-                      _number_of_processed_frames,
-                      number_of_processed_frames_current/processing_time_seconds_current,
-                      _world_map->landmarks().size(),
-                      _graph_optimizer->numberOfOptimizations()))
-        }
+  //ds drop remaining image pairs
+  for (StereoImagePackage* stereo_images: _prefetched_stereo_images) {
+    delete stereo_images;
+  }
+  _prefetched_stereo_images.clear();
+  _prefetched_bytes = 0;
+}
 
-        //ds reset stats for new measurement window
-        processing_time_seconds_current    = 0;
-        number_of_processed_frames_current = 0;
+void SLAMAssembly::_prefetchInThread() {
+  const Count maximum_queue_size = std::max(_parameters->command_line_parameters->prefetch_queue_size, Count(1));
+  const size_t maximum_bytes     = _parameters->command_line_parameters->prefetch_maximum_megabytes*1e6;
+  while (true) {
+
+    //ds wait for free queue capacity (a single image pair is always admitted, even if it exceeds the memory cap)
+    {
+      std::unique_lock<std::mutex> lock(_prefetch_mutex);
+      _prefetch_condition.wait(lock, [&] {
+        return _is_prefetch_termination_requested ||
+               _prefetched_stereo_images.empty()  ||
+               (_prefetched_stereo_images.size() < maximum_queue_size && _prefetched_bytes < maximum_bytes);
+      });
+      if (_is_prefetch_termination_requested) {
+        break;
       }
-      image_message_left->release();
-      image_message_right->release();
-      _synchronizer.reset();
+    }
+
+    //ds read and decode without holding the lock (any error is handed over to the main thread and terminates the playback there)
+    StereoImagePackage* stereo_images = nullptr;
+    std::exception_ptr exception      = nullptr;
+    try {
+      stereo_images = _readStereoImages();
+    } catch (...) {
+      exception = std::current_exception();
+    }
 
-      //ds update gui (no effect if no GUI is active)
-      updateGUI();
+    //ds hand over the result
+    {
+      std::lock_guard<std::mutex> lock(_prefetch_mutex);
+      if (!stereo_images) {
+        _prefetch_exception       = exception;
+        _is_prefetching_completed = true;
+      } else {
+        _prefetched_bytes += stereo_images->bytes();
+        _prefetched_stereo_images.push_back(stereo_images);
+      }
+    }
+    _prefetch_condition.notify_all();
+    if (!stereo_images) {
+      break;
+    }
+  }
+}
 
-      //ds free image references (GUI gets copies)
-      image_left.release();
-      image_right.release();
+SLAMAssembly::StereoImagePackage* SLAMAssembly::_retrievePrefetchedStereoImages() {
+  StereoImagePackage* stereo_images = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(_prefetch_mutex);
+    _prefetch_condition.wait(lock, [this] {
+      return !_prefetched_stereo_images.empty() || _is_prefetching_completed;
+    });
+    if (_prefetched_stereo_images.empty()) {
+      if (_prefetch_exception) {
+        std::rethrow_exception(_prefetch_exception);
+      }
+      return nullptr;
     }
+    stereo_images = _prefetched_stereo_images.front();
+    _prefetched_stereo_images.pop_front();
+    _prefetched_bytes -= stereo_images->bytes();
   }
-  _message_reader.close();
-  LOG_INFO(std::cerr << "SLAMAssembly::playbackMessageFile|dataset completed" << std::endl)
+  _prefetch_condition.notify_all();
+  return stereo_images;
 }
 
 void SLAMAssembly::process(const cv::Mat& intensity_image_left_,
                            const cv::Mat& intensity_image_right_,
                            const double& timestamp_image_left_seconds_,
                            const bool& use_guess_,
-                           const TransformMatrix3D& camera_left_in_world_guess_) {
+                           const TransformMatrix3D& camera_left_in_world_guess_,
+                           BaseFramePointGenerator::ExtractedFeatures* features_) {
+  PROFILER_SPAN(process)
 
   //ds provide tracker with data
   _tracker->setIntensityImageLeft(intensity_image_left_);
   _tracker->setImageSecondary(intensity_image_right_);
+  _tracker->setExtractedFeatures(features_);
 
   //ds if we have a prior on the camera pose
   if (use_guess_) {
@@ -524,43 +951,41 @@ void SLAMAssembly::process(const cv::Mat& intensity_image_left_,
 
       //ds if we successfully created a local map
       if (created_local_map) {
+        LocalMap* local_map_query = nullptr;
 
-        //ds localize in database (not yet optimizing the graph)
-        _relocalizer->detectClosures(created_local_map);
-        _relocalizer->registerClosures();
+        //ds if relocalization runs in the background - queue the local map (closures are integrated once available)
+        if (_relocalization_thread) {
+          std::lock_guard<std::mutex> lock(_relocalization_mutex);
+          _local_maps_to_relocalize.push_back(created_local_map);
+          _relocalization_condition.notify_all();
+        } else {
+
+          //ds localize in database (not yet optimizing the graph)
+          _relocalizer->detectClosures(created_local_map);
+          _relocalizer->integrateAppearanceMerges();
+          _relocalizer->registerClosures();
+          local_map_query = created_local_map;
+        }
 
         //ds check the closures
         if (_map_viewer) {_map_viewer->lock();}
-        for(Closure* closure: _relocalizer->closures()) {
-          if (closure->is_valid) {
-            assert(created_local_map == closure->local_map_query);
-
-            //ds add loop closure constraint (merging corresponding landmarks)
-            _world_map->addLoopClosure(created_local_map,
-                                       closure->local_map_reference,
-                                       closure->query_to_reference,
-                                       closure->correspondences,
-                                       closure->icp_inlier_ratio);
-            if (_parameters->command_line_parameters->option_use_gui) {
-              for (const Closure::Correspondence* match: closure->correspondences) {
-                _world_map->landmarks().at(match->query->identifier())->setIsInLoopClosureQuery(true);
-                _world_map->landmarks().at(match->reference->identifier())->setIsInLoopClosureReference(true);
-              }
-            }
-          }
+        if (local_map_query) {
+          _addLoopClosures(local_map_query);
         }
 
-        //ds clear buffer (automatically purges invalidated closures)
-        _relocalizer->clear();
-
         //ds if bundle-adjustment is desired
         if (!_parameters->command_line_parameters->option_disable_bundle_adjustment) {
 
           //ds add frame and its landmarks to the pose graph
           _graph_optimizer->addPoseWithFactors(_world_map->currentFrame());
 
+          //ds sliding window bundle adjustment: optimize the window for every local map
+          if (_parameters->graph_optimizer_parameters->enable_sliding_window_bundle_adjustment) {
+            _graph_optimizer->optimizeSlidingWindow(_world_map);
+          }
+
           //ds check if a periodic bundle adjustment is required
-          if (_world_map->frames().size() % _parameters->graph_optimizer_parameters->number_of_frames_per_bundle_adjustment == 0) {
+          else if (_world_map->frames().size() % _parameters->graph_optimizer_parameters->number_of_frames_per_bundle_adjustment == 0) {
 
             //ds optimize graph
             _graph_optimizer->optimizeFactorGraph(_world_map);
@@ -571,6 +996,14 @@ void SLAMAssembly::process(const cv::Mat& intensity_image_left_,
           _graph_optimizer->addPose(created_local_map);
         }
 
+        //ds synchronization point for the background relocalization: integrate completed results (the thread is idle until released)
+        if (_relocalization_thread) {
+          local_map_query = _retrieveRelocalizationResult();
+          if (local_map_query) {
+            _addLoopClosures(local_map_query);
+          }
+        }
+
         //ds if we closed a local map
         if (_world_map->relocalized()) {
 
@@ -578,7 +1011,12 @@ void SLAMAssembly::process(const cv::Mat& intensity_image_left_,
           _graph_optimizer->optimizePoseGraph(_world_map);
 
           //ds merge landmarks for the current local map and its closures
-          _world_map->mergeLandmarks(created_local_map->closures());
+          _world_map->mergeLandmarks(local_map_query->closures());
+        }
+
+        //ds resume background relocalization
+        if (_relocalization_thread && local_map_query) {
+          _releaseRelocalizationResult();
         }
 
         //ds update viewer
@@ -589,33 +1027,153 @@ void SLAMAssembly::process(const cv::Mat& intensity_image_left_,
       }
     } else if (_parameters->command_line_parameters->option_drop_framepoints) {
 
-      //ds free disconnected framepoints if available: TODO safe window
-      if (_world_map->frames().size() >= 250) {
-        Frame* frame_to_clear = _world_map->frames().at(_world_map->frames().size()-250);
-
-        //ds free all landmarks that are in this frame or older
-        Identifier landmark_identifier_end = _last_freed_landmark_identifier;
-        for (const FramePoint* point: frame_to_clear->points()) {
-          if (point->landmark()) {
-            if (point->landmark()->identifier() > landmark_identifier_end) {
-              landmark_identifier_end = point->landmark()->identifier();
-            }
-          }
-        }
+      //ds bounded-memory odometry: free frames and landmarks leaving the window
+      if (_map_viewer) {_map_viewer->lock();}
+      _world_map->evictOutsideWindow();
+      if (_map_viewer) {_map_viewer->unlock();}
+    }
+  }
+}
 
-        //ds if we have landmarks to free
-        if (landmark_identifier_end > _last_freed_landmark_identifier) {
-          for (Identifier u = _last_freed_landmark_identifier; u < landmark_identifier_end; ++u) {
-            _world_map->removeLandmark(u);
-          }
-          _last_freed_landmark_identifier = landmark_identifier_end;
+void SLAMAssembly::finishRelocalization() {
+  if (!_relocalization_thread) {
+    return;
+  }
+  LOG_INFO(std::cerr << "SLAMAssembly::finishRelocalization|integrating remaining relocalization results" << std::endl)
+  if (_map_viewer) {_map_viewer->lock();}
+
+  //ds integrate all results until the queue is empty
+  LocalMap* local_map_query = nullptr;
+  while ((local_map_query = _retrieveRelocalizationResult(true))) {
+    if (_addLoopClosures(local_map_query) > 0) {
+      _graph_optimizer->optimizePoseGraph(_world_map);
+      _world_map->mergeLandmarks(local_map_query->closures());
+    }
+    _releaseRelocalizationResult();
+  }
+  if (_map_viewer) {_map_viewer->unlock();}
+}
+
+const Count SLAMAssembly::_addLoopClosures(LocalMap* local_map_query_) {
+  Count number_of_added_closures = 0;
+  for (Closure* closure: _relocalizer->closures()) {
+    if (closure->is_valid) {
+      assert(local_map_query_ == closure->local_map_query);
+
+      //ds add loop closure constraint (merging corresponding landmarks)
+      _world_map->addLoopClosure(local_map_query_,
+                                 closure->local_map_reference,
+                                 closure->query_to_reference,
+                                 closure->correspondences,
+                                 closure->icp_inlier_ratio);
+      if (_parameters->command_line_parameters->option_use_gui) {
+        for (const Closure::Correspondence* match: closure->correspondences) {
+          _world_map->landmarks().at(match->query->identifier())->setIsInLoopClosureQuery(true);
+          _world_map->landmarks().at(match->reference->identifier())->setIsInLoopClosureReference(true);
         }
+      }
+
+      //ds if the query local map is already in the pose graph (asynchronous relocalization) - add the constraint directly
+      if (_relocalization_thread && _parameters->command_line_parameters->option_disable_bundle_adjustment) {
+        _graph_optimizer->addLoopClosure(local_map_query_, local_map_query_->closures().back());
+      }
+      ++number_of_added_closures;
+    }
+  }
+
+  //ds clear buffer (automatically purges invalidated closures)
+  _relocalizer->clear();
+  return number_of_added_closures;
+}
+
+void SLAMAssembly::_startRelocalizationThread() {
+  if (_relocalization_thread                                                ||
+      !_parameters->command_line_parameters->option_asynchronous_relocalization ||
+      _parameters->command_line_parameters->option_disable_relocalization) {
+    return;
+  }
+  _is_relocalization_termination_requested = false;
+  _relocalization_thread = std::make_shared<std::thread>([=] {_relocalizeInThread();});
+  LOG_INFO(std::cerr << "SLAMAssembly::_startRelocalizationThread|launched asynchronous relocalization" << std::endl)
+}
+
+void SLAMAssembly::_stopRelocalizationThread() {
+  if (!_relocalization_thread) {
+    return;
+  }
+
+  //ds signal termination and wait for the thread to finish its current local map
+  {
+    std::lock_guard<std::mutex> lock(_relocalization_mutex);
+    _is_relocalization_termination_requested = true;
+  }
+  _relocalization_condition.notify_all();
+  _relocalization_thread->join();
+  _relocalization_thread = nullptr;
+
+  //ds drop remaining work
+  if (!_local_maps_to_relocalize.empty() || _relocalized_local_map) {
+    LOG_WARNING(std::cerr << "SLAMAssembly::_stopRelocalizationThread|dropping unprocessed local maps: " << _local_maps_to_relocalize.size()
+                          << " (pending result: " << (_relocalized_local_map != nullptr) << ")" << std::endl)
+  }
+  _local_maps_to_relocalize.clear();
+  _relocalized_local_map = nullptr;
+  _relocalizer->clear();
+}
 
-        //ds free framepoints
-        frame_to_clear->clear();
+void SLAMAssembly::_relocalizeInThread() {
+  while (true) {
+    LocalMap* local_map_query = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(_relocalization_mutex);
+
+      //ds wait for a new local map - the previous result has to be integrated first (no concurrent world map modifications)
+      _relocalization_condition.wait(lock, [this] {
+        return _is_relocalization_termination_requested || (!_local_maps_to_relocalize.empty() && !_relocalized_local_map);
+      });
+      if (_is_relocalization_termination_requested) {
+        break;
       }
+      local_map_query = _local_maps_to_relocalize.front();
+      _local_maps_to_relocalize.pop_front();
+      _is_relocalization_running = true;
+    }
+
+    //ds localize in database and register closures (operates on the place database and local map snapshots only)
+    _relocalizer->detectClosures(local_map_query);
+    _relocalizer->registerClosures();
+
+    //ds hand over the result
+    {
+      std::lock_guard<std::mutex> lock(_relocalization_mutex);
+      _relocalized_local_map     = local_map_query;
+      _is_relocalization_running = false;
     }
+    _relocalization_condition.notify_all();
+  }
+}
+
+LocalMap* SLAMAssembly::_retrieveRelocalizationResult(const bool& wait_for_result_) {
+  std::unique_lock<std::mutex> lock(_relocalization_mutex);
+  if (wait_for_result_) {
+    _relocalization_condition.wait(lock, [this] {
+      return _relocalized_local_map || (_local_maps_to_relocalize.empty() && !_is_relocalization_running);
+    });
+  }
+  if (_relocalized_local_map) {
+
+    //ds landmark appearances can only be updated while the thread is idle
+    _relocalizer->integrateAppearanceMerges();
+  }
+  return _relocalized_local_map;
+}
+
+void SLAMAssembly::_releaseRelocalizationResult() {
+  {
+    std::lock_guard<std::mutex> lock(_relocalization_mutex);
+    _relocalized_local_map = nullptr;
   }
+  _relocalization_condition.notify_all();
 }
 
 void SLAMAssembly::printReport() const {
@@ -632,11 +1190,13 @@ void SLAMAssembly::printReport() const {
     return;
   }
 
-  //ds compute trajectory length
+  //ds compute trajectory length (including frames evicted from the odometry window, track breaks are skipped)
   double trajectory_length = 0;
-  for (FramePointerMapElement frame: _world_map->frames()) {
-    if (frame.second->previous()) {
-      trajectory_length += (frame.second->worldToRobot()*frame.second->previous()->robotToWorld()).translation().norm();
+  TrajectoryPoseVector trajectory;
+  _world_map->getTrajectory(trajectory);
+  for (Index index = 1; index < trajectory.size(); ++index) {
+    if (trajectory[index].frame_identifier == trajectory[index-1].frame_identifier+1) {
+      trajectory_length += (trajectory[index].robot_to_world.translation()-trajectory[index-1].robot_to_world.translation()).norm();
     }
   }
 
@@ -650,6 +1210,19 @@ void SLAMAssembly::printReport() const {
   processing_time_standard_deviation_seconds /= _processing_times_seconds.size();
   processing_time_standard_deviation_seconds = std::sqrt(processing_time_standard_deviation_seconds);
 
+  //ds compute processing time and frame latency percentiles (identical unless processing is pipelined)
+  std::vector<double> processing_times_sorted_seconds(_processing_times_seconds);
+  std::sort(processing_times_sorted_seconds.begin(), processing_times_sorted_seconds.end());
+  std::vector<double> frame_latencies_sorted_seconds(_frame_latencies_seconds);
+  std::sort(frame_latencies_sorted_seconds.begin(), frame_latencies_sorted_seconds.end());
+  auto percentile_seconds = [](const std::vector<double>& values_sorted_, const double& percentile_) {
+    if (values_sorted_.empty()) {
+      return 0.0;
+    }
+    const size_t index = std::min(static_cast<size_t>(percentile_*values_sorted_.size()), values_sorted_.size()-1);
+    return values_sorted_[index];
+  };
+
   //ds general stats
   std::cerr << "        total trajectory length (m): " << trajectory_length << std::endl;
   std::cerr << "                       total frames: " << _number_of_processed_frames << std::endl;
@@ -658,14 +1231,66 @@ void SLAMAssembly::printReport() const {
   std::cerr << "            average velocity (km/h): " << 3.6*trajectory_length/_processing_time_total_seconds << std::endl;
   std::cerr << "     mean processing time (s/frame): " << processing_time_mean_seconds
             << " (standard deviation: " << processing_time_standard_deviation_seconds << ")" << std::endl;
+  std::cerr << "  processing time percentiles (s/frame): 50%: " << percentile_seconds(processing_times_sorted_seconds, 0.5)
+            << " 90%: " << percentile_seconds(processing_times_sorted_seconds, 0.9)
+            << " 99%: " << percentile_seconds(processing_times_sorted_seconds, 0.99)
+            << " max: " << percentile_seconds(processing_times_sorted_seconds, 1.0)
+            << " (asynchronous relocalization: " << _parameters->command_line_parameters->option_asynchronous_relocalization << ")" << std::endl;
+  std::cerr << "    frame latency percentiles (s/frame): 50%: " << percentile_seconds(frame_latencies_sorted_seconds, 0.5)
+            << " 90%: " << percentile_seconds(frame_latencies_sorted_seconds, 0.9)
+            << " 99%: " << percentile_seconds(frame_latencies_sorted_seconds, 0.99)
+            << " max: " << percentile_seconds(frame_latencies_sorted_seconds, 1.0)
+            << " (pipelined processing: " << _parameters->command_line_parameters->option_pipelined_processing << ")" << std::endl;
   std::cerr << "         mean number of framepoints: " << _tracker->meanNumberOfFramepoints() << std::endl;
   std::cerr << "           mean landmarks per frame: " << _tracker->totalNumberOfLandmarks()/_number_of_processed_frames << std::endl;
   std::cerr << "              mean tracks per frame: " << _tracker->totalNumberOfTrackedPoints()/_number_of_processed_frames << std::endl;
   std::cerr << "             mean tracks per second: " << _tracker->totalNumberOfTrackedPoints()/_processing_time_total_seconds << std::endl;
   std::cerr << "            number of loop closures: " << _world_map->numberOfClosures() << std::endl;
+  std::cerr << "   place database appearances (HBST): " << _relocalizer->numberOfAddedAppearances()
+            << " (per local map: " << static_cast<real>(_relocalizer->numberOfAddedAppearances())/std::max(_world_map->localMaps().size(), size_t(1))
+            << ", representatives per landmark: " << _parameters->world_map_parameters->landmark->maximum_number_of_representative_descriptors << ")" << std::endl;
+  std::cerr << "  mean place database query time (s): " << _relocalizer->getTimeConsumptionSeconds_database_query()/std::max(_relocalizer->numberOfQueries(), Count(1))
+            << " (queries: " << _relocalizer->numberOfQueries() << ")" << std::endl;
+  std::cerr << "   place database addition time (s): " << _relocalizer->getTimeConsumptionSeconds_database_addition()
+            << " (local maps added before the first query)" << std::endl;
   std::cerr << "         number of merged landmarks: " << _world_map->numberOfMergedLandmarks()
             << " (of total landmarks: " << static_cast<real>(_world_map->numberOfMergedLandmarks())/_world_map->landmarks().size() <<  ")" << std::endl;
+  std::cerr << "pose optimization throughput (points/us): " << _tracker->totalNumberOfLinearizedMeasurements()/
+                                                                  std::max(1e6*_tracker->getTimeConsumptionSeconds_pose_optimization(), 1.0)
+            << " (linearized measurements: " << _tracker->totalNumberOfLinearizedMeasurements() << ")" << std::endl;
+  const std::vector<Count>& iteration_histogram = _tracker->poseOptimizationIterationHistogram();
+  const Count number_of_pose_optimizations = std::accumulate(iteration_histogram.begin(), iteration_histogram.end(), Count(0));
+  std::cerr << "    pose optimizations (alignments): " << number_of_pose_optimizations
+            << " (mean time (ms): " << 1e3*_tracker->getTimeConsumptionSeconds_pose_optimization()/std::max(number_of_pose_optimizations, Count(1))
+            << ", time budget exceeded: " << _tracker->numberOfPoseOptimizationTimeouts()
+            << ", convergence policy: " << ((_parameters->tracker_parameters->aligner->convergence_policy == AlignerParameters::ConvergencePolicy::GAUSS_NEWTON)?
+                                           "GAUSS_NEWTON":"LEVENBERG_MARQUARDT") << ")" << std::endl;
+  std::cerr << "  pose optimization iteration histogram:";
+  for (Index bin = 0; bin < iteration_histogram.size(); ++bin) {
+    std::cerr << " [" << ((bin == 0)? 0: (1 << bin)) << "," << (1 << (bin+1))-1 << "]: " << iteration_histogram[bin];
+  }
+  std::cerr << std::endl;
   std::cerr << "  number of recursive registrations: " << _tracker->numberOfRecursiveRegistrations() << std::endl;
+  std::cerr << "   track recoveries (successful/all): " << _tracker->numberOfSuccessfulRecoveries() << "/" << _tracker->numberOfRecoveries()
+            << " (mean recovery time (ms): " << 1e3*_tracker->recoveryDurationSeconds()/std::max(_tracker->numberOfRecoveries(), Count(1))
+            << ", dropped images: " << _number_of_dropped_stereo_images << ")" << std::endl;
+  std::cerr << " PnP RANSAC initializations (seeded/all): " << _tracker->numberOfSuccessfulMotionInitializations() << "/" << _tracker->numberOfMotionInitializations()
+            << " (mean time (ms): " << 1e3*_tracker->getTimeConsumptionSeconds_motion_initialization()/std::max(_tracker->numberOfMotionInitializations(), Count(1))
+            << ", enabled: " << _parameters->tracker_parameters->enable_ransac_initialization << ")" << std::endl;
+  const uint64_t number_of_tracking_searches = std::max(_tracker->framepointGenerator()->numberOfTrackingSearches(), uint64_t(1));
+  std::cerr << "tracking search cells/candidates per point: " << static_cast<real>(_tracker->framepointGenerator()->numberOfSearchedCellsTracking())/number_of_tracking_searches
+            << "/" << static_cast<real>(_tracker->framepointGenerator()->numberOfComparedFeaturesTracking())/number_of_tracking_searches
+            << " (searches: " << _tracker->framepointGenerator()->numberOfTrackingSearches()
+            << ", region shape: " << ((_tracker->framepointGenerator()->parameters()->search_region_shape == BaseFramePointGeneratorParameters::SearchRegionShape::SQUARE)? "SQUARE":
+                                      (_tracker->framepointGenerator()->parameters()->search_region_shape == BaseFramePointGeneratorParameters::SearchRegionShape::RECTANGLE)? "RECTANGLE":
+                                      "ELLIPSE") << ")" << std::endl;
+  std::cerr << "         frames/landmarks in memory: " << _world_map->frames().size() << "/" << _world_map->landmarks().size()
+            << " (evicted: " << _world_map->numberOfEvictedFrames() << "/" << _world_map->numberOfEvictedLandmarks() << ")" << std::endl;
+  std::cerr << "               resident memory (MB): " << _residentMemoryMegabytes() << " (peak: " << _peakResidentMemoryMegabytes() << ")" << std::endl;
+  std::cerr << "framepoint arena blocks (heap/total): " << ObjectArena<FramePoint>::numberOfAllocatedBlocks()
+            << "/" << ObjectArena<FramePoint>::numberOfAcquiredBlocks() << std::endl;
+  std::cerr << "   feature arena blocks (heap/total): " << ObjectArena<IntensityFeature>::numberOfAllocatedBlocks()
+            << "/" << ObjectArena<IntensityFeature>::numberOfAcquiredBlocks() << std::endl;
 
   //ds display further information depending on tracking mode
   switch (_parameters->command_line_parameters->tracker_mode){
@@ -698,6 +1323,16 @@ void SLAMAssembly::printReport() const {
   switch (_parameters->command_line_parameters->tracker_mode){
     case CommandLineParameters::TrackerMode::RGB_STEREO: {
       StereoFramePointGenerator* stereo_framepoint_generator = dynamic_cast<StereoFramePointGenerator*>(_tracker->framepointGenerator());
+  std::printf("   keypoint detection L | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_keypoint_detection(0)/_processing_time_total_seconds,
+                                                         stereo_framepoint_generator->getTimeConsumptionSeconds_keypoint_detection(0));
+  std::printf("   keypoint detection R | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_keypoint_detection(1)/_processing_time_total_seconds,
+                                                         stereo_framepoint_generator->getTimeConsumptionSeconds_keypoint_detection(1));
+  std::printf("descriptor extraction L | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_descriptor_extraction(0)/_processing_time_total_seconds,
+                                                         stereo_framepoint_generator->getTimeConsumptionSeconds_descriptor_extraction(0));
+  std::printf("descriptor extraction R | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_descriptor_extraction(1)/_processing_time_total_seconds,
+                                                         stereo_framepoint_generator->getTimeConsumptionSeconds_descriptor_extraction(1));
+  std::printf(" feature extraction L+R | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_feature_extraction()/_processing_time_total_seconds,
+                                                         stereo_framepoint_generator->getTimeConsumptionSeconds_feature_extraction());
   std::printf("        stereo matching | %f | %f\n", stereo_framepoint_generator->getTimeConsumptionSeconds_point_triangulation()/_processing_time_total_seconds,
                                                              stereo_framepoint_generator->getTimeConsumptionSeconds_point_triangulation());
       break;
@@ -723,12 +1358,32 @@ void SLAMAssembly::printReport() const {
   std::printf("    pose graph addition | %f | %f\n", _graph_optimizer->getTimeConsumptionSeconds_addition()/_processing_time_total_seconds, _graph_optimizer->getTimeConsumptionSeconds_addition());
   std::printf("pose graph optimization | %f | %f\n", _graph_optimizer->getTimeConsumptionSeconds_optimization()/_processing_time_total_seconds, _graph_optimizer->getTimeConsumptionSeconds_optimization());
   std::printf("       landmark merging | %f | %f\n", _world_map->getTimeConsumptionSeconds_landmark_merging()/_processing_time_total_seconds, _world_map->getTimeConsumptionSeconds_landmark_merging());
+  std::printf("        window eviction | %f | %f\n", _world_map->getTimeConsumptionSeconds_window_eviction()/_processing_time_total_seconds, _world_map->getTimeConsumptionSeconds_window_eviction());
+  std::cerr << BAR << std::endl;
+
+  //ds parallel loops on the shared thread pool (wall time, nested loops are contained in their enclosing loops)
+  std::cerr << std::endl;
+  std::cerr << "time consumption overview - thread pool (threads: " << _thread_pool->numberOfThreads()
+            << ", stolen tasks: " << _thread_pool->numberOfStolenTasks() << ")" << std::endl;
+  std::cerr << BAR << std::endl;
+  std::cerr << "                  stage | maximum threads | parallel loops | absolute (s)" << std::endl;
+  std::cerr << BAR << std::endl;
+  for (Index stage = 0; stage < ThreadPool::Stage::NUMBER_OF_STAGES; ++stage) {
+    const ThreadPool::Stage stage_type = static_cast<ThreadPool::Stage>(stage);
+    std::printf("%23s | %15u | %14u | %f\n", ThreadPool::stageName(stage_type),
+                                              _thread_pool->maximumParallelism(stage_type),
+                                              _thread_pool->numberOfParallelLoops(stage_type),
+                                              _thread_pool->timeConsumptionSecondsParallelLoops(stage_type));
+  }
   std::cerr << DOUBLE_BAR << std::endl;
 }
 
 void SLAMAssembly::reset() {
+  _stopRelocalizationThread();
   _synchronizer.reset();
   _processing_times_seconds.clear();
+  _frame_latencies_seconds.clear();
   _world_map->clear();
+  _startRelocalizationThread();
 }
 }
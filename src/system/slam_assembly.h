@@ -1,6 +1,10 @@
 #include "qapplication.h"
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 
 #include "srrg_messages/message_reader.h"
 #include "srrg_messages/message_timestamp_synchronizer.h"
@@ -11,6 +15,8 @@
 #include "visualization/image_viewer.h"
 #include "visualization/map_viewer.h"
 #include "framepoint_generation/stereo_framepoint_generator.h"
+#include "dataset_reader.h"
+#include "telemetry_recorder.h"
 
 namespace proslam {
 
@@ -32,6 +38,10 @@ public:
   //ds attempts to load the camera configuration based on the current input setting
   void loadCamerasFromMessageFile();
 
+  //! @brief attempts to load the camera configuration from a native dataset directory (KITTI, EuRoC, TUM RGB-D)
+  //! @brief falls back to the txt_io message file if the dataset is not a recognized directory
+  void loadCamerasFromDataset();
+
   //ds attempts to load the camera configuration based on the current input setting
   void loadCameras(Camera* camera_left_, Camera* camera_right_);
 
@@ -48,7 +58,16 @@ public:
   //! @param[in] file_name_ desired file name for the g2o outfile
   void writePoseGraphToFile(const std::string& file_name_ = "pose_graph.g2o") const;
 
-  //! @brief playback txt_io message file
+  //! @brief loads a prior map from a binary map file (requires loaded cameras and an empty map)
+  //! @brief the loaded local maps are added to the place database and the pose graph - the next processed frame can relocalize against them
+  //! @param[in] file_name_ binary map file (see WorldMap::read)
+  void loadMap(const std::string& file_name_);
+
+  //! @brief saves the current map to a binary map file
+  //! @param[in] file_name_ binary map file (see WorldMap::write)
+  void saveMap(const std::string& file_name_) const;
+
+  //! @brief playback txt_io message file (or native dataset directory if loaded with loadCamerasFromDataset)
   void playbackMessageFile();
 
   //! @brief thread wrapping
@@ -63,6 +82,9 @@ public:
                const bool& use_guess_ = false,
                const TransformMatrix3D& camera_left_in_world_guess_ = TransformMatrix3D::Identity());
 
+  //! @brief waits until all queued local maps are relocalized and integrates the remaining closures (asynchronous relocalization only)
+  void finishRelocalization();
+
   //ds prints extensive run summary
   void printReport() const;
 
@@ -92,7 +114,14 @@ public:
 
   void requestTermination() {_is_termination_requested = true;}
   const bool isViewerOpen() const {return _is_viewer_open;}
+  const bool isReadingDatasetDirectory() const {return _dataset_reader != nullptr;}
   const double currentFPS() const {return _current_fps;}
+  const Count& numberOfProcessedFrames() const {return _number_of_processed_frames;}
+  const double& processingTimeTotalSeconds() const {return _processing_time_total_seconds;}
+  const ThreadPool* threadPool() const {return _thread_pool;}
+  const PoseTracker3D* tracker() const {return _tracker;}
+  const Relocalizer* relocalizer() const {return _relocalizer;}
+  const GraphOptimizer* graphOptimizer() const {return _graph_optimizer;}
   const double averageNumberOfLandmarksPerFrame() const {return _tracker->totalNumberOfLandmarks()/_number_of_processed_frames;}
   const double averageNumberOfTracksPerFrame() const {return _tracker->totalNumberOfTrackedPoints()/_number_of_processed_frames;}
   const Count numberOfRecursiveRegistrations() const {return _tracker->numberOfRecursiveRegistrations();}
@@ -106,12 +135,88 @@ protected:
 
   void _createDepthTracker(Camera* camera_left_, Camera* camera_right_);
 
+  //! @brief adds the valid closures of the relocalizer to the world map and clears the relocalizer buffer
+  //! @param[in] local_map_query_ the local map for which the relocalizer computed the closures
+  //! @return number of added closures
+  const Count _addLoopClosures(LocalMap* local_map_query_);
+
+  //! @brief starts the relocalization background thread (asynchronous relocalization only)
+  void _startRelocalizationThread();
+
+  //! @brief stops the relocalization background thread (queued local maps and pending results are dropped)
+  void _stopRelocalizationThread();
+
+  //! @brief relocalization background thread: processes the local map queue
+  void _relocalizeInThread();
+
+  //! @brief retrieves the local map for which the background thread completed relocalization (closures are in the relocalizer buffer)
+  //! @param[in] wait_for_result_ blocks until a result is available or no more local maps are queued or processed
+  //! @return the query local map or nullptr if no result is available
+  LocalMap* _retrieveRelocalizationResult(const bool& wait_for_result_ = false);
+
+  //! @brief resumes the background thread after the last result has been integrated into the world map
+  void _releaseRelocalizationResult();
+
+//ds playback helpers
+protected:
+
+  //! @brief a synchronized and preprocessed stereo image pair, ready for processing
+  struct StereoImagePackage {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    cv::Mat image_left;
+    cv::Mat image_right;
+    double timestamp_image_left_seconds = 0;
+    bool has_odometry                   = false;
+    TransformMatrix3D robot_to_world    = TransformMatrix3D::Identity();
+
+    //! @brief image memory held by the package
+    const size_t bytes() const {return image_left.total()*image_left.elemSize()+image_right.total()*image_right.elemSize();}
+  };
+
+  //! @brief reads messages until a synchronized stereo image pair is available, then decodes and preprocesses the images
+  //! @return the stereo image pair (owned by the caller) or nullptr if the message file is exhausted or termination is requested
+  StereoImagePackage* _readStereoImages();
+
+  //! @brief retrieves the next stereo image pair from the prefetching reader thread if active, otherwise reads it directly
+  //! @brief image pairs are skipped here if frame drops are injected (image_drop_interval)
+  StereoImagePackage* _nextStereoImages();
+
+  //! @brief applies the configured image preprocessing (histogram equalization)
+  void _preprocessStereoImages(StereoImagePackage* stereo_images_) const;
+
+  //! @brief starts the prefetching reader thread (prefetching only)
+  void _startPrefetchThread();
+
+  //! @brief stops the prefetching reader thread and drops remaining prefetched image pairs
+  void _stopPrefetchThread();
+
+  //! @brief prefetching reader thread: fills the image queue until the message file is exhausted
+  void _prefetchInThread();
+
+  //! @brief retrieves the accumulated time consumption of all modules per telemetry stage
+  //! @param[out] stage_seconds_ module chronometer totals (relocalization is only sampled if it runs synchronously)
+  void _sampleStageTimes(double stage_seconds_[TelemetryRecorder::NUMBER_OF_STAGES]) const;
+
+  //! @brief current resident set size of the process in MB (0 if not available)
+  static double _residentMemoryMegabytes();
+
+  //! @brief peak resident set size of the process in MB (0 if not available)
+  static double _peakResidentMemoryMegabytes();
+
+  //! @brief retrieves the next prefetched stereo image pair, blocks until one is available
+  //! @return the stereo image pair (owned by the caller) or nullptr if the reader thread completed
+  //! @throws the error of the reader thread if it stopped on one (as the direct reading would)
+  StereoImagePackage* _retrievePrefetchedStereoImages();
+
 //ds SLAM modules
 protected:
 
   //! @brief all configurable system parameters
   ParameterCollection* _parameters;
 
+  //! @brief shared thread pool, passed to all modules (owned)
+  ThreadPool* _thread_pool;
+
   //ds the SLAM map, containing landmarks and trajectory
   WorldMap* _world_map;
 
@@ -128,7 +233,27 @@ protected:
   Camera* _camera_left;
   Camera* _camera_right;
 
-  Identifier _last_freed_landmark_identifier = 0;
+//ds asynchronous relocalization
+protected:
+
+  //! @brief relocalization background thread (only active in asynchronous relocalization mode)
+  std::shared_ptr<std::thread> _relocalization_thread = nullptr;
+
+  //! @brief local maps waiting for relocalization
+  std::deque<LocalMap*> _local_maps_to_relocalize;
+
+  //! @brief local map for which relocalization results are ready to be integrated (the thread waits until they are consumed)
+  LocalMap* _relocalized_local_map = nullptr;
+
+  //! @brief set while the background thread processes a local map
+  bool _is_relocalization_running = false;
+
+  //! @brief termination request for the background thread
+  bool _is_relocalization_termination_requested = false;
+
+  //! @brief synchronization of the above
+  std::mutex _relocalization_mutex;
+  std::condition_variable _relocalization_condition;
 
 //ds visualization only
 protected:
@@ -151,9 +276,34 @@ protected:
   //! @brief srrg message parser
   srrg_core::MessageReader _message_reader;
 
+  //! @brief native dataset directory reader (replaces the message parser if set)
+  DatasetReader* _dataset_reader = nullptr;
+
   //ds txt_io message synchronizer
   srrg_core::MessageTimestampSynchronizer _synchronizer;
 
+  //! @brief prefetching reader thread (only active during playback with prefetching)
+  std::shared_ptr<std::thread> _prefetch_thread = nullptr;
+
+  //! @brief decoded stereo image pairs waiting for processing
+  std::deque<StereoImagePackage*> _prefetched_stereo_images;
+
+  //! @brief image memory currently held by the queue
+  size_t _prefetched_bytes = 0;
+
+  //! @brief set by the reader thread once the message file is exhausted
+  bool _is_prefetching_completed = false;
+
+  //! @brief termination request for the reader thread
+  bool _is_prefetch_termination_requested = false;
+
+  //! @brief error of the reader thread (if any), rethrown on the main thread once all image pairs read before it are processed
+  std::exception_ptr _prefetch_exception = nullptr;
+
+  //! @brief synchronization of the above
+  std::mutex _prefetch_mutex;
+  std::condition_variable _prefetch_condition;
+
   //! @brief termination check - terminates processing loop
   std::atomic<bool> _is_termination_requested;
 
@@ -169,10 +319,20 @@ protected:
   //! @brief frame-wise processing times
   std::vector<double> _processing_times_seconds;
 
+  //! @brief frame-wise latencies from feature extraction start to processing end (differ from processing times in pipelined processing)
+  std::vector<double> _frame_latencies_seconds;
+
   //! @brief total number of processed frames
   Count _number_of_processed_frames = 0;
 
+  //! @brief number of retrieved and skipped (injected frame drops) image pairs during playback
+  Count _number_of_retrieved_stereo_images = 0;
+  Count _number_of_dropped_stereo_images   = 0;
+
   //! @brief current average fps
   double _current_fps = 0;
+
+  //! @brief per-frame telemetry stream (only active during playback if a telemetry file is set)
+  TelemetryRecorder _telemetry;
 };
 }
@@ -0,0 +1,191 @@
+#include "telemetry_recorder.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace proslam {
+
+TelemetryRecorder::~TelemetryRecorder() {
+  if (_outfile.is_open()) {
+    _outfile.close();
+  }
+}
+
+void TelemetryRecorder::open(const std::string& file_name_) {
+  _outfile.open(file_name_, std::ofstream::out);
+  if (!_outfile.good()) {
+    LOG_ERROR(std::cerr << "TelemetryRecorder::open|unable to open file: '" << file_name_ << "'" << std::endl)
+    throw std::runtime_error("unable to open telemetry file");
+  }
+  _records.clear();
+
+  //ds summary next to the CSV stream (replacing the extension if available)
+  const size_t index_extension = file_name_.find_last_of('.');
+  const size_t index_directory = file_name_.find_last_of('/');
+  if (index_extension != std::string::npos && (index_directory == std::string::npos || index_extension > index_directory)) {
+    _file_name_summary = file_name_.substr(0, index_extension)+"_summary.json";
+  } else {
+    _file_name_summary = file_name_+"_summary.json";
+  }
+
+  //ds column header
+  _outfile << "frame,timestamp_seconds,processing_time_seconds,latency_seconds";
+  for (Index stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+    _outfile << "," << stageName(static_cast<Stage>(stage)) << "_seconds";
+  }
+  _outfile << ",status,detected_keypoints,framepoints,tracked_points,tracked_landmarks,created_points,recovered_points"
+              ",recursive_registrations,aligner_iterations,aligner_inlier_ratio,local_map_created,added_closures"
+              ",bundle_adjustment,landmarks,local_maps,frames,resident_memory_megabytes\n";
+  LOG_INFO(std::cerr << "TelemetryRecorder::open|streaming frame telemetry to: '" << file_name_ << "'" << std::endl)
+}
+
+void TelemetryRecorder::add(const FrameRecord& record_) {
+  if (!_outfile.is_open()) {
+    return;
+  }
+  _records.push_back(record_);
+
+  //ds stream the record right away (data of aborted runs is kept)
+  char buffer[128];
+  std::snprintf(buffer, sizeof(buffer), "%u,%.6f,%.6f,%.6f", record_.frame_identifier, record_.timestamp_seconds,
+                                                              record_.processing_time_seconds, record_.latency_seconds);
+  _outfile << buffer;
+  for (Index stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+    std::snprintf(buffer, sizeof(buffer), ",%.6f", record_.stage_seconds[stage]);
+    _outfile << buffer;
+  }
+  std::snprintf(buffer, sizeof(buffer), ",%s,%u,%u,%u,%u,%u,%u,%u,%u,%.4f,%u,%u,%u,%u,%u\n",
+                (record_.status == Frame::Tracking) ? "TRACKING" : "LOCALIZING",
+                record_.number_of_detected_keypoints,
+                record_.number_of_framepoints,
+                record_.number_of_tracked_points,
+                record_.number_of_tracked_landmarks,
+                record_.number_of_created_points,
+                record_.number_of_recovered_points,
+                record_.number_of_recursive_registrations,
+                record_.number_of_aligner_iterations,
+                record_.aligner_inlier_ratio,
+                record_.is_local_map_created,
+                record_.number_of_added_closures,
+                record_.is_bundle_adjustment_performed,
+                record_.number_of_landmarks,
+                record_.number_of_local_maps,
+                record_.number_of_frames,
+                record_.resident_memory_megabytes);
+  _outfile << buffer;
+}
+
+void TelemetryRecorder::close(const Count& number_of_slowest_frames_) {
+  if (!_outfile.is_open()) {
+    return;
+  }
+  _outfile.close();
+  std::ofstream outfile(_file_name_summary, std::ofstream::out);
+  if (!outfile.good()) {
+    LOG_ERROR(std::cerr << "TelemetryRecorder::close|unable to open file: '" << _file_name_summary << "'" << std::endl)
+    throw std::runtime_error("unable to open telemetry summary file");
+  }
+
+  //ds percentiles of the sorted values (nearest rank)
+  auto percentile = [](const std::vector<double>& values_sorted_, const double& percentile_) {
+    if (values_sorted_.empty()) {
+      return 0.0;
+    }
+    const size_t index = std::min(static_cast<size_t>(percentile_*values_sorted_.size()), values_sorted_.size()-1);
+    return values_sorted_[index];
+  };
+  auto write_percentiles = [&outfile, &percentile](const char* name_, std::vector<double>& values_) {
+    std::sort(values_.begin(), values_.end());
+    double total = 0;
+    for (const double& value: values_) {
+      total += value;
+    }
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "\"%s\":{\"mean\":%.6f,\"p50\":%.6f,\"p90\":%.6f,\"p95\":%.6f,\"p99\":%.6f,\"max\":%.6f}",
+                  name_, (values_.empty()) ? 0 : total/values_.size(),
+                  percentile(values_, 0.5), percentile(values_, 0.9), percentile(values_, 0.95), percentile(values_, 0.99), percentile(values_, 1.0));
+    outfile << buffer;
+  };
+
+  //ds overall distributions
+  std::vector<double> processing_times_seconds;
+  std::vector<double> latencies_seconds;
+  processing_times_seconds.reserve(_records.size());
+  latencies_seconds.reserve(_records.size());
+  for (const FrameRecord& record: _records) {
+    processing_times_seconds.push_back(record.processing_time_seconds);
+    latencies_seconds.push_back(record.latency_seconds);
+  }
+  outfile << "{\n\"number_of_frames\":" << _records.size() << ",\n";
+  write_percentiles("processing_time_seconds", processing_times_seconds);
+  outfile << ",\n";
+  write_percentiles("latency_seconds", latencies_seconds);
+  outfile << ",\n\"stage_seconds\":{\n";
+  for (Index stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+    std::vector<double> stage_seconds;
+    stage_seconds.reserve(_records.size());
+    for (const FrameRecord& record: _records) {
+      stage_seconds.push_back(record.stage_seconds[stage]);
+    }
+    write_percentiles(stageName(static_cast<Stage>(stage)), stage_seconds);
+    outfile << ((stage+1 < NUMBER_OF_STAGES) ? ",\n" : "\n");
+  }
+  outfile << "},\n";
+
+  //ds slowest frames with their stages ordered by time consumption
+  std::vector<const FrameRecord*> records_by_processing_time;
+  records_by_processing_time.reserve(_records.size());
+  for (const FrameRecord& record: _records) {
+    records_by_processing_time.push_back(&record);
+  }
+  const Count number_of_slowest_frames = std::min(number_of_slowest_frames_, static_cast<Count>(_records.size()));
+  std::partial_sort(records_by_processing_time.begin(), records_by_processing_time.begin()+number_of_slowest_frames, records_by_processing_time.end(),
+                    [](const FrameRecord* a_, const FrameRecord* b_) {return a_->processing_time_seconds > b_->processing_time_seconds;});
+  outfile << "\"slowest_frames\":[\n";
+  char buffer[256];
+  for (Index index = 0; index < number_of_slowest_frames; ++index) {
+    const FrameRecord* record = records_by_processing_time[index];
+    std::snprintf(buffer, sizeof(buffer), "{\"frame\":%u,\"processing_time_seconds\":%.6f,\"latency_seconds\":%.6f,\"tracked_points\":%u,"
+                                          "\"recursive_registrations\":%u,\"local_map_created\":%s,\"added_closures\":%u,\"bundle_adjustment\":%s,\"stages\":[",
+                  record->frame_identifier, record->processing_time_seconds, record->latency_seconds, record->number_of_tracked_points,
+                  record->number_of_recursive_registrations, (record->is_local_map_created) ? "true" : "false",
+                  record->number_of_added_closures, (record->is_bundle_adjustment_performed) ? "true" : "false");
+    outfile << buffer;
+
+    //ds attribute the frame time to its stages (most expensive first, empty stages omitted)
+    std::vector<Index> stages;
+    for (Index stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+      if (record->stage_seconds[stage] > 0) {
+        stages.push_back(stage);
+      }
+    }
+    std::sort(stages.begin(), stages.end(), [&record](const Index& a_, const Index& b_) {return record->stage_seconds[a_] > record->stage_seconds[b_];});
+    for (Index index_stage = 0; index_stage < stages.size(); ++index_stage) {
+      std::snprintf(buffer, sizeof(buffer), "%s{\"stage\":\"%s\",\"seconds\":%.6f}", (index_stage > 0) ? "," : "",
+                    stageName(static_cast<Stage>(stages[index_stage])), record->stage_seconds[stages[index_stage]]);
+      outfile << buffer;
+    }
+    outfile << ((index+1 < number_of_slowest_frames) ? "]},\n" : "]}\n");
+  }
+  outfile << "]\n}\n";
+  outfile.close();
+  LOG_INFO(std::cerr << "TelemetryRecorder::close|saved telemetry of frames: " << _records.size() << " (summary: '" << _file_name_summary << "')" << std::endl)
+}
+
+const char* TelemetryRecorder::stageName(const Stage& stage_) {
+  switch (stage_) {
+    case Stage::FEATURE_EXTRACTION:      {return "feature_extraction";}
+    case Stage::TRACKING:                {return "tracking";}
+    case Stage::POSE_OPTIMIZATION:       {return "pose_optimization";}
+    case Stage::POINT_RECOVERY:          {return "point_recovery";}
+    case Stage::LANDMARK_OPTIMIZATION:   {return "landmark_optimization";}
+    case Stage::TRACK_CREATION:          {return "track_creation";}
+    case Stage::RELOCALIZATION:          {return "relocalization";}
+    case Stage::POSE_GRAPH_ADDITION:     {return "pose_graph_addition";}
+    case Stage::POSE_GRAPH_OPTIMIZATION: {return "pose_graph_optimization";}
+    case Stage::LANDMARK_MERGING:        {return "landmark_merging";}
+    case Stage::WINDOW_EVICTION:         {return "window_eviction";}
+    default:                             {return "unknown";}
+  }
+}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <fstream>
+#include "types/frame.h"
+
+namespace proslam {
+
+//! @class per-frame telemetry: one record per processed frame is streamed as CSV line, a JSON summary is written at the end of the run
+//! @class the summary contains processing time and latency percentiles and the slowest frames with their most expensive stages
+class TelemetryRecorder {
+
+//ds object management
+public: EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! @brief constructor
+  TelemetryRecorder() {}
+
+  //! @brief destructor - closes the CSV stream
+  ~TelemetryRecorder();
+
+//ds exported types
+public:
+
+  //! @brief processing stages with per-frame time attribution (derived from the module chronometers)
+  enum Stage {FEATURE_EXTRACTION,
+              TRACKING,
+              POSE_OPTIMIZATION,
+              POINT_RECOVERY,
+              LANDMARK_OPTIMIZATION,
+              TRACK_CREATION,
+              RELOCALIZATION,
+              POSE_GRAPH_ADDITION,
+              POSE_GRAPH_OPTIMIZATION,
+              LANDMARK_MERGING,
+              WINDOW_EVICTION,
+              NUMBER_OF_STAGES};
+
+  //! @brief telemetry of a single processed frame
+  struct FrameRecord {
+    Identifier frame_identifier             = 0;
+    double timestamp_seconds                = 0;
+    double processing_time_seconds          = 0;
+    double latency_seconds                  = 0;
+    double stage_seconds[NUMBER_OF_STAGES] = {0};
+    Frame::Status status                    = Frame::Localizing;
+    Count number_of_detected_keypoints      = 0;
+    Count number_of_framepoints             = 0;
+    Count number_of_tracked_points          = 0;
+    Count number_of_tracked_landmarks       = 0;
+    Count number_of_created_points          = 0;
+    Count number_of_recovered_points        = 0;
+    Count number_of_recursive_registrations = 0;
+    Count number_of_aligner_iterations      = 0;
+    real aligner_inlier_ratio               = 0;
+    bool is_local_map_created               = false;
+    Count number_of_added_closures          = 0;
+    bool is_bundle_adjustment_performed     = false;
+    Count number_of_landmarks               = 0;
+    Count number_of_local_maps              = 0;
+    Count number_of_frames                  = 0;
+    double resident_memory_megabytes        = 0;
+  };
+
+//ds functionality
+public:
+
+  //! @brief opens the CSV stream and writes the column header (throws on failure)
+  //! @param[in] file_name_ CSV file, the summary is written next to it with the suffix _summary.json
+  void open(const std::string& file_name_);
+
+  //! @brief streams a frame record and keeps it for the summary
+  void add(const FrameRecord& record_);
+
+  //! @brief closes the CSV stream and writes the JSON summary (no effect if not opened)
+  //! @param[in] number_of_slowest_frames_ number of slowest frames listed in the summary
+  void close(const Count& number_of_slowest_frames_);
+
+  //! @brief stage name for CSV columns and the summary
+  static const char* stageName(const Stage& stage_);
+
+//ds getters/setters
+public:
+
+  const bool isOpen() const {return _outfile.is_open();}
+  const std::vector<FrameRecord>& records() const {return _records;}
+
+//ds attributes
+protected:
+
+  //! @brief CSV stream
+  std::ofstream _outfile;
+
+  //! @brief target file of the JSON summary
+  std::string _file_name_summary = "";
+
+  //! @brief all records of the run (summary input)
+  std::vector<FrameRecord> _records;
+};
+}
@@ -20,6 +20,7 @@
 
 #include "srrg_system_utils/system_utils.h"
 #include "srrg_types/types.hpp"
+#include "profiler.h"
 
 namespace proslam {
 
@@ -50,6 +51,13 @@ namespace proslam {
   //ds adjust floating point precision
   typedef double real;
 
+  //ds floating point precision of the packed pose aligner buffers (the linear system is always accumulated in real)
+#ifdef SRRG_PROSLAM_ALIGNER_SINGLE_PRECISION
+  typedef float AlignerScalar;
+#else
+  typedef double AlignerScalar;
+#endif
+
   //ds existential types
   typedef Eigen::Matrix<real, 3, 1> PointCoordinates;
   typedef std::vector<PointCoordinates, Eigen::aligned_allocator<PointCoordinates>> PointCoordinatesVector;
@@ -112,12 +120,26 @@ namespace proslam {
                      Warning = 2,
                      Error   = 3};
 
-  //ds timing
+  //ds profiling: scoped spans recorded per frame (compiled out if SRRG_PROSLAM_ENABLE_PROFILER is not defined)
+#ifdef SRRG_PROSLAM_ENABLE_PROFILER
+  #define PROFILER_SPAN(NAME) proslam::Profiler::Span profiler_span_##NAME(#NAME, __PRETTY_FUNCTION__);
+  #define PROFILER_SPAN_STOP(NAME) profiler_span_##NAME.stop();
+#else
+  #define PROFILER_SPAN(NAME)
+  #define PROFILER_SPAN_STOP(NAME)
+#endif
+
+  //ds timing: accumulated total per chronometer, each measurement is additionally recorded as profiler span (timed by the span if compiled in)
   #define CREATE_CHRONOMETER(NAME) \
   protected: double _time_consumption_seconds_##NAME = 0; \
   public: const double getTimeConsumptionSeconds_##NAME() const {return _time_consumption_seconds_##NAME;}
+#ifdef SRRG_PROSLAM_ENABLE_PROFILER
+  #define CHRONOMETER_START(NAME) PROFILER_SPAN(NAME)
+  #define CHRONOMETER_STOP(NAME) _time_consumption_seconds_##NAME += profiler_span_##NAME.stop();
+#else
   #define CHRONOMETER_START(NAME) const double time_start_seconds_##NAME = srrg_core::getTime();
   #define CHRONOMETER_STOP(NAME) _time_consumption_seconds_##NAME += srrg_core::getTime()-time_start_seconds_##NAME;
+#endif
 
   //ds print functions
   #define        BAR "---------------------------------------------------------------------------------------------------------------------------------"
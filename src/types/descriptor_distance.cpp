@@ -0,0 +1,226 @@
+#include "descriptor_distance.h"
+#include <cstring>
+
+//ds instruction set specific kernels: x86 kernels are compiled with function level target attributes and selected at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_X86
+  #include <immintrin.h>
+
+  //ds AVX-512 VPOPCNTDQ intrinsics and runtime detection require a recent compiler
+  #if (defined(__clang__) && __clang_major__ >= 8) || (!defined(__clang__) && __GNUC__ >= 8)
+    #define SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_AVX512_VPOPCNTDQ
+  #endif
+
+//ds NEON is enabled at compile time (e.g. -mfpu=neon-vfpv4 for armv7l)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_NEON
+  #include <arm_neon.h>
+#endif
+
+namespace proslam {
+
+//ds descriptor layout in 64 bit blocks
+static constexpr uint32_t number_of_blocks_64 = SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/64;
+
+//ds loads a 64 bit block without alignment or aliasing requirements
+static inline uint64_t loadBlock64(const uint8_t* data_) {
+  uint64_t block;
+  std::memcpy(&block, data_, sizeof(uint64_t));
+  return block;
+}
+
+//ds portable bit counting (SWAR), no instruction set requirements
+static uint32_t computeScalar(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  uint32_t distance = 0;
+  for (uint32_t u = 0; u < number_of_blocks_64; ++u) {
+    uint64_t x = loadBlock64(descriptor_a_+8*u)^loadBlock64(descriptor_b_+8*u);
+    x = x-((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL)+((x >> 2) & 0x3333333333333333ULL);
+    x = (x+(x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    distance += (x*0x0101010101010101ULL) >> 56;
+  }
+  return distance;
+}
+
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_X86
+//ds hardware popcount on 64 bit blocks
+__attribute__((target("popcnt")))
+static uint32_t computePOPCNT(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  uint32_t distance = 0;
+  for (uint32_t u = 0; u < number_of_blocks_64; ++u) {
+    distance += __builtin_popcountll(loadBlock64(descriptor_a_+8*u)^loadBlock64(descriptor_b_+8*u));
+  }
+  return distance;
+}
+
+//ds nibble lookup popcount on 256 bit blocks (remaining 64 bit blocks with hardware popcount)
+__attribute__((target("avx2,popcnt")))
+static uint32_t computeAVX2(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  constexpr uint32_t number_of_blocks_256 = SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/256;
+  const __m256i lookup   = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i mask_low = _mm256_set1_epi8(0x0f);
+  __m256i accumulator    = _mm256_setzero_si256();
+  for (uint32_t u = 0; u < number_of_blocks_256; ++u) {
+    const __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor_a_+32*u)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor_b_+32*u)));
+    const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(x, mask_low)),
+                                           _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask_low)));
+    accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+  alignas(32) uint64_t sums[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(sums), accumulator);
+  uint32_t distance = sums[0]+sums[1]+sums[2]+sums[3];
+  for (uint32_t u = 4*number_of_blocks_256; u < number_of_blocks_64; ++u) {
+    distance += __builtin_popcountll(loadBlock64(descriptor_a_+8*u)^loadBlock64(descriptor_b_+8*u));
+  }
+  return distance;
+}
+
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_AVX512_VPOPCNTDQ
+//ds native 64 bit lane popcount on 512 bit blocks (remaining blocks with a masked load)
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static uint32_t computeAVX512VPOPCNTDQ(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  constexpr uint32_t number_of_blocks_512 = SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/512;
+  constexpr uint32_t number_of_blocks_remaining = number_of_blocks_64-8*number_of_blocks_512;
+  __m512i accumulator = _mm512_setzero_si512();
+  for (uint32_t u = 0; u < number_of_blocks_512; ++u) {
+    const __m512i x = _mm512_xor_si512(_mm512_loadu_si512(descriptor_a_+64*u), _mm512_loadu_si512(descriptor_b_+64*u));
+    accumulator = _mm512_add_epi64(accumulator, _mm512_popcnt_epi64(x));
+  }
+  if (number_of_blocks_remaining > 0) {
+    const __mmask8 mask = static_cast<__mmask8>((1u << number_of_blocks_remaining)-1);
+    const __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi64(mask, descriptor_a_+64*number_of_blocks_512),
+                                       _mm512_maskz_loadu_epi64(mask, descriptor_b_+64*number_of_blocks_512));
+    accumulator = _mm512_add_epi64(accumulator, _mm512_popcnt_epi64(x));
+  }
+  alignas(64) uint64_t sums[8];
+  _mm512_store_si512(sums, accumulator);
+  return sums[0]+sums[1]+sums[2]+sums[3]+sums[4]+sums[5]+sums[6]+sums[7];
+}
+#endif
+#endif
+
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_NEON
+//ds byte-wise popcount on 128 bit blocks with pairwise widening accumulation
+static uint32_t computeNEON(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  constexpr uint32_t number_of_blocks_128 = SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/128;
+  uint64x2_t accumulator = vdupq_n_u64(0);
+  for (uint32_t u = 0; u < number_of_blocks_128; ++u) {
+    const uint8x16_t x = veorq_u8(vld1q_u8(descriptor_a_+16*u), vld1q_u8(descriptor_b_+16*u));
+    accumulator = vaddq_u64(accumulator, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(x)))));
+  }
+  uint32_t distance = vgetq_lane_u64(accumulator, 0)+vgetq_lane_u64(accumulator, 1);
+  if (2*number_of_blocks_128 < number_of_blocks_64) {
+    const uint8x8_t x = veor_u8(vld1_u8(descriptor_a_+16*number_of_blocks_128), vld1_u8(descriptor_b_+16*number_of_blocks_128));
+    distance += vget_lane_u64(vpaddl_u32(vpaddl_u16(vpaddl_u8(vcnt_u8(x)))), 0);
+  }
+  return distance;
+}
+#endif
+
+//ds start with the portable kernel (constant initialization, valid before any dynamic initialization)
+DescriptorDistance::Kernel DescriptorDistance::_kernel          = computeScalar;
+DescriptorDistance::KernelType DescriptorDistance::_kernel_type = DescriptorDistance::SCALAR;
+
+//ds switch to the best supported kernel at startup
+struct DescriptorDistanceKernelSelection {
+  DescriptorDistanceKernelSelection() {
+    DescriptorDistance::setKernel(DescriptorDistance::bestSupportedKernel());
+  }
+} descriptor_distance_kernel_selection;
+
+const std::string DescriptorDistance::kernelName(const KernelType& kernel_type_) {
+  switch (kernel_type_) {
+    case SCALAR:           return "SCALAR";
+    case POPCNT:           return "POPCNT";
+    case AVX2:             return "AVX2";
+    case AVX512_VPOPCNTDQ: return "AVX512_VPOPCNTDQ";
+    case NEON:             return "NEON";
+    default:               return "UNKNOWN";
+  }
+}
+
+const bool DescriptorDistance::isSupported(const KernelType& kernel_type_) {
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_X86
+  __builtin_cpu_init();
+#endif
+  switch (kernel_type_) {
+    case SCALAR: {
+      return true;
+    }
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_X86
+    case POPCNT: {
+      return __builtin_cpu_supports("popcnt");
+    }
+    case AVX2: {
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_AVX512_VPOPCNTDQ
+    case AVX512_VPOPCNTDQ: {
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+    }
+#endif
+#endif
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_NEON
+    case NEON: {
+      return true;
+    }
+#endif
+    default: {
+      return false;
+    }
+  }
+}
+
+void DescriptorDistance::setKernel(const KernelType& kernel_type_) {
+  if (!isSupported(kernel_type_)) {
+    throw std::runtime_error("DescriptorDistance::setKernel|kernel not supported on this machine: " + kernelName(kernel_type_));
+  }
+  switch (kernel_type_) {
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_X86
+    case POPCNT: {
+      _kernel = computePOPCNT;
+      break;
+    }
+    case AVX2: {
+      _kernel = computeAVX2;
+      break;
+    }
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_AVX512_VPOPCNTDQ
+    case AVX512_VPOPCNTDQ: {
+      _kernel = computeAVX512VPOPCNTDQ;
+      break;
+    }
+#endif
+#endif
+#ifdef SRRG_PROSLAM_DESCRIPTOR_DISTANCE_HAS_NEON
+    case NEON: {
+      _kernel = computeNEON;
+      break;
+    }
+#endif
+    default: {
+      _kernel = computeScalar;
+      break;
+    }
+  }
+  _kernel_type = kernel_type_;
+}
+
+const DescriptorDistance::KernelType DescriptorDistance::bestSupportedKernel() {
+
+  //ds for small descriptors the plain hardware popcount beats the AVX2 nibble lookup
+  if (isSupported(AVX512_VPOPCNTDQ)) {
+    return AVX512_VPOPCNTDQ;
+  } else if (isSupported(AVX2) && SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS >= 512) {
+    return AVX2;
+  } else if (isSupported(POPCNT)) {
+    return POPCNT;
+  } else if (isSupported(NEON)) {
+    return NEON;
+  } else {
+    return SCALAR;
+  }
+}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstring>
+#include <type_traits>
+#include "definitions.h"
+
+namespace proslam {
+
+//ds the kernels process the descriptors in 64 bit blocks
+static_assert(SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS%64 == 0, "SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS must be a multiple of 64");
+
+//! @struct fixed size binary descriptor (SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS) stored by value in 64 bit blocks
+//! trivially copyable without heap allocation or reference counting, replacing single row cv::Mat views on the extracted descriptor matrix
+//! (which keep the complete matrix of the image alive) from feature extraction over framepoints and landmarks to the HBST insertion
+struct BinaryDescriptor {
+
+  BinaryDescriptor() = default;
+
+  //! @brief copies the descriptor from an extracted descriptor row (CV_8U, DESCRIPTOR_SIZE_BYTES)
+  explicit BinaryDescriptor(const cv::Mat& descriptor_) {
+    assert(descriptor_.rows == 1 && descriptor_.cols == DESCRIPTOR_SIZE_BYTES && descriptor_.type() == CV_8U);
+    std::memcpy(blocks, descriptor_.data, DESCRIPTOR_SIZE_BYTES);
+  }
+
+  //! @brief raw descriptor bytes (DESCRIPTOR_SIZE_BYTES)
+  inline const uint8_t* data() const {return reinterpret_cast<const uint8_t*>(blocks);}
+
+  //! @brief read-only single row cv::Mat header on the descriptor data (no copy, valid as long as this descriptor)
+  inline const cv::Mat toMat() const {return cv::Mat(1, DESCRIPTOR_SIZE_BYTES, CV_8U, const_cast<uint64_t*>(blocks));}
+
+  uint64_t blocks[SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/64];
+};
+static_assert(sizeof(BinaryDescriptor) == DESCRIPTOR_SIZE_BYTES, "BinaryDescriptor must not contain padding");
+static_assert(std::is_trivially_copyable<BinaryDescriptor>::value, "BinaryDescriptor must be trivially copyable");
+typedef std::vector<BinaryDescriptor> BinaryDescriptorVector;
+
+//! @class binary descriptor distance (Hamming) computation for fixed size descriptors (SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS)
+//! the fastest kernel supported by the cpu is selected once at startup, replacing the generic cv::norm calls
+class DescriptorDistance {
+
+//ds exported types
+public:
+
+  //! @brief available kernels (x86 kernels are selected by runtime cpu detection, NEON at compile time)
+  enum KernelType {SCALAR           = 0,
+                   POPCNT           = 1,
+                   AVX2             = 2,
+                   AVX512_VPOPCNTDQ = 3,
+                   NEON             = 4};
+
+  //! @brief kernel signature: raw descriptor data pointers with DESCRIPTOR_SIZE_BYTES each
+  typedef uint32_t (*Kernel)(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_);
+
+//ds functionality
+public:
+
+  //! @brief computes the Hamming distance between two descriptors
+  //! @param[in] descriptor_a_ first descriptor (single row, DESCRIPTOR_SIZE_BYTES)
+  //! @param[in] descriptor_b_ second descriptor (single row, DESCRIPTOR_SIZE_BYTES)
+  //! @return number of differing bits
+  static inline uint32_t compute(const cv::Mat& descriptor_a_, const cv::Mat& descriptor_b_) {
+    assert(descriptor_a_.cols == DESCRIPTOR_SIZE_BYTES && descriptor_b_.cols == DESCRIPTOR_SIZE_BYTES);
+    assert(descriptor_a_.type() == CV_8U && descriptor_b_.type() == CV_8U);
+    return _kernel(descriptor_a_.data, descriptor_b_.data);
+  }
+
+  //! @brief computes the Hamming distance between two fixed size descriptors
+  static inline uint32_t compute(const BinaryDescriptor& descriptor_a_, const BinaryDescriptor& descriptor_b_) {
+    return _kernel(descriptor_a_.data(), descriptor_b_.data());
+  }
+
+  //! @brief computes the Hamming distance between two raw descriptors
+  static inline uint32_t compute(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+    return _kernel(descriptor_a_, descriptor_b_);
+  }
+
+//ds getters/setters
+public:
+
+  //! @brief currently active kernel
+  static const KernelType& kernelType() {return _kernel_type;}
+
+  //! @brief readable kernel name
+  static const std::string kernelName(const KernelType& kernel_type_);
+
+  //! @brief checks whether a kernel can be executed on this machine
+  static const bool isSupported(const KernelType& kernel_type_);
+
+  //! @brief forces a specific kernel (e.g. for benchmarking), throws if not supported
+  static void setKernel(const KernelType& kernel_type_);
+
+  //! @brief retrieves the best supported kernel on this machine
+  static const KernelType bestSupportedKernel();
+
+//ds attributes
+private:
+
+  //! @brief active kernel function and type (initialized with the best supported kernel at startup)
+  static Kernel _kernel;
+  static KernelType _kernel_type;
+};
+}
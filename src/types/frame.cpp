@@ -25,6 +25,17 @@ Frame::Frame(const WorldMap* context_,
   clear();
 }
 
+Frame::Frame(const Identifier& identifier_,
+             const TransformMatrix3D& robot_to_world_,
+             const double& timestamp_image_left_seconds_): _identifier(identifier_),
+                                                           _timestamp_image_left_seconds(timestamp_image_left_seconds_),
+                                                           _local_map(nullptr),
+                                                           _root(this) {
+  _instances = std::max(_instances, _identifier+1);
+  setRobotToWorld(robot_to_world_);
+  clear();
+}
+
 Frame::~Frame() {
   clear();
 }
@@ -66,7 +77,7 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
   assert(_camera_left);
 
   //ds allocate a new point connected to the previous one
-  FramePoint* frame_point = new FramePoint(feature_left_, feature_right_, descriptor_distance_triangulation_, this);
+  FramePoint* frame_point = _framepoint_arena.create(feature_left_, feature_right_, descriptor_distance_triangulation_, this);
   frame_point->setCameraCoordinatesLeft(camera_coordinates_left_);
   frame_point->setRobotCoordinates(_camera_left->cameraToRobot()*camera_coordinates_left_);
   frame_point->setWorldCoordinates(_robot_to_world*frame_point->robotCoordinates());
@@ -77,9 +88,6 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
   } else {
     frame_point->setOrigin(frame_point);
   }
-
-  //ds bookkeep each generated point for resize immune memory management (TODO remove costly bookkeeping)
-  _created_points.push_back(frame_point);
   return frame_point;
 }
 
@@ -89,7 +97,7 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
   assert(_camera_left);
 
   //ds allocate a new point connected to the previous one
-  FramePoint* frame_point = new FramePoint(feature_left_, this);
+  FramePoint* frame_point = _framepoint_arena.create(feature_left_, this);
   frame_point->setCameraCoordinatesLeft(camera_coordinates_left_);
   frame_point->setRobotCoordinates(_camera_left->cameraToRobot()*camera_coordinates_left_);
   frame_point->setWorldCoordinates(_robot_to_world*frame_point->robotCoordinates());
@@ -100,9 +108,6 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
   } else {
     frame_point->setOrigin(frame_point);
   }
-
-  //ds bookkeep each generated point for resize immune memory management (TODO remove costly bookkeeping)
-  _created_points.push_back(frame_point);
   return frame_point;
 }
 
@@ -111,7 +116,7 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
   assert(_camera_left);
 
   //ds allocate a new point connected to the previous one
-  FramePoint* frame_point = new FramePoint(feature_left_, this);
+  FramePoint* frame_point = _framepoint_arena.create(feature_left_, this);
 
   //ds the point does not have a valid position yet
   frame_point->_has_unreliable_depth = true;
@@ -123,19 +128,13 @@ FramePoint* Frame::createFramepoint(const IntensityFeature* feature_left_,
     frame_point->setOrigin(frame_point);
   }
 
-  //ds bookkeep each generated point for resize immune memory management (TODO remove costly bookkeeping)
-  _created_points.push_back(frame_point);
-
   //ds this point enters in the temporary points buffer as it has unreliable depth
   _temporary_points.push_back(frame_point);
   return frame_point;
 }
 
 void Frame::clear() {
-  for (const FramePoint* frame_point: _created_points) {
-    delete frame_point;
-  }
-  _created_points.clear();
+  _framepoint_arena.clear();
   _active_points.clear();
   _temporary_points.clear();
   _keypoints_left.clear();
@@ -2,6 +2,7 @@
 #include "parameters.h"
 #include "camera.h"
 #include "frame_point.h"
+#include "identifier_map.h"
 
 namespace proslam {
   
@@ -34,6 +35,16 @@ public: //ds TODO protect for factory
   //ds FramePoints cleanup
   ~Frame();
 
+protected:
+
+  //! @brief frame construction with a given identifier and without framepoints (e.g. when loading a map)
+  //! @param[in] identifier_ unique identifier, subsequently created frames receive a larger identifier
+  //! @param[in] robot_to_world_ frame pose
+  //! @param[in] timestamp_image_left_seconds_ acquisition timestamp
+  Frame(const Identifier& identifier_,
+        const TransformMatrix3D& robot_to_world_,
+        const double& timestamp_image_left_seconds_);
+
 //ds getters/setters
 public:
 
@@ -105,8 +116,8 @@ public:
   FramePoint* createFramepoint(const IntensityFeature* feature_left_,
                                FramePoint* previous_point_ = nullptr);
 
-  //! @brief created framepoints by this factory
-  inline const FramePointPointerVector& createdPoints() const {return _created_points;}
+  //! @brief number of created framepoints by this factory
+  inline const Count& numberOfCreatedPoints() const {return _framepoint_arena.size();}
 
   inline FramePointPointerVector& temporaryPoints() {return _temporary_points;}
   inline const FramePointPointerVector& temporaryPoints() const {return _temporary_points;}
@@ -180,10 +191,10 @@ protected:
   //! @brief mean descriptor distance for tracking
   real _average_descriptor_distance = 0;
 
-  //! @brief bookkeeping: all created framepoints for this frame (create function)
-  FramePointPointerVector _created_points;
+  //! @brief all created framepoints for this frame (create function), released in bulk on clear
+  ObjectArena<FramePoint> _framepoint_arena;
 
-  //! @brief bookkeeping: active (used) framepoints in the pipeline (a subset of _created_points)
+  //! @brief bookkeeping: active (used) framepoints in the pipeline (a subset of the created points)
   FramePointPointerVector _active_points;
 
   //! @brief bookkeeping: tracked framepoints that have to be estimated yet (e.g. triangulation)
@@ -227,5 +238,5 @@ protected:
 
 typedef std::vector<Frame*> FramePointerVector;
 typedef std::pair<const Identifier, Frame*> FramePointerMapElement;
-typedef std::map<const Identifier, Frame*> FramePointerMap;
+typedef IdentifierMap<Frame> FramePointerMap;
 }
@@ -30,6 +30,7 @@ FramePoint::FramePoint(const IntensityFeature* feature_left_,
                                        _frame(frame_),
                                        _keypoint_left(feature_left_->keypoint),
                                        _descriptor_left(feature_left_->descriptor),
+                                       _descriptor_right(),
                                        _disparity_pixels(0),
                                        _descriptor_distance_triangulation(0),
                                        _image_coordinates_left(ImageCoordinates(feature_left_->keypoint.pt.x, feature_left_->keypoint.pt.y, 1)) {
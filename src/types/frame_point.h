@@ -1,5 +1,7 @@
 #pragma once
 #include "definitions.h"
+#include "object_arena.h"
+#include "descriptor_distance.h"
 #include "srrg_hbst/types/binary_tree.hpp"
 
 namespace proslam {
@@ -20,17 +22,17 @@ struct IntensityFeature {
   IntensityFeature(): row(0), col(0), index_in_vector(0) {}
 
   IntensityFeature(const cv::KeyPoint& keypoint_,
-                   const cv::Mat& descriptor_,
+                   const BinaryDescriptor& descriptor_,
                    const size_t& index_in_vector_): keypoint(keypoint_),
                                                     descriptor(descriptor_),
                                                     row(keypoint_.pt.y),
                                                     col(keypoint_.pt.x),
                                                     index_in_vector(index_in_vector_) {}
-  cv::KeyPoint keypoint;  //ds geometric: feature location in 2D
-  cv::Mat descriptor;     //ds appearance: feature descriptor
-  int32_t row;            //ds pixel column coordinate (v)
-  int32_t col;            //ds pixel row coordinate (u)
-  size_t index_in_vector; //ds inverted index for vector containing this
+  cv::KeyPoint keypoint;       //ds geometric: feature location in 2D
+  BinaryDescriptor descriptor; //ds appearance: feature descriptor (copied from the extracted descriptor matrix)
+  int32_t row;                 //ds pixel column coordinate (v)
+  int32_t col;                 //ds pixel row coordinate (u)
+  size_t index_in_vector;      //ds inverted index for vector containing this
 
 };
 
@@ -116,8 +118,8 @@ public:
   //ds measured properties
   inline const cv::KeyPoint& keypointLeft() const {return _keypoint_left;}
   inline const cv::KeyPoint& keypointRight() const {return _keypoint_right;}
-  inline const cv::Mat& descriptorLeft() const {return _descriptor_left;}
-  inline const cv::Mat& descriptorRight() const {return _descriptor_right;}
+  inline const BinaryDescriptor& descriptorLeft() const {return _descriptor_left;}
+  inline const BinaryDescriptor& descriptorRight() const {return _descriptor_right;}
   inline const real& disparityPixels() const {return _disparity_pixels;}
 
   //ds reset allocated object counter
@@ -148,8 +150,8 @@ protected:
   //ds triangulation information (set by StereoFramePointGenerator)
   const cv::KeyPoint _keypoint_left;
   const cv::KeyPoint _keypoint_right;
-  const cv::Mat _descriptor_left;
-  const cv::Mat _descriptor_right;
+  const BinaryDescriptor _descriptor_left;
+  const BinaryDescriptor _descriptor_right;
   const real _disparity_pixels;
   real _descriptor_distance_triangulation;
   const ImageCoordinates _image_coordinates_left;
@@ -173,8 +175,9 @@ protected:
   //ds frame point track length (number of previous elements)
   Count _track_length = 0;
 
-  //ds grant access to factory for constructor calls
+  //ds grant access to factory for constructor calls (framepoints are constructed and destroyed in the arena of the frame)
   friend Frame;
+  template<typename ObjectType_> friend class ObjectArena;
 
   //ds visualization only
   cv::Point2f _projection_estimate_left;
@@ -0,0 +1,217 @@
+#pragma once
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "definitions.h"
+
+namespace proslam {
+
+//! @class identifier-indexed pointer storage: objects are addressed by their (dense, increasing) identifier in a flat slot vector
+//! offering constant time lookup, insertion and removal and sequential iteration in identifier order. The interface follows the
+//! subset of std::map<Identifier, ObjectType_*> used in the map structures, elements are yielded as (identifier, pointer) pairs
+//! removed objects leave empty slots, which are skipped in iteration. Leading empty slots (e.g. of objects freed in creation order)
+//! are compacted in amortized constant time, hence the memory footprint follows the range of identifiers that are alive
+template<typename ObjectType_>
+class IdentifierMap {
+
+//ds exported types
+public:
+
+  //! @brief element as yielded in iteration (identical to the value type of the replaced std::map)
+  typedef std::pair<const Identifier, ObjectType_*> Element;
+
+  //! @brief forward iterator over the occupied slots (elements are generated on access, slots are addressed by identifier
+  //! @brief so iterators stay valid when other elements are inserted or removed)
+  class Iterator {
+  public:
+
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Element value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Element* pointer;
+    typedef Element reference;
+
+    //! @brief element holder for member access through the iterator
+    struct ElementPointer {
+      const Element element;
+      const Element* operator->() const {return &element;}
+    };
+
+    Iterator(const IdentifierMap* map_, const Identifier& identifier_): _map(map_), _identifier(identifier_) {_skipEmptySlots();}
+
+    Element operator*() const {return Element(_identifier, _map->_slots[_identifier-_map->_identifier_offset]);}
+    ElementPointer operator->() const {return ElementPointer{**this};}
+    Iterator& operator++() {++_identifier; _skipEmptySlots(); return *this;}
+    Iterator operator++(int) {Iterator iterator(*this); ++(*this); return iterator;}
+    bool operator==(const Iterator& other_) const {return _identifier == other_._identifier;}
+    bool operator!=(const Iterator& other_) const {return _identifier != other_._identifier;}
+
+  protected:
+
+    //! @brief advances to the next occupied slot (or the end)
+    void _skipEmptySlots() {
+      const Identifier identifier_end = _map->_identifierEnd();
+      if (_identifier < _map->_identifier_offset) {
+        _identifier = _map->_identifier_offset;
+      }
+      while (_identifier < identifier_end && !_map->_slots[_identifier-_map->_identifier_offset]) {
+        ++_identifier;
+      }
+      if (_identifier > identifier_end) {
+        _identifier = identifier_end;
+      }
+    }
+
+    const IdentifierMap* _map;
+    Identifier _identifier;
+    friend class IdentifierMap;
+  };
+
+  //ds elements are pairs of identifier and pointer - there is no distinction between mutable and constant iteration
+  typedef Iterator iterator;
+  typedef Iterator const_iterator;
+
+//ds object handling
+public:
+
+  IdentifierMap() {}
+
+//ds functionality
+public:
+
+  //! @brief adds an object with the given identifier (no effect if the identifier is already occupied)
+  //! @param[in] element_ identifier and object
+  //! @return true if the object was added
+  bool insert(const Element& element_) {
+    const Identifier& identifier = element_.first;
+    if (_slots.empty()) {
+      _identifier_offset = identifier;
+    } else if (identifier < _identifier_offset) {
+
+      //ds prepend empty slots (only happens for non-ascending insertions, e.g. when loading maps)
+      _slots.insert(_slots.begin(), _identifier_offset-identifier, nullptr);
+      _index_first += _identifier_offset-identifier;
+      _identifier_offset = identifier;
+    }
+    const Index index = identifier-_identifier_offset;
+    if (index >= _slots.size()) {
+      _slots.resize(index+1, nullptr);
+    }
+    if (_slots[index]) {
+      return false;
+    }
+    _slots[index] = element_.second;
+    ++_size;
+    if (index < _index_first || _size == 1) {
+      _index_first = index;
+    }
+    return true;
+  }
+
+  //! @brief retrieves an object in constant time
+  //! @param[in] identifier_ object identifier
+  //! @return the object or nullptr if not available
+  ObjectType_* get(const Identifier& identifier_) const {
+    if (identifier_ < _identifier_offset || identifier_ >= _identifierEnd()) {
+      return nullptr;
+    }
+    return _slots[identifier_-_identifier_offset];
+  }
+
+  //! @brief retrieves an object, throws std::out_of_range if not available (std::map semantics)
+  ObjectType_* at(const Identifier& identifier_) const {
+    ObjectType_* object = get(identifier_);
+    if (!object) {
+      throw std::out_of_range("IdentifierMap::at|unavailable identifier: "+std::to_string(identifier_));
+    }
+    return object;
+  }
+
+  //! @brief iterator to an object, end() if not available
+  Iterator find(const Identifier& identifier_) const {
+    return (get(identifier_)) ? Iterator(this, identifier_) : end();
+  }
+
+  //! @brief removes an object (the object is not freed)
+  //! @return number of removed objects (0 or 1)
+  Count erase(const Identifier& identifier_) {
+    if (!get(identifier_)) {
+      return 0;
+    }
+    _slots[identifier_-_identifier_offset] = nullptr;
+    --_size;
+    _trim();
+    return 1;
+  }
+
+  //! @brief removes the object at the iterator position (the object is not freed)
+  //! @return iterator to the next object
+  Iterator erase(const Iterator& iterator_) {
+    const Identifier identifier_next = iterator_._identifier+1;
+    erase(iterator_._identifier);
+    return Iterator(this, identifier_next);
+  }
+
+  //! @brief removes all objects (the objects are not freed)
+  void clear() {
+    _slots.clear();
+    _identifier_offset = 0;
+    _index_first       = 0;
+    _size              = 0;
+  }
+
+  Iterator begin() const {return Iterator(this, _identifier_offset+_index_first);}
+  Iterator end() const {return Iterator(this, _identifierEnd());}
+
+  //! @brief object with the highest identifier (the container must not be empty)
+  ObjectType_* back() const {return _slots.back();}
+
+  const size_t size() const {return _size;}
+  const bool empty() const {return _size == 0;}
+
+  //! @brief number of allocated slots (occupied and empty)
+  const size_t capacity() const {return _slots.size();}
+
+//ds helpers
+protected:
+
+  //! @brief identifier after the last slot
+  const Identifier _identifierEnd() const {return _identifier_offset+_slots.size();}
+
+  //! @brief drops trailing empty slots and compacts leading empty slots once they make up half of the storage
+  void _trim() {
+    if (_size == 0) {
+      clear();
+      return;
+    }
+    while (!_slots.back()) {
+      _slots.pop_back();
+    }
+    while (!_slots[_index_first]) {
+      ++_index_first;
+    }
+    if (_index_first > _slots.size()/2) {
+      _slots.erase(_slots.begin(), _slots.begin()+_index_first);
+      _identifier_offset += _index_first;
+      _index_first        = 0;
+    }
+  }
+
+//ds attributes
+protected:
+
+  //! @brief object slots addressed by identifier-_identifier_offset (nullptr for empty slots)
+  std::vector<ObjectType_*> _slots;
+
+  //! @brief identifier of the first slot
+  Identifier _identifier_offset = 0;
+
+  //! @brief index of the first occupied slot
+  Index _index_first = 0;
+
+  //! @brief number of occupied slots
+  size_t _size = 0;
+};
+}
@@ -1,3 +1,4 @@
+#include <limits>
 #include "landmark.h"
 #include "local_map.h"
 
@@ -24,12 +25,37 @@ Landmark::Landmark(FramePoint* point_, const LandmarkParameters* parameters_): _
     _measurements.push_back(Measurement(framepoint));
     _descriptors.push_back(framepoint->descriptorLeft());
     _origin = framepoint;
-    _world_coordinates += framepoint->worldCoordinates();
+    _world_coordinates_accumulated += framepoint->worldCoordinates();
     framepoint = framepoint->previous();
   }
-  _world_coordinates /= _measurements.size();
-  _number_of_updates = _measurements.size();
-  _last_update = point_;
+
+  //ds measurements are stored in ascending frame order (the track is traversed backwards)
+  std::reverse(_measurements.begin(), _measurements.end());
+  _number_of_measurements = _measurements.size();
+  _world_coordinates      = _world_coordinates_accumulated/_number_of_measurements;
+  _number_of_updates      = _number_of_measurements;
+  _last_update            = point_;
+
+  //ds accumulate measurements exceeding the window at the initial estimate
+  _accumulateMeasurementsOutsideWindow();
+}
+
+Landmark::Landmark(const Identifier& identifier_,
+                   const PointCoordinates& world_coordinates_,
+                   const Matrix3& information_matrix_,
+                   const Count& number_of_updates_,
+                   const Count& number_of_measurements_,
+                   const LandmarkParameters* parameters_): _identifier(identifier_),
+                                                           _world_coordinates(world_coordinates_),
+                                                           _number_of_updates(number_of_updates_),
+                                                           _information_matrix(information_matrix_),
+                                                           _number_of_measurements(number_of_measurements_),
+                                                           _parameters(parameters_) {
+  _instances = std::max(_instances, _identifier+1);
+
+  //ds the previous measurements are available in accumulated form only
+  _information_vector            = _information_matrix*_world_coordinates;
+  _world_coordinates_accumulated = _number_of_measurements*_world_coordinates;
 }
 
 Landmark::~Landmark() {
@@ -41,7 +67,7 @@ Landmark::~Landmark() {
     assert(!_origin->previous());
     FramePoint* point = _origin;
     while (point) {
-      assert(point == point->next());
+      assert(!point->next() || point->next()->previous() == point);
       point->setLandmark(nullptr);
       point = point->next();
     }
@@ -53,6 +79,14 @@ Landmark::~Landmark() {
   _local_maps.clear();
 }
 
+void Landmark::setCoordinates(const PointCoordinates& coordinates_) {
+  _world_coordinates = coordinates_;
+
+  //ds re-anchor accumulated information and fallback estimate at the new coordinates
+  _information_vector            = _information_matrix*coordinates_;
+  _world_coordinates_accumulated = _number_of_measurements*coordinates_;
+}
+
 void Landmark::replace(const HBSTMatchable* matchable_old_, HBSTMatchable* matchable_new_) {
 
   //ds remove the old matchable and check for failure
@@ -77,94 +111,14 @@ void Landmark::update(FramePoint* point_) {
 
   //ds update appearance history (left descriptors only)
   _descriptors.push_back(_last_update->descriptorLeft());
-  _measurements.push_back(Measurement(_last_update));
+  _boundDescriptors();
+  _addMeasurement(_last_update);
 
-  //ds trigger classic ICP in camera update of landmark coordinates - setup
-  Vector3 world_coordinates(_world_coordinates);
-  Matrix3 H(Matrix3::Zero());
-  Vector3 b(Vector3::Zero());
-  Matrix3 jacobian;
-  Matrix3 jacobian_transposed;
-  Matrix3 omega(Matrix3::Identity());
-  real total_error_squared_previous = 0;
-
-  //ds gauss newton descent
-  for (uint32_t iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
-    H.setZero();
-    b.setZero();
-    real total_error_squared    = 0;
-    uint32_t number_of_outliers = 0;
-
-    //ds for each measurement
-    for (const Measurement& measurement: _measurements) {
-      omega.setIdentity();
-
-      //ds sample current state in measurement context
-      const PointCoordinates camera_coordinates_sampled = measurement.frame->worldToCameraLeft()*world_coordinates;
-      if (camera_coordinates_sampled.z() <= 0) {
-        ++number_of_outliers;
-        continue;
-      }
+  //ds move measurements exceeding the window into the accumulated information
+  _accumulateMeasurementsOutsideWindow();
 
-      //ds compute error
-      const Vector3 error(camera_coordinates_sampled-measurement.camera_coordinates);
-
-      //ds weight inverse depth
-      omega *= measurement.inverse_depth_meters;
-
-      //ds update chi
-      const real error_squared = error.transpose()*omega*error;
-      total_error_squared += error_squared;
-
-      //ds robust kernel
-      if (error_squared > _parameters->maximum_error_squared_meters) {
-        omega *= _parameters->maximum_error_squared_meters/error_squared;
-        ++number_of_outliers;
-      }
-
-      //ds get the jacobian of the transform part: R
-      jacobian = measurement.frame->worldToCameraLeft().linear();
-
-      //ds precompute transposed
-      jacobian_transposed = jacobian.transpose();
-
-      //ds accumulate
-      H += jacobian_transposed*omega*jacobian;
-      b += jacobian_transposed*omega*error;
-    }
-
-    //ds update state
-    world_coordinates += H.fullPivLu().solve(-b);
-
-    //ds check convergence
-    if (std::fabs(total_error_squared-total_error_squared_previous) < 1e-5 || iteration == 999) {
-      const uint32_t number_of_inliers = _measurements.size()-number_of_outliers;
-
-      //ds if the number of inliers is higher than the best so far
-      if (number_of_inliers > _number_of_updates) {
-
-        //ds update landmark state
-        _world_coordinates = world_coordinates;
-        _number_of_updates = number_of_inliers;
-
-      //ds if optimization failed and we have less inliers than outliers - reset initial guess
-      } else if (number_of_inliers < number_of_outliers) {
-
-        //ds reset estimate based on overall average
-        PointCoordinates world_coordinates_accumulated(PointCoordinates::Zero());
-        for (const Measurement& measurement: _measurements) {
-          world_coordinates_accumulated += measurement.frame->cameraLeftToWorld()*measurement.camera_coordinates;
-        }
-
-        //ds set landmark state without increasing update count
-        _world_coordinates = world_coordinates_accumulated/_measurements.size();
-      }
-      break;
-    }
-
-    //ds update previous
-    total_error_squared_previous = total_error_squared;
-  }
+  //ds refine landmark coordinates
+  _optimize();
 }
 
 void Landmark::merge(Landmark* landmark_) {
@@ -174,8 +128,8 @@ void Landmark::merge(Landmark* landmark_) {
   }
   assert(landmark_);
   assert(_identifier < landmark_->_identifier);
-  assert(_origin != landmark_->_origin);
-  assert(_origin->identifier() < landmark_->_origin->identifier());
+  assert(!_origin || _origin != landmark_->_origin);
+  assert(!_origin || _origin->identifier() < landmark_->_origin->identifier());
 
   //ds merge landmark appearances (owned by HBST for relocalization)
   for (auto& appearance: landmark_->_appearance_map) {
@@ -194,28 +148,57 @@ void Landmark::merge(Landmark* landmark_) {
   //ds merge descriptors
   _descriptors.insert(_descriptors.end(), landmark_->_descriptors.begin(), landmark_->_descriptors.end());
   landmark_->_descriptors.clear();
-
-  //ds compute new merged world coordinates
-  _world_coordinates = (_number_of_updates*_world_coordinates+
-                       landmark_->_number_of_updates*landmark_->_world_coordinates)
-                       /(_number_of_updates+landmark_->_number_of_updates);
+  _boundDescriptors();
+
+  //ds compute new merged world coordinates by fusing both estimates with their total information
+  const Matrix3 information_matrix_this  = _totalInformationMatrix();
+  const Matrix3 information_matrix_other = landmark_->_totalInformationMatrix();
+  const Matrix3 information_matrix_fused = information_matrix_this+information_matrix_other;
+  if (information_matrix_fused.trace() > 0) {
+    _world_coordinates = information_matrix_fused.fullPivLu().solve(information_matrix_this*_world_coordinates+
+                                                                    information_matrix_other*landmark_->_world_coordinates);
+  } else {
+    _world_coordinates = (_number_of_updates*_world_coordinates+
+                         landmark_->_number_of_updates*landmark_->_world_coordinates)
+                         /(_number_of_updates+landmark_->_number_of_updates);
+  }
 
   //ds update measurements
   _number_of_updates    += landmark_->_number_of_updates;
   _number_of_recoveries += landmark_->_number_of_recoveries;
+  _information_matrix             += landmark_->_information_matrix;
+  _information_vector             += landmark_->_information_vector;
+  _number_of_accumulated_outliers += landmark_->_number_of_accumulated_outliers;
+  _number_of_measurements         += landmark_->_number_of_measurements;
+  _world_coordinates_accumulated  += landmark_->_world_coordinates_accumulated;
   _measurements.insert(_measurements.end(), landmark_->_measurements.begin(), landmark_->_measurements.end());
   landmark_->_measurements.clear();
 
+  //ds restore ascending frame order of the window and accumulate the measurements exceeding it
+  std::sort(_measurements.begin(), _measurements.end(), [](const Measurement& a_, const Measurement& b_){
+    return a_.frame->identifier() < b_.frame->identifier();
+  });
+  _accumulateMeasurementsOutsideWindow();
+
   assert(!landmark_->_origin->previous());
   assert(landmark_->_origin->next());
-  assert(landmark_->_origin->identifier() != _last_update->identifier());
+  assert(!_last_update || landmark_->_origin->identifier() != _last_update->identifier());
+
+  //ds if this landmark has no framepoint track (e.g. loaded from a map) it takes over the track of the absorbed landmark
+  if (!_origin) {
+    _origin      = landmark_->_origin;
+    _last_update = landmark_->_last_update;
+    for (FramePoint* point = _origin; point; point = point->next()) {
+      point->setLandmark(this);
+    }
+  }
 
   //ds in case some of the framepoints to merge are older than the current (smaller identifier)
-  if (landmark_->_origin->identifier() < _last_update->identifier()) {
+  else if (landmark_->_origin->identifier() < _last_update->identifier()) {
 
     //ds accumulate framepoint identifiers from both landmarks
     FramePointPointerVector framepoints_sorted;
-    framepoints_sorted.reserve(_measurements.size());
+    framepoints_sorted.reserve(_number_of_measurements);
     FramePoint* point = _origin;
     framepoints_sorted.emplace_back(point);
     while (point->next()) {
@@ -264,4 +247,216 @@ void Landmark::merge(Landmark* landmark_) {
   landmark_->_origin = nullptr;
   landmark_->_last_update = nullptr;
 }
+
+void Landmark::_addMeasurement(const FramePoint* framepoint_) {
+  _measurements.push_back(Measurement(framepoint_));
+  _world_coordinates_accumulated += framepoint_->worldCoordinates();
+  ++_number_of_measurements;
+}
+
+const bool Landmark::_computeInformation(const Measurement& measurement_,
+                                         const PointCoordinates& world_coordinates_,
+                                         Matrix3& information_matrix_,
+                                         Vector3& information_vector_,
+                                         real& error_squared_,
+                                         bool& is_inlier_) const {
+  const TransformMatrix3D& world_to_camera = measurement_.frame->worldToCameraLeft();
+
+  //ds sample current state in measurement context
+  const PointCoordinates camera_coordinates_sampled = world_to_camera*world_coordinates_;
+  if (camera_coordinates_sampled.z() <= 0) {
+    return false;
+  }
+
+  //ds compute error, weighted by inverse depth
+  const Vector3 error(camera_coordinates_sampled-measurement_.camera_coordinates);
+  real omega     = measurement_.inverse_depth_meters;
+  error_squared_ = omega*error.squaredNorm();
+
+  //ds robust kernel
+  is_inlier_ = true;
+  if (error_squared_ > _parameters->maximum_error_squared_meters) {
+    omega     *= _parameters->maximum_error_squared_meters/error_squared_;
+    is_inlier_ = false;
+  }
+
+  //ds the measurement function R*p+t is linear in p: contribution to the normal equations H*p = b
+  const Matrix3 rotation_transposed(world_to_camera.linear().transpose());
+  information_matrix_ = omega*rotation_transposed*world_to_camera.linear();
+  information_vector_ = omega*rotation_transposed*(measurement_.camera_coordinates-world_to_camera.translation());
+  return true;
+}
+
+void Landmark::_accumulateMeasurementsOutsideWindow() {
+  const Count window_size = std::max(_parameters->maximum_number_of_window_measurements, static_cast<Count>(1));
+  if (_measurements.size() <= window_size) {
+    return;
+  }
+  const Count number_of_measurements_to_accumulate = _measurements.size()-window_size;
+
+  //ds fix the weights of the oldest measurements at the current estimate
+  Matrix3 information_matrix;
+  Vector3 information_vector;
+  real error_squared = 0;
+  bool is_inlier     = false;
+  for (Index index = 0; index < number_of_measurements_to_accumulate; ++index) {
+    if (_computeInformation(_measurements[index], _world_coordinates, information_matrix, information_vector, error_squared, is_inlier)) {
+      _information_matrix += information_matrix;
+      _information_vector += information_vector;
+      if (!is_inlier) {
+        ++_number_of_accumulated_outliers;
+      }
+    } else {
+      ++_number_of_accumulated_outliers;
+    }
+  }
+  _measurements.erase(_measurements.begin(), _measurements.begin()+number_of_measurements_to_accumulate);
+}
+
+const Matrix3 Landmark::_totalInformationMatrix() const {
+  Matrix3 information_matrix_total(_information_matrix);
+  Matrix3 information_matrix;
+  Vector3 information_vector;
+  real error_squared = 0;
+  bool is_inlier     = false;
+  for (const Measurement& measurement: _measurements) {
+    if (_computeInformation(measurement, _world_coordinates, information_matrix, information_vector, error_squared, is_inlier)) {
+      information_matrix_total += information_matrix;
+    }
+  }
+  return information_matrix_total;
+}
+
+void Landmark::_optimize() {
+
+  //ds iteratively reweighted least squares over the measurement window - accumulated information is constant
+  Vector3 world_coordinates(_world_coordinates);
+  Matrix3 H;
+  Vector3 b;
+  Matrix3 information_matrix;
+  Vector3 information_vector;
+  real total_error_squared_previous = 0;
+  for (uint32_t iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
+    H = _information_matrix;
+    b = _information_vector;
+    real total_error_squared    = 0;
+    uint32_t number_of_outliers = _number_of_accumulated_outliers;
+
+    //ds for each measurement in the window
+    for (const Measurement& measurement: _measurements) {
+      real error_squared = 0;
+      bool is_inlier     = false;
+      if (!_computeInformation(measurement, world_coordinates, information_matrix, information_vector, error_squared, is_inlier)) {
+        ++number_of_outliers;
+        continue;
+      }
+      total_error_squared += error_squared;
+      if (!is_inlier) {
+        ++number_of_outliers;
+      }
+
+      //ds accumulate
+      H += information_matrix;
+      b += information_vector;
+    }
+
+    //ds no usable measurements - keep the current estimate
+    if (H.trace() <= 0) {
+      break;
+    }
+
+    //ds update state
+    world_coordinates = H.fullPivLu().solve(b);
+
+    //ds check convergence
+    if (std::fabs(total_error_squared-total_error_squared_previous) < 1e-5 || iteration+1 == _parameters->maximum_number_of_iterations) {
+      const uint32_t number_of_inliers = _number_of_measurements-number_of_outliers;
+
+      //ds if the number of inliers is higher than the best so far
+      if (number_of_inliers > _number_of_updates) {
+
+        //ds update landmark state
+        _world_coordinates = world_coordinates;
+        _number_of_updates = number_of_inliers;
+
+      //ds if optimization failed and we have less inliers than outliers - reset initial guess
+      } else if (number_of_inliers < number_of_outliers) {
+
+        //ds set landmark state to overall average without increasing update count
+        _world_coordinates = _world_coordinates_accumulated/_number_of_measurements;
+      }
+      break;
+    }
+
+    //ds update previous
+    total_error_squared_previous = total_error_squared;
+  }
+}
+
+void Landmark::_boundDescriptors() {
+
+  //ds without a local map consuming the descriptors (e.g. relocalization disabled) the buffer would grow with every update
+  //ds the reduction to half of the capacity amortizes the selection cost over the following updates
+  if (_parameters->maximum_number_of_descriptors > 0 && _descriptors.size() > _parameters->maximum_number_of_descriptors) {
+    _selectRepresentativeDescriptors(std::max(_parameters->maximum_number_of_descriptors/2, static_cast<Count>(1)));
+  }
+}
+
+void Landmark::_selectRepresentativeDescriptors(const Count& maximum_number_of_representatives_) {
+  const Count number_of_descriptors = _descriptors.size();
+  if (maximum_number_of_representatives_ == 0 || number_of_descriptors <= maximum_number_of_representatives_) {
+    return;
+  }
+
+  //ds pairwise descriptor distances (symmetric, row-major)
+  std::vector<uint32_t> distances(number_of_descriptors*number_of_descriptors, 0);
+  for (Index u = 0; u < number_of_descriptors; ++u) {
+    for (Index v = u+1; v < number_of_descriptors; ++v) {
+      const uint32_t distance = DescriptorDistance::compute(_descriptors[u], _descriptors[v]);
+      distances[u*number_of_descriptors+v] = distance;
+      distances[v*number_of_descriptors+u] = distance;
+    }
+  }
+
+  //ds greedy medoid selection: each representative minimizes the summed distance of all descriptors to their closest representative
+  //ds the first representative is therefore the medoid, the selection stops early if all descriptors are covered exactly
+  std::vector<uint32_t> distances_to_closest(number_of_descriptors, std::numeric_limits<uint32_t>::max());
+  std::vector<bool> is_representative(number_of_descriptors, false);
+  for (Count k = 0; k < maximum_number_of_representatives_; ++k) {
+    uint64_t cost_best = std::numeric_limits<uint64_t>::max();
+    Index index_best   = 0;
+    for (Index index_candidate = 0; index_candidate < number_of_descriptors; ++index_candidate) {
+      if (is_representative[index_candidate]) {
+        continue;
+      }
+      const uint32_t* distances_candidate = &distances[index_candidate*number_of_descriptors];
+      uint64_t cost = 0;
+      for (Index u = 0; u < number_of_descriptors; ++u) {
+        cost += std::min(distances_to_closest[u], distances_candidate[u]);
+      }
+      if (cost < cost_best) {
+        cost_best  = cost;
+        index_best = index_candidate;
+      }
+    }
+    is_representative[index_best] = true;
+    const uint32_t* distances_best = &distances[index_best*number_of_descriptors];
+    for (Index u = 0; u < number_of_descriptors; ++u) {
+      distances_to_closest[u] = std::min(distances_to_closest[u], distances_best[u]);
+    }
+    if (cost_best == 0) {
+      break;
+    }
+  }
+
+  //ds keep the representatives in order of measurement
+  Index index_kept = 0;
+  for (Index u = 0; u < number_of_descriptors; ++u) {
+    if (is_representative[u]) {
+      _descriptors[index_kept] = _descriptors[u];
+      ++index_kept;
+    }
+  }
+  _descriptors.resize(index_kept);
+}
 }
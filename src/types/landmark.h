@@ -40,6 +40,20 @@ protected:
   //ds initial landmark coordinates must be provided
   Landmark(FramePoint* point_, const LandmarkParameters* parameters_);
 
+  //! @brief landmark construction from a previous estimate without a framepoint track (e.g. when loading a map)
+  //! @param[in] identifier_ unique identifier, subsequently created landmarks receive a larger identifier
+  //! @param[in] world_coordinates_ landmark coordinates
+  //! @param[in] information_matrix_ total information of all previous measurements at world_coordinates_
+  //! @param[in] number_of_updates_ number of previous updates
+  //! @param[in] number_of_measurements_ number of previous measurements
+  //! @param[in] parameters_ landmark parameters
+  Landmark(const Identifier& identifier_,
+           const PointCoordinates& world_coordinates_,
+           const Matrix3& information_matrix_,
+           const Count& number_of_updates_,
+           const Count& number_of_measurements_,
+           const LandmarkParameters* parameters_);
+
   //ds cleanup of dynamic structures
   ~Landmark();
 
@@ -56,8 +70,13 @@ public:
   inline FramePoint* origin() const {return _origin;}
   void setOrigin(FramePoint* origin_) {_origin = origin_;}
 
+  //ds framepoint of the most recent update (the landmark is tracked as long as it lies in the current frame)
+  inline const FramePoint* lastUpdate() const {return _last_update;}
+
   inline const PointCoordinates& coordinates() const {return _world_coordinates;}
-  void setCoordinates(const PointCoordinates& coordinates_) {_world_coordinates = coordinates_;}
+
+  //! @brief sets the landmark coordinates (e.g. after map optimization), the accumulated information is re-anchored at the new coordinates
+  void setCoordinates(const PointCoordinates& coordinates_);
 
   //! @brief replaces a matchable in the appearance map
   void replace(const HBSTMatchable* matchable_old_, HBSTMatchable* matchable_new_);
@@ -72,6 +91,7 @@ public:
   inline void setIsCurrentlyTracked(const bool& is_currently_tracked_) {_is_currently_tracked = is_currently_tracked_;}
 
   //ds landmark coordinates update with visual information (tracking)
+  //ds constant time: only the measurement window is re-weighted, older measurements are accumulated in information form
   void update(FramePoint* point_);
 
   const Count& numberOfRecoveries() const {return _number_of_recoveries;}
@@ -106,8 +126,8 @@ protected:
   //ds world coordinates of the landmark
   PointCoordinates _world_coordinates;
 
-  //ds descriptors of this landmark which have not been converted to appearances yet
-  std::vector<cv::Mat> _descriptors;
+  //ds descriptors of this landmark which have not been converted to appearances yet (stored contiguously by value)
+  BinaryDescriptorVector _descriptors;
 
   //ds appearances of this landmark that are captured in a local map (previously contained in _descriptors)
   HBSTMatchableMemoryMap _appearance_map;
@@ -118,11 +138,20 @@ protected:
   //ds flags
   bool _is_currently_tracked = false; //ds set if the landmark is visible (=tracked) in the current image
 
-  //ds landmark coordinates optimization
+  //ds landmark coordinates optimization: window of the most recent measurements (ascending frame order), robustly re-weighted on each update
   MeasurementVector _measurements;
   Count _number_of_updates    = 0;
   Count _number_of_recoveries = 0;
 
+  //ds accumulated information of all measurements that left the window (normal equations: H*x = b)
+  Matrix3 _information_matrix = Matrix3::Zero();
+  Vector3 _information_vector = Vector3::Zero();
+  Count _number_of_accumulated_outliers = 0;
+
+  //ds total number of measurements and their summed world coordinates (fallback estimate)
+  Count _number_of_measurements = 0;
+  PointCoordinates _world_coordinates_accumulated = PointCoordinates::Zero();
+
   //ds grant access to landmark factory and helpers
   friend WorldMap;
   friend LocalMap;
@@ -131,6 +160,44 @@ protected:
   bool _is_in_loop_closure_query     = false;
   bool _is_in_loop_closure_reference = false;
 
+//ds helpers
+protected:
+
+  //! @brief adds a new measurement to the window
+  void _addMeasurement(const FramePoint* framepoint_);
+
+  //! @brief computes the robustly weighted information of a measurement for the given landmark coordinates
+  //! @param[in] measurement_ the measurement
+  //! @param[in] world_coordinates_ landmark coordinates at which the measurement is evaluated
+  //! @param[out] information_matrix_ measurement contribution to H
+  //! @param[out] information_vector_ measurement contribution to b
+  //! @param[out] error_squared_ weighted squared error
+  //! @param[out] is_inlier_ set if the error is within the robust kernel
+  //! @return false if the measurement cannot be used (landmark behind the camera)
+  const bool _computeInformation(const Measurement& measurement_,
+                                 const PointCoordinates& world_coordinates_,
+                                 Matrix3& information_matrix_,
+                                 Vector3& information_vector_,
+                                 real& error_squared_,
+                                 bool& is_inlier_) const;
+
+  //! @brief moves the oldest measurements exceeding the window into the accumulated information (weighted at the current estimate)
+  void _accumulateMeasurementsOutsideWindow();
+
+  //! @brief computes the total information (accumulated and window) at the current estimate
+  const Matrix3 _totalInformationMatrix() const;
+
+  //! @brief robust position optimization over accumulated information and measurement window
+  void _optimize();
+
+  //! @brief reduces the descriptors that have not been converted to appearances yet to at most maximum_number_of_representatives_
+  //! @brief representatives (greedy k-medoids in Hamming space, the first representative is the medoid), kept in order of measurement
+  //! @param[in] maximum_number_of_representatives_ maximum number of kept descriptors (0: all descriptors are kept)
+  void _selectRepresentativeDescriptors(const Count& maximum_number_of_representatives_);
+
+  //! @brief bounds the descriptor buffer to maximum_number_of_descriptors (reduced to half of it on overflow)
+  void _boundDescriptors();
+
 //ds class specific
 private:
 
@@ -144,7 +211,7 @@ private:
 
 typedef std::vector<Landmark*> LandmarkPointerVector;
 typedef std::pair<const Identifier, Landmark*> LandmarkPointerMapElement;
-typedef std::map<const Identifier, Landmark*> LandmarkPointerMap;
+typedef IdentifierMap<Landmark> LandmarkPointerMap;
 typedef std::set<const Landmark*> LandmarkPointerSet;
 
 }
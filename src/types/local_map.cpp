@@ -52,10 +52,11 @@ LocalMap::LocalMap(FramePointerVector& frames_,
       //ds if we have a landmark and it has not been added yet
       if (landmark && landmarks_added.count(landmark->identifier()) == 0) {
 
-        //ds create HBST matchables based on available landmark descriptors TODO move this operation into a method of the landmark
+        //ds create HBST matchables based on the representative landmark descriptors TODO move this operation into a method of the landmark
+        landmark->_selectRepresentativeDescriptors(landmark->_parameters->maximum_number_of_representative_descriptors);
         HBSTTree::MatchableVector matchables(landmark->_descriptors.size());
         for (Count u = 0; u < matchables.size(); ++u) {
-          HBSTMatchable* matchable = new HBSTMatchable(landmark, landmark->_descriptors[u], _identifier);
+          HBSTMatchable* matchable = new HBSTMatchable(landmark, landmark->_descriptors[u].toMat(), _identifier);
           matchables[u]            = matchable;
           landmark->_appearance_map.insert(std::make_pair(matchable, matchable));
         }
@@ -95,6 +96,19 @@ LocalMap::LocalMap(FramePointerVector& frames_,
   _frames.insert(_frames.end(), frames_.begin(), frames_.end());
 }
 
+LocalMap::LocalMap(const Identifier& identifier_,
+                   Frame* keyframe_,
+                   const LocalMapParameters* parameters_): _identifier(identifier_),
+                                                           _root(nullptr),
+                                                           _previous(nullptr),
+                                                           _keyframe(keyframe_),
+                                                           _parameters(parameters_) {
+  assert(_keyframe);
+  _instances = std::max(_instances, _identifier+1);
+  clear();
+  _keyframe->setIsKeyframe(true);
+}
+
 LocalMap::~LocalMap() {
   clear();
 }
@@ -21,6 +21,14 @@ protected:
            LocalMap* local_map_root_ = nullptr,
            LocalMap* local_map_previous_ = nullptr);
 
+  //! @brief constructs an empty local map with a given identifier around a keyframe (e.g. when loading a map), the contents are filled by the WorldMap
+  //! @param[in] identifier_ unique identifier, subsequently created local maps receive a larger identifier
+  //! @param[in] keyframe_ the keyframe of the local map
+  //! @param[in] parameters_ local map parameters
+  LocalMap(const Identifier& identifier_,
+           Frame* keyframe_,
+           const LocalMapParameters* parameters_);
+
   //ds cleanup of dynamic structures
   ~LocalMap();
 
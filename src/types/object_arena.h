@@ -0,0 +1,173 @@
+#pragma once
+#include <mutex>
+#include <new>
+#include <utility>
+#include "definitions.h"
+
+namespace proslam {
+
+//! @class arena allocator for objects of a single type: objects are constructed in preallocated blocks and destroyed in bulk
+//! released blocks are kept in a cache shared by all arenas of the same type - in steady state no heap allocations are performed
+template<typename ObjectType_>
+class ObjectArena {
+
+//ds exported types
+public:
+
+  //! @brief memory block with a fixed capacity of objects
+  struct Block {
+    uint8_t* memory;
+    ObjectType_* objects;
+    Count capacity;
+  };
+
+//ds object handling
+public:
+
+  ObjectArena() {}
+  ~ObjectArena() {clear();}
+
+  //ds arenas own their objects
+  ObjectArena(const ObjectArena&) = delete;
+  ObjectArena& operator=(const ObjectArena&) = delete;
+
+//ds functionality
+public:
+
+  //! @brief constructs a new object in the arena (the object lives until clear is called)
+  //! @param[in] arguments_ constructor arguments
+  //! @return pointer to the constructed object
+  template<typename... Arguments_>
+  ObjectType_* create(Arguments_&&... arguments_) {
+
+    //ds if the current block is full - grab a new one
+    if (_blocks.empty() || _number_of_objects_in_last_block == _blocks.back().capacity) {
+
+      //ds a fresh arena (e.g. of a new frame) takes over a recycled block list instead of growing its own
+      if (_blocks.capacity() == 0) {
+        _acquireBlockList(_blocks);
+      }
+      _blocks.push_back(_acquireBlock());
+      _number_of_objects_in_last_block = 0;
+    }
+    ObjectType_* object = new (_blocks.back().objects+_number_of_objects_in_last_block) ObjectType_(std::forward<Arguments_>(arguments_)...);
+    ++_number_of_objects_in_last_block;
+    ++_number_of_objects;
+    return object;
+  }
+
+  //! @brief destroys all objects in creation order and returns the blocks to the shared cache
+  void clear() {
+    for (Index b = 0; b < _blocks.size(); ++b) {
+      const Count number_of_objects_in_block = (b+1 == _blocks.size()) ? _number_of_objects_in_last_block : _blocks[b].capacity;
+      for (Index u = 0; u < number_of_objects_in_block; ++u) {
+        _blocks[b].objects[u].~ObjectType_();
+      }
+    }
+    if (_blocks.capacity() > 0) {
+      _releaseBlocks(_blocks);
+    }
+    _number_of_objects_in_last_block = 0;
+    _number_of_objects               = 0;
+  }
+
+//ds getters/setters
+public:
+
+  //! @brief number of currently living objects
+  const Count& size() const {return _number_of_objects;}
+
+  //! @brief sets the block capacity for all arenas of this type (cached blocks with a different capacity are freed)
+  static void setBlockCapacity(const Count& block_capacity_) {
+    if (block_capacity_ == 0) {
+      throw std::runtime_error("ObjectArena::setBlockCapacity|invalid block capacity: 0");
+    }
+    std::lock_guard<std::mutex> lock(_cache()->mutex);
+    if (block_capacity_ != _cache()->block_capacity) {
+      _cache()->block_capacity = block_capacity_;
+      _cache()->freeBlocks();
+    }
+  }
+  static const Count blockCapacity() {std::lock_guard<std::mutex> lock(_cache()->mutex); return _cache()->block_capacity;}
+
+  //! @brief informative only: total number of heap allocated blocks and of blocks acquired by arenas (cache hits and allocations) for this type
+  static const Count numberOfAllocatedBlocks() {std::lock_guard<std::mutex> lock(_cache()->mutex); return _cache()->number_of_allocated_blocks;}
+  static const Count numberOfAcquiredBlocks() {std::lock_guard<std::mutex> lock(_cache()->mutex); return _cache()->number_of_acquired_blocks;}
+
+//ds helpers
+protected:
+
+  //! @brief shared block cache for all arenas of this type (blocks are freed at program exit)
+  struct BlockCache {
+    ~BlockCache() {freeBlocks();}
+    void freeBlocks() {
+      for (const Block& block: blocks) {
+        delete[] block.memory;
+      }
+      blocks.clear();
+    }
+    std::vector<Block> blocks;
+    std::vector<std::vector<Block>> block_lists;
+    Count block_capacity             = 1000;
+    Count number_of_allocated_blocks = 0;
+    Count number_of_acquired_blocks  = 0;
+    std::mutex mutex;
+  };
+  static BlockCache* _cache() {
+    static BlockCache cache;
+    return &cache;
+  }
+
+  //! @brief retrieves a block from the cache or allocates a new one (aligned for the object type, e.g. for Eigen members)
+  static Block _acquireBlock() {
+    std::lock_guard<std::mutex> lock(_cache()->mutex);
+    ++_cache()->number_of_acquired_blocks;
+    if (!_cache()->blocks.empty()) {
+      const Block block = _cache()->blocks.back();
+      _cache()->blocks.pop_back();
+      return block;
+    }
+    constexpr size_t alignment = (alignof(ObjectType_) > 16) ? alignof(ObjectType_) : 16;
+    Block block;
+    block.capacity = _cache()->block_capacity;
+    block.memory   = new uint8_t[block.capacity*sizeof(ObjectType_)+alignment];
+    block.objects  = reinterpret_cast<ObjectType_*>((reinterpret_cast<uintptr_t>(block.memory)+alignment-1) & ~(alignment-1));
+    ++_cache()->number_of_allocated_blocks;
+    return block;
+  }
+
+  //! @brief hands a cached (empty) block list with retained capacity to an arena, if available
+  static void _acquireBlockList(std::vector<Block>& blocks_) {
+    std::lock_guard<std::mutex> lock(_cache()->mutex);
+    if (!_cache()->block_lists.empty()) {
+      blocks_.swap(_cache()->block_lists.back());
+      _cache()->block_lists.pop_back();
+    }
+  }
+
+  //! @brief returns blocks to the cache (blocks of an outdated capacity are freed) - the emptied block list is cached as well
+  static void _releaseBlocks(std::vector<Block>& blocks_) {
+    std::lock_guard<std::mutex> lock(_cache()->mutex);
+    for (const Block& block: blocks_) {
+      if (block.capacity == _cache()->block_capacity) {
+        _cache()->blocks.push_back(block);
+      } else {
+        delete[] block.memory;
+      }
+    }
+    blocks_.clear();
+    _cache()->block_lists.push_back(std::vector<Block>());
+    _cache()->block_lists.back().swap(blocks_);
+  }
+
+//ds attributes
+protected:
+
+  //! @brief blocks in use by this arena (only the last block can be partially filled) - the list itself is recycled through the cache
+  std::vector<Block> _blocks;
+
+  //! @brief object counts
+  Count _number_of_objects_in_last_block = 0;
+  Count _number_of_objects               = 0;
+};
+}
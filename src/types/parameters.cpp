@@ -8,7 +8,7 @@ std::string ParameterCollection::banner =
 "srrg_proslam_app: simple SLAM application\n"
 "usage: srrg_proslam_app [options] <dataset>\n"
 "\n"
-"<dataset>: path to a SRRG txt_io dataset file\n"
+"<dataset>: path to a SRRG txt_io dataset file or a KITTI, EuRoC or TUM RGB-D sequence directory\n"
 "\n"
 "[options]\n"
 "-configuration (-c)            <string>: path to configuration file to load\n"
@@ -25,6 +25,14 @@ std::string ParameterCollection::banner =
 "-equalize-histogram (-eh):               equalize stereo image histogram before processing\n"
 "-recover-landmarks (-rl):                enables landmark track recovery\n"
 "-disable-bundle-adjustment (-dba):       disables periodic bundle adjustment for landmarks and frames\n"
+"-asynchronous-relocalization (-ar):      runs relocalization in a background thread (no blocking of tracking)\n"
+"-prefetch-images (-pi):                  reads and decodes upcoming images in a background thread during playback\n"
+"-pipelined-processing (-pp):             extracts features of the next images while the current ones are processed\n"
+"-drop-images (-di)             <int>:    skips image pairs every <int> image pairs during playback (injected frame drops)\n"
+"-load-map (-lm)                <string>: loads a binary map file before processing (relocalization against a prior map)\n"
+"-save-map (-sm)                <string>: saves the final map to a binary map file\n"
+"-profile (-pf)                 <string>: records profiler spans and saves them as Chrome trace (chrome://tracing) to the file (build with SRRG_PROSLAM_ENABLE_PROFILER)\n"
+"-telemetry (-tm)               <string>: streams per-frame telemetry to a CSV file and saves a JSON run summary next to it\n"
 DOUBLE_BAR;
 
 //! @brief macro wrapping the YAML node parsing for a single parameter
@@ -65,6 +73,24 @@ void CommandLineParameters::print() const {
   std::cerr << "-equalize-histogram (-eh)          " << option_equalize_histogram << std::endl;
   std::cerr << "-recover-landmarks (-rl)           " << option_recover_landmarks << std::endl;
   std::cerr << "-disable-bundle-adjustment (-dba)  " << option_disable_bundle_adjustment << std::endl;
+  std::cerr << "-asynchronous-relocalization (-ar) " << option_asynchronous_relocalization << std::endl;
+  std::cerr << "-prefetch-images (-pi)             " << option_prefetch_images << std::endl;
+  std::cerr << "-pipelined-processing (-pp)        " << option_pipelined_processing << std::endl;
+  if (image_drop_interval > 0) {
+  std::cerr << "-drop-images (-di)                 " << image_drop_interval << " (burst length: " << image_drop_burst_length << ")" << std::endl;
+  }
+  if (map_file_name_to_load.length() > 0) {
+  std::cerr << "-load-map (-lm)                   '" << map_file_name_to_load << "'" << std::endl;
+  }
+  if (map_file_name_to_save.length() > 0) {
+  std::cerr << "-save-map (-sm)                   '" << map_file_name_to_save << "'" << std::endl;
+  }
+  if (profile_file_name.length() > 0) {
+  std::cerr << "-profile (-pf)                    '" << profile_file_name << "'" << std::endl;
+  }
+  if (telemetry_file_name.length() > 0) {
+  std::cerr << "-telemetry (-tm)                  '" << telemetry_file_name << "'" << std::endl;
+  }
   if (dataset_file_name.length() > 0) {
   std::cerr << "-dataset                          '" << dataset_file_name  << "'" << std::endl;
   }
@@ -75,10 +101,17 @@ void AlignerParameters::print() const {
   std::cerr << "AlignerParameters::print|maximum_error_kernel: " << maximum_error_kernel << std::endl;
   std::cerr << "AlignerParameters::print|minimum_number_of_inliers: " << minimum_number_of_inliers << std::endl;
   std::cerr << "AlignerParameters::print|minimum_inlier_ratio: " << minimum_inlier_ratio << std::endl;
+  std::cerr << "AlignerParameters::print|convergence_policy: " << convergence_policy << std::endl;
+  std::cerr << "AlignerParameters::print|minimum_step_norm: " << minimum_step_norm << std::endl;
+  std::cerr << "AlignerParameters::print|minimum_relative_error_delta: " << minimum_relative_error_delta << std::endl;
+  std::cerr << "AlignerParameters::print|maximum_duration_seconds: " << maximum_duration_seconds << std::endl;
 }
 
 void LandmarkParameters::print() const {
 //  std::cerr << "LandmarkParameters::print|minimum_number_of_forced_updates: " << minimum_number_of_forced_updates << std::endl;
+  std::cerr << "LandmarkParameters::print|maximum_number_of_window_measurements: " << maximum_number_of_window_measurements << std::endl;
+  std::cerr << "LandmarkParameters::print|maximum_number_of_descriptors: " << maximum_number_of_descriptors << std::endl;
+  std::cerr << "LandmarkParameters::print|maximum_number_of_representative_descriptors: " << maximum_number_of_representative_descriptors << std::endl;
 }
 
 void LocalMapParameters::print() const {
@@ -89,6 +122,8 @@ void WorldMapParameters::print() const {
   std::cerr << "WorldMapParameters::print|minimum_distance_traveled_for_local_map: " << minimum_distance_traveled_for_local_map << std::endl;
   std::cerr << "WorldMapParameters::print|minimum_degrees_rotated_for_local_map: " << minimum_degrees_rotated_for_local_map << std::endl;
   std::cerr << "WorldMapParameters::print|minimum_number_of_frames_for_local_map: " << minimum_number_of_frames_for_local_map << std::endl;
+  std::cerr << "WorldMapParameters::print|maximum_number_of_frames_in_window: " << maximum_number_of_frames_in_window << std::endl;
+  std::cerr << "WorldMapParameters::print|maximum_number_of_landmarks_in_window: " << maximum_number_of_landmarks_in_window << std::endl;
   landmark->print();
   local_map->print();
 }
@@ -97,14 +132,19 @@ void BaseFramePointGeneratorParameters::print() const {
   std::cerr << "BaseFramepointGeneratorParameters::print|target_number_of_keypoints_tolerance: " << target_number_of_keypoints_tolerance << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|detector_threshold_minimum: " << detector_threshold_minimum << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|detector_threshold_maximum_change: " << detector_threshold_maximum_change << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|enable_parallel_keypoint_detection: " << enable_parallel_keypoint_detection << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|matching_distance_tracking_threshold: " << minimum_descriptor_distance_tracking << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|enable_keypoint_binning: " << enable_keypoint_binning << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|bin_size_pixels: " << bin_size_pixels << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|search_region_shape: " << search_region_shape << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|search_region_number_of_standard_deviations: " << search_region_number_of_standard_deviations << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|search_region_minimum_standard_deviation_pixels: " << search_region_minimum_standard_deviation_pixels << std::endl;
 }
 
 void StereoFramePointGeneratorParameters::print() const {
   std::cerr << "StereoFramepointGeneratorParameters::print|maximum_matching_distance_triangulation: " << maximum_matching_distance_triangulation << std::endl;
   std::cerr << "StereoFramepointGeneratorParameters::print|minimum_disparity_pixels: " << minimum_disparity_pixels << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|enable_parallel_feature_extraction: " << enable_parallel_feature_extraction << std::endl;
   BaseFramePointGeneratorParameters::print();
 }
 
@@ -117,6 +157,11 @@ PoseTracker3DParameters::PoseTracker3DParameters(): aligner(new AlignerParameter
 void PoseTracker3DParameters::print() const {
   std::cerr << "BaseTrackerParameters::print|minimum_number_of_landmarks_to_track: " << minimum_number_of_landmarks_to_track << std::endl;
   std::cerr << "BaseTrackerParameters::print|maximum_number_of_landmark_recoveries: " << maximum_number_of_landmark_recoveries << std::endl;
+  std::cerr << "BaseTrackerParameters::print|enable_ransac_initialization: " << enable_ransac_initialization << std::endl;
+  std::cerr << "BaseTrackerParameters::print|maximum_descriptor_distance_initialization: " << maximum_descriptor_distance_initialization << std::endl;
+  std::cerr << "BaseTrackerParameters::print|number_of_ransac_iterations_initialization: " << number_of_ransac_iterations_initialization << std::endl;
+  std::cerr << "BaseTrackerParameters::print|maximum_reprojection_error_pixels_initialization: " << maximum_reprojection_error_pixels_initialization << std::endl;
+  std::cerr << "BaseTrackerParameters::print|minimum_number_of_inliers_initialization: " << minimum_number_of_inliers_initialization << std::endl;
   aligner->print();
 }
 
@@ -131,10 +176,22 @@ void RelocalizerParameters::print() const {
 void GraphOptimizerParameters::print() const {
   std::cerr << "GraphOptimizerParameters::print|identifier_space: " << identifier_space << std::endl;
   std::cerr << "GraphOptimizerParameters::print|number_of_frames_per_bundle_adjustment: " << number_of_frames_per_bundle_adjustment << std::endl;
+  std::cerr << "GraphOptimizerParameters::print|enable_sliding_window_bundle_adjustment: " << enable_sliding_window_bundle_adjustment << std::endl;
+  std::cerr << "GraphOptimizerParameters::print|number_of_keyframes_in_sliding_window: " << number_of_keyframes_in_sliding_window << std::endl;
   std::cerr << "GraphOptimizerParameters::print|base_information_frame: " << base_information_frame << std::endl;
   std::cerr << "GraphOptimizerParameters::print|enable_robust_kernel_for_landmark_measurements: " << enable_robust_kernel_for_landmarks << std::endl;
 }
 
+void ThreadPoolParameters::print() const {
+  std::cerr << "ThreadPoolParameters::print|number_of_threads: " << number_of_threads << std::endl;
+  std::cerr << "ThreadPoolParameters::print|enable_cpu_pinning: " << enable_cpu_pinning << std::endl;
+  std::cerr << "ThreadPoolParameters::print|maximum_number_of_threads_feature_extraction: " << maximum_number_of_threads_feature_extraction << std::endl;
+  std::cerr << "ThreadPoolParameters::print|maximum_number_of_threads_tracking: " << maximum_number_of_threads_tracking << std::endl;
+  std::cerr << "ThreadPoolParameters::print|maximum_number_of_threads_relocalization: " << maximum_number_of_threads_relocalization << std::endl;
+  std::cerr << "ThreadPoolParameters::print|maximum_number_of_threads_optimization: " << maximum_number_of_threads_optimization << std::endl;
+  std::cerr << "ThreadPoolParameters::print|maximum_number_of_threads_dataset_decoding: " << maximum_number_of_threads_dataset_decoding << std::endl;
+}
+
 void ImageViewerParameters::print() const {
 
 }
@@ -153,6 +210,7 @@ ParameterCollection::ParameterCollection(): _parameters(this),
   world_map_parameters       = new WorldMapParameters();
   relocalizer_parameters     = new RelocalizerParameters();
   graph_optimizer_parameters = new GraphOptimizerParameters();
+  thread_pool_parameters     = new ThreadPoolParameters();
   tracker_parameters         = new PoseTracker3DParameters();
 
   image_viewer_parameters   = new ImageViewerParameters();
@@ -168,6 +226,7 @@ ParameterCollection::~ParameterCollection() {
   delete world_map_parameters;
   delete relocalizer_parameters;
   delete graph_optimizer_parameters;
+  delete thread_pool_parameters;
 
   delete image_viewer_parameters;
   delete map_viewer_parameters;
@@ -251,6 +310,36 @@ void ParameterCollection::parseFromCommandLine(const int32_t& argc_, char ** arg
       command_line_parameters->tracker_mode = CommandLineParameters::TrackerMode::RGB_DEPTH;
     } else if (!std::strcmp(argv_[number_of_checked_parameters], "-recover-landmarks") || !std::strcmp(argv_[number_of_checked_parameters], "-rl")) {
       command_line_parameters->option_recover_landmarks = true;
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-asynchronous-relocalization") || !std::strcmp(argv_[number_of_checked_parameters], "-ar")) {
+      command_line_parameters->option_asynchronous_relocalization = true;
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-prefetch-images") || !std::strcmp(argv_[number_of_checked_parameters], "-pi")) {
+      command_line_parameters->option_prefetch_images = true;
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-pipelined-processing") || !std::strcmp(argv_[number_of_checked_parameters], "-pp")) {
+      command_line_parameters->option_pipelined_processing = true;
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-drop-images") || !std::strcmp(argv_[number_of_checked_parameters], "-di")) {
+      number_of_checked_parameters++;
+      if (number_of_checked_parameters == argc_) {break;}
+      command_line_parameters->image_drop_interval = std::stoi(argv_[number_of_checked_parameters]);
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-load-map") || !std::strcmp(argv_[number_of_checked_parameters], "-lm")) {
+      number_of_checked_parameters++;
+      if (number_of_checked_parameters == argc_) {break;}
+      command_line_parameters->map_file_name_to_load = argv_[number_of_checked_parameters];
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-save-map") || !std::strcmp(argv_[number_of_checked_parameters], "-sm")) {
+      number_of_checked_parameters++;
+      if (number_of_checked_parameters == argc_) {break;}
+      command_line_parameters->map_file_name_to_save = argv_[number_of_checked_parameters];
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-profile") || !std::strcmp(argv_[number_of_checked_parameters], "-pf")) {
+      number_of_checked_parameters++;
+      if (number_of_checked_parameters == argc_) {break;}
+      command_line_parameters->profile_file_name = argv_[number_of_checked_parameters];
+#ifndef SRRG_PROSLAM_ENABLE_PROFILER
+      LOG_ERROR(std::cerr << "ParameterCollection::parseFromCommandLine|-profile requires a build with SRRG_PROSLAM_ENABLE_PROFILER" << std::endl)
+      throw std::runtime_error("profiler not compiled in");
+#endif
+    } else if (!std::strcmp(argv_[number_of_checked_parameters], "-telemetry") || !std::strcmp(argv_[number_of_checked_parameters], "-tm")) {
+      number_of_checked_parameters++;
+      if (number_of_checked_parameters == argc_) {break;}
+      command_line_parameters->telemetry_file_name = argv_[number_of_checked_parameters];
     } else if (!std::strcmp(argv_[number_of_checked_parameters], "-configuration") || !std::strcmp(argv_[number_of_checked_parameters], "-c")) {
       number_of_checked_parameters++;
     } else {
@@ -304,13 +393,27 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_equalize_histogram, bool)
     PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_recover_landmarks, bool)
     PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_disable_bundle_adjustment, bool)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_asynchronous_relocalization, bool)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_prefetch_images, bool)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, option_pipelined_processing, bool)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, prefetch_queue_size, Count)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, prefetch_maximum_megabytes, real)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, dataset_decoding_batch_size, Count)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, image_drop_interval, Count)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, image_drop_burst_length, Count)
+    PARSE_PARAMETER(configuration, command_line, command_line_parameters, telemetry_number_of_slowest_frames, Count)
     PARSE_PARAMETER(configuration, command_line, command_line_parameters, maximum_time_interval_seconds, real)
 
     //Types
     PARSE_PARAMETER(configuration, world_map, world_map_parameters, minimum_distance_traveled_for_local_map, real)
     PARSE_PARAMETER(configuration, world_map, world_map_parameters, minimum_degrees_rotated_for_local_map, real)
     PARSE_PARAMETER(configuration, world_map, world_map_parameters, minimum_number_of_frames_for_local_map, Count)
+    PARSE_PARAMETER(configuration, world_map, world_map_parameters, maximum_number_of_frames_in_window, Count)
+    PARSE_PARAMETER(configuration, world_map, world_map_parameters, maximum_number_of_landmarks_in_window, Count)
     PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, maximum_error_squared_meters, real)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, maximum_number_of_window_measurements, Count)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, maximum_number_of_descriptors, Count)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, maximum_number_of_representative_descriptors, Count)
     PARSE_PARAMETER(configuration, local_map, world_map_parameters->local_map, minimum_number_of_landmarks, Count)
 
     //ds mode specific parameters
@@ -323,6 +426,7 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, maximum_matching_distance_triangulation, int32_t)
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, minimum_disparity_pixels, real)
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, maximum_epipolar_search_offset_pixels, int32_t)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, enable_parallel_feature_extraction, bool)
         break;
       }
       case CommandLineParameters::TrackerMode::RGB_DEPTH: {
@@ -348,6 +452,7 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, detector_threshold_maximum_change, real)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_detectors_vertical, int32_t)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_detectors_horizontal, int32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_parallel_keypoint_detection, bool)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, minimum_descriptor_distance_tracking, real)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, maximum_descriptor_distance_tracking, real)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, maximum_reliable_depth_meters, real)
@@ -357,6 +462,23 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, maximum_projection_tracking_distance_pixels, int32_t)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_keypoint_binning, bool)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, bin_size_pixels, Count)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, search_region_number_of_standard_deviations, real)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, search_region_minimum_standard_deviation_pixels, real)
+
+    //ds parse tracking search region shape as string
+    const std::string& search_region_shape = configuration["base_framepoint_generation"]["search_region_shape"].as<std::string>();
+    ++number_of_parameters_detected;
+    if (search_region_shape == "SQUARE") {
+      framepoint_generation_parameters->search_region_shape = BaseFramePointGeneratorParameters::SearchRegionShape::SQUARE;
+    } else if (search_region_shape == "RECTANGLE") {
+      framepoint_generation_parameters->search_region_shape = BaseFramePointGeneratorParameters::SearchRegionShape::RECTANGLE;
+    } else if (search_region_shape == "ELLIPSE") {
+      framepoint_generation_parameters->search_region_shape = BaseFramePointGeneratorParameters::SearchRegionShape::ELLIPSE;
+    } else {
+      LOG_ERROR(std::cerr << "ParameterCollection::parseFromFile|invalid search region shape: " << search_region_shape << std::endl)
+      throw std::runtime_error("invalid search region shape");
+    }
+    ++number_of_parameters_parsed;
 
     //MotionEstimation (GENERIC)
     PARSE_PARAMETER(configuration, tracking, tracker_parameters, minimum_track_length_for_landmark_creation, Count)
@@ -372,7 +494,15 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->minimum_number_of_inliers, Count)
     PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->minimum_inlier_ratio, real)
     PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->enable_inverse_depth_as_information, bool)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->minimum_step_norm, real)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->minimum_relative_error_delta, real)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, aligner->maximum_duration_seconds, real)
     PARSE_PARAMETER(configuration, tracking, tracker_parameters, good_tracking_ratio, real)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, enable_ransac_initialization, bool)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, maximum_descriptor_distance_initialization, real)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, number_of_ransac_iterations_initialization, Count)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, maximum_reprojection_error_pixels_initialization, real)
+    PARSE_PARAMETER(configuration, tracking, tracker_parameters, minimum_number_of_inliers_initialization, Count)
 
     //ds parse desired motion model as string
     const std::string& motion_model = configuration["tracking"]["motion_model"].as<std::string>();
@@ -389,6 +519,19 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     }
     ++number_of_parameters_parsed;
 
+    //ds parse aligner convergence policy as string
+    const std::string& convergence_policy = configuration["tracking"]["aligner->convergence_policy"].as<std::string>();
+    ++number_of_parameters_detected;
+    if (convergence_policy == "GAUSS_NEWTON") {
+      tracker_parameters->aligner->convergence_policy = AlignerParameters::ConvergencePolicy::GAUSS_NEWTON;
+    } else if (convergence_policy == "LEVENBERG_MARQUARDT") {
+      tracker_parameters->aligner->convergence_policy = AlignerParameters::ConvergencePolicy::LEVENBERG_MARQUARDT;
+    } else {
+      LOG_ERROR(std::cerr << "ParameterCollection::parseFromFile|invalid aligner convergence policy: " << convergence_policy << std::endl)
+      throw std::runtime_error("invalid aligner convergence policy");
+    }
+    ++number_of_parameters_parsed;
+
     //Relocalization (GENERIC)
     PARSE_PARAMETER(configuration, relocalization, relocalizer_parameters, maximum_descriptor_distance, real)
     PARSE_PARAMETER(configuration, relocalization, relocalizer_parameters, preliminary_minimum_interspace_queries, Count)
@@ -409,6 +552,8 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, maximum_number_of_iterations, Count)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, identifier_space, real)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, number_of_frames_per_bundle_adjustment, Count)
+    PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, enable_sliding_window_bundle_adjustment, bool)
+    PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, number_of_keyframes_in_sliding_window, Count)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, base_information_frame, real)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, free_translation_for_poses, bool)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, base_information_frame_factor_for_translation, real)
@@ -416,6 +561,15 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, enable_robust_kernel_for_landmarks, bool)
     PARSE_PARAMETER(configuration, graph_optimization, graph_optimizer_parameters, minimum_estimation_delta_for_update_meters, real)
 
+    //ds shared thread pool
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, number_of_threads, Count)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, enable_cpu_pinning, bool)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, maximum_number_of_threads_feature_extraction, Count)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, maximum_number_of_threads_tracking, Count)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, maximum_number_of_threads_relocalization, Count)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, maximum_number_of_threads_optimization, Count)
+    PARSE_PARAMETER(configuration, thread_pool, thread_pool_parameters, maximum_number_of_threads_dataset_decoding, Count)
+
     //ds viewers
     PARSE_PARAMETER(configuration, visualization, map_viewer_parameters, follow_robot, bool)
     PARSE_PARAMETER(configuration, visualization, image_viewer_parameters, display_secondary_image, bool)
@@ -470,5 +624,6 @@ void ParameterCollection::print() const {
   if (tracker_parameters) {tracker_parameters->print();}
   if (relocalizer_parameters) {relocalizer_parameters->print();}
   if (graph_optimizer_parameters) {graph_optimizer_parameters->print();}
+  if (thread_pool_parameters) {thread_pool_parameters->print();}
 }
 }
@@ -48,6 +48,19 @@ public:
   std::string dataset_file_name       = "";
   std::string configuration_file_name = "";
 
+  //! @brief binary map files: prior map loaded before processing and destination of the final map (disabled if empty)
+  std::string map_file_name_to_load = "";
+  std::string map_file_name_to_save = "";
+
+  //! @brief profiler trace file: enables the profiler, spans are written as Chrome trace-event JSON after processing (disabled if empty)
+  std::string profile_file_name = "";
+
+  //! @brief per-frame telemetry CSV file: a JSON summary is written next to it after processing (disabled if empty)
+  std::string telemetry_file_name = "";
+
+  //! @brief number of slowest frames listed with their stage times in the telemetry summary
+  Count telemetry_number_of_slowest_frames = 10;
+
   //! @brief options
   bool option_use_gui                   = false;
   bool option_disable_relocalization    = false;
@@ -58,6 +71,30 @@ public:
   bool option_disable_bundle_adjustment = true;
   bool option_save_pose_graph           = false;
 
+  //! @brief runs relocalization (place recognition and closure registration) in a background thread
+  //! @brief detected closures are integrated at the next local map creation after their registration completed
+  bool option_asynchronous_relocalization = false;
+
+  //! @brief extracts features of the next image pair in a separate thread while the current one is tracked and mapped (playback only)
+  //! @brief increases throughput at the cost of one frame of additional latency, the detector threshold policy uses the pose reliability of the previous frame
+  bool option_pipelined_processing = false;
+
+  //! @brief reads, decodes and preprocesses upcoming stereo images in a background thread during message file playback
+  bool option_prefetch_images = false;
+
+  //! @brief maximum number of prefetched stereo image pairs
+  Count prefetch_queue_size = 8;
+
+  //! @brief maximum image memory held by prefetched stereo image pairs (at least one pair is always prefetched)
+  real prefetch_maximum_megabytes = 256;
+
+  //! @brief number of image pairs decoded in parallel when reading a native dataset directory (KITTI, EuRoC, TUM)
+  Count dataset_decoding_batch_size = 8;
+
+  //! @brief injected frame drops (track recovery evaluation): image_drop_burst_length image pairs are skipped every image_drop_interval image pairs (0: disabled)
+  Count image_drop_interval     = 0;
+  Count image_drop_burst_length = 1;
+
   //! @brief sensor data synchronization interval size
   real maximum_time_interval_seconds = 0.001;
 };
@@ -92,6 +129,22 @@ public:
 
   //! @brief enable inverse depth as information matrix factor for translation
   bool enable_inverse_depth_as_information = true;
+
+  //! @brief iteration scheme of the frame aligners
+  enum ConvergencePolicy {GAUSS_NEWTON,         //ds undamped steps until the error delta falls below error_delta_for_convergence
+                          LEVENBERG_MARQUARDT}; //ds adaptively damped steps with step norm, relative error and time budget stopping
+
+  //! @brief selected iteration scheme of the frame aligners
+  ConvergencePolicy convergence_policy = ConvergencePolicy::LEVENBERG_MARQUARDT;
+
+  //! @brief minimum pose perturbation norm to continue (LEVENBERG_MARQUARDT)
+  real minimum_step_norm = 1e-6;
+
+  //! @brief minimum relative error decrease of an accepted step to continue (LEVENBERG_MARQUARDT)
+  real minimum_relative_error_delta = 1e-4;
+
+  //! @brief maximum duration of an alignment in seconds, the best estimate so far is kept once exceeded (0: unlimited, LEVENBERG_MARQUARDT)
+  real maximum_duration_seconds = 0.01;
 };
 
 //! @class landmark parameters
@@ -112,6 +165,18 @@ public:
 
   //! @brief maximum number of LS iterations for landmark position optimization
   Count maximum_number_of_iterations = 100;
+
+  //! @brief number of most recent measurements that are robustly re-weighted in each position update
+  //! @brief older measurements are accumulated in information form (constant time per update and bounded measurement memory per landmark)
+  Count maximum_number_of_window_measurements = 10;
+
+  //! @brief maximum number of descriptors buffered per landmark until they are captured in a local map (0: unbounded)
+  //! @brief on overflow the buffer is reduced to half of it by representative selection (bounded memory also without relocalization)
+  Count maximum_number_of_descriptors = 32;
+
+  //! @brief maximum number of representative descriptors per landmark and local map that enter the place database (0: all descriptors)
+  //! @brief the representatives are selected as greedy medoids in Hamming space from the descriptors measured since the last local map
+  Count maximum_number_of_representative_descriptors = 5;
 };
 
 //! @class local map parameters
@@ -150,6 +215,13 @@ public:
   real minimum_degrees_rotated_for_local_map   = 0.5;
   Count minimum_number_of_frames_for_local_map = 4;
 
+  //! @brief bounded-memory odometry window (active if relocalization is disabled and framepoints are dropped)
+  //! @brief frames leaving the window are freed together with their landmarks that are no longer tracked (only the poses are kept, spilled to a temporary file)
+  Count maximum_number_of_frames_in_window    = 250;
+
+  //! @brief hard limit on the number of landmarks in the odometry window, oldest untracked landmarks are freed first (0: no limit)
+  Count maximum_number_of_landmarks_in_window = 0;
+
   //! @brief landmark generation parameters
   LandmarkParameters* landmark;
 
@@ -180,6 +252,9 @@ public:
   uint32_t number_of_detectors_vertical   = 1;
   uint32_t number_of_detectors_horizontal = 1;
 
+  //! @brief distribute the detector regions over the shared thread pool (for grids with more than one detector)
+  bool enable_parallel_keypoint_detection = true;
+
   //! @brief number of camera image streams (required for detector regions)
   uint32_t number_of_cameras = 1;
 
@@ -187,6 +262,20 @@ public:
   int32_t minimum_projection_tracking_distance_pixels = 15;
   int32_t maximum_projection_tracking_distance_pixels = 50;
 
+  //! @brief shape of the per-point tracking search regions
+  enum SearchRegionShape {SQUARE,     //ds square window of the current projection tracking distance for every point
+                          RECTANGLE,  //ds bounding rectangle of the projected motion prediction uncertainty of each point
+                          ELLIPSE};   //ds projected motion prediction uncertainty ellipse of each point
+
+  //! @brief selected search region shape (RECTANGLE and ELLIPSE are bounded by the square window and fall back to it without motion covariance)
+  SearchRegionShape search_region_shape = SearchRegionShape::ELLIPSE;
+
+  //! @brief extent of the RECTANGLE and ELLIPSE search regions in standard deviations of the projected uncertainty
+  real search_region_number_of_standard_deviations = 3;
+
+  //! @brief minimum standard deviation of the projected uncertainty in pixels (keypoint localization noise)
+  real search_region_minimum_standard_deviation_pixels = 2;
+
   //! @brief dynamic thresholds for descriptor matching
   real minimum_descriptor_distance_tracking = 0.1*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS;
   real maximum_descriptor_distance_tracking = 0.2*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS;
@@ -219,6 +308,9 @@ public:
 
   //! @brief maximum checked epipolar line offsets
   int32_t maximum_epipolar_search_offset_pixels  = 0;
+
+  //! @brief process left and right image streams in parallel (detection and descriptor extraction)
+  bool enable_parallel_feature_extraction = true;
 };
 
 //! @class framepoint generation parameters for a rgbd camera setup
@@ -279,6 +371,13 @@ public:
   //! @brief desired motion model (if any)
   MotionModel motion_model = MotionModel::CONSTANT_VELOCITY;
 
+  //! @brief global pose initialization (PnP RANSAC on descriptor matches) when localizing or after a failed registration
+  bool enable_ransac_initialization                     = true;
+  real maximum_descriptor_distance_initialization       = 0.2*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS;
+  Count number_of_ransac_iterations_initialization      = 100;
+  real maximum_reprojection_error_pixels_initialization = 2;
+  Count minimum_number_of_inliers_initialization        = 30;
+
   //! @brief parameters of aligner unit
   AlignerParameters* aligner;
 };
@@ -346,6 +445,12 @@ public:
   //! @brief determines window size for bundle adjustment
   Count number_of_frames_per_bundle_adjustment = 100;
 
+  //! @brief sliding window bundle adjustment: the window is optimized for every new local map, keyframes leaving the window are marginalized into a pose prior
+  bool enable_sliding_window_bundle_adjustment = false;
+
+  //! @brief maximum number of keyframes in the sliding window (older keyframes are marginalized)
+  Count number_of_keyframes_in_sliding_window = 10;
+
   //! @brief base frame weight in pose graph (assuming 1 for landmarks)
   real base_information_frame = 1e5;
 
@@ -365,6 +470,33 @@ public:
   real minimum_estimation_delta_for_update_meters = 0.01;
 };
 
+//! @class shared thread pool parameters
+class ThreadPoolParameters: public Parameters {
+public:
+
+  //! @brief default constructor
+  ThreadPoolParameters() {}
+
+  //! @brief destructor: clean inner parameters
+  ~ThreadPoolParameters() {}
+
+  //! @brief parameter printing function
+  virtual void print() const;
+
+  //! @brief total number of threads including the calling thread (0: number of hardware threads, 1: sequential processing)
+  Count number_of_threads = 0;
+
+  //! @brief pin each worker thread to a single CPU core (linux only)
+  bool enable_cpu_pinning = false;
+
+  //! @brief maximum number of threads working on a single parallel loop of a processing stage (0: no cap)
+  Count maximum_number_of_threads_feature_extraction = 0;
+  Count maximum_number_of_threads_tracking           = 0;
+  Count maximum_number_of_threads_relocalization     = 0;
+  Count maximum_number_of_threads_optimization       = 0;
+  Count maximum_number_of_threads_dataset_decoding   = 0;
+};
+
 //! @class image viewer parameters
 class ImageViewerParameters: public Parameters {
 public:
@@ -463,6 +595,7 @@ public:
   PoseTracker3DParameters* tracker_parameters                                 = nullptr;
   RelocalizerParameters* relocalizer_parameters                               = nullptr;
   GraphOptimizerParameters* graph_optimizer_parameters                        = nullptr;
+  ThreadPoolParameters* thread_pool_parameters                                = nullptr;
 
   ImageViewerParameters* image_viewer_parameters = nullptr;
   MapViewerParameters* map_viewer_parameters     = nullptr;
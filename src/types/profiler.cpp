@@ -0,0 +1,205 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include "definitions.h"
+
+namespace proslam {
+
+//ds span buffer of the calling thread (registered in the profiler on first use)
+thread_local Profiler::ThreadBuffer* thread_buffer_of_current_thread = nullptr;
+
+std::atomic<bool> Profiler::_is_enabled(false);
+std::atomic<uint32_t> Profiler::_frame_identifier(0);
+thread_local uint32_t Profiler::_frame_identifier_of_thread = 0;
+thread_local bool Profiler::_has_frame_identifier_of_thread = false;
+uint32_t Profiler::_spans_per_thread = 65536;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::_thread_buffers;
+std::mutex Profiler::_mutex;
+
+void Profiler::enable(const uint32_t& spans_per_thread_) {
+#ifndef SRRG_PROSLAM_ENABLE_PROFILER
+  LOG_WARNING(std::cerr << "Profiler::enable|profiler not compiled in (SRRG_PROSLAM_ENABLE_PROFILER not defined) - no spans will be recorded" << std::endl)
+#endif
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    //ds the capacity can only be set as long as no thread buffer has been allocated
+    if (_thread_buffers.empty()) {
+      _spans_per_thread = std::max(spans_per_thread_, 1u);
+    }
+  }
+  _is_enabled.store(true, std::memory_order_relaxed);
+  LOG_INFO(std::cerr << "Profiler::enable|recording spans (capacity per thread: " << _spans_per_thread << ")" << std::endl)
+}
+
+void Profiler::disable() {
+  _is_enabled.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (std::unique_ptr<ThreadBuffer>& buffer: _thread_buffers) {
+    buffer->number_of_records = 0;
+  }
+}
+
+void Profiler::writeChromeTrace(const std::string& file_name_) {
+  std::ofstream outfile(file_name_, std::ifstream::out);
+  if (!outfile.good()) {
+    LOG_ERROR(std::cerr << "Profiler::writeChromeTrace|unable to open file: '" << file_name_ << "'" << std::endl)
+    throw std::runtime_error("unable to open profiler trace file");
+  }
+  std::vector<std::pair<uint32_t, Record>> records;
+  _collect(records);
+
+  //ds timestamps relative to the earliest span in microseconds (trace-event unit)
+  uint64_t begin_nanoseconds = std::numeric_limits<uint64_t>::max();
+  for (const std::pair<uint32_t, Record>& record: records) {
+    begin_nanoseconds = std::min(begin_nanoseconds, record.second.begin_nanoseconds);
+  }
+
+  //ds complete events (ph: X), one per span
+  outfile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  char buffer[512];
+  for (size_t index = 0; index < records.size(); ++index) {
+    const Record& record = records[index].second;
+    std::snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",\"cat\":\"proslam\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                                          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"depth\":%u}}%s\n",
+                  _label(record).c_str(),
+                  records[index].first,
+                  (record.begin_nanoseconds-begin_nanoseconds)/1e3,
+                  (record.end_nanoseconds-record.begin_nanoseconds)/1e3,
+                  record.frame_identifier,
+                  record.depth,
+                  (index+1 < records.size()) ? "," : "");
+    outfile << buffer;
+  }
+  outfile << "]}\n";
+  outfile.close();
+  LOG_INFO(std::cerr << "Profiler::writeChromeTrace|saved spans: " << records.size() << " to: '" << file_name_ << "'" << std::endl)
+}
+
+void Profiler::printStatistics(std::ostream& stream_, const double& processing_time_seconds_) {
+  std::vector<std::pair<uint32_t, Record>> records;
+  _collect(records);
+
+  //ds group span durations by label, keeping the frame of each measurement
+  std::map<std::string, std::vector<std::pair<uint64_t, uint32_t>>> durations_per_label;
+  for (const std::pair<uint32_t, Record>& record: records) {
+    durations_per_label[_label(record.second)].push_back(std::make_pair(record.second.end_nanoseconds-record.second.begin_nanoseconds,
+                                                                        record.second.frame_identifier));
+  }
+
+  stream_ << "time consumption overview - profiler spans (recorded: " << records.size() << ")" << std::endl;
+  stream_ << BAR << std::endl;
+  stream_ << "                                      span |   count |  total (s) |   p50 (ms) |   p95 (ms) |   p99 (ms) |   max (ms) | max frame" << std::endl;
+  stream_ << BAR << std::endl;
+  char buffer[256];
+  for (std::pair<const std::string, std::vector<std::pair<uint64_t, uint32_t>>>& durations: durations_per_label) {
+    std::vector<std::pair<uint64_t, uint32_t>>& values = durations.second;
+    std::sort(values.begin(), values.end());
+    uint64_t total_nanoseconds = 0;
+    for (const std::pair<uint64_t, uint32_t>& value: values) {
+      total_nanoseconds += value.first;
+    }
+    auto percentile_milliseconds = [&values](const double& percentile_) {
+      const size_t index = std::min(static_cast<size_t>(percentile_*values.size()), values.size()-1);
+      return values[index].first/1e6;
+    };
+    std::snprintf(buffer, sizeof(buffer), "%42s | %7zu | %10.4f | %10.4f | %10.4f | %10.4f | %10.4f | %9u\n",
+                  durations.first.c_str(),
+                  values.size(),
+                  total_nanoseconds/1e9,
+                  percentile_milliseconds(0.5),
+                  percentile_milliseconds(0.95),
+                  percentile_milliseconds(0.99),
+                  values.back().first/1e6,
+                  values.back().second);
+    stream_ << buffer;
+  }
+  stream_ << BAR << std::endl;
+
+  //ds recording overhead of the run
+  const double span_cost_seconds = measureSpanCostSeconds();
+  const double overhead_seconds  = span_cost_seconds*records.size();
+  stream_ << "profiler overhead (s): " << overhead_seconds << " (cost per span (ns): " << 1e9*span_cost_seconds;
+  if (processing_time_seconds_ > 0) {
+    stream_ << ", of processing time: " << 100*overhead_seconds/processing_time_seconds_ << "%";
+  }
+  stream_ << ")" << std::endl;
+  stream_ << BAR << std::endl;
+}
+
+const double Profiler::measureSpanCostSeconds(const uint32_t& number_of_spans_) {
+
+  //ds record into a scratch buffer of the calling thread (no other thread may record meanwhile, as recording is enabled temporarily)
+  ThreadBuffer buffer_scratch;
+  buffer_scratch.records.resize(std::max(std::min(number_of_spans_, _spans_per_thread), 1u));
+  ThreadBuffer* buffer_of_thread  = thread_buffer_of_current_thread;
+  const bool was_enabled          = isEnabled();
+  thread_buffer_of_current_thread = &buffer_scratch;
+  _is_enabled.store(true, std::memory_order_relaxed);
+  const uint64_t begin_nanoseconds = nanoseconds();
+  for (uint32_t index = 0; index < number_of_spans_; ++index) {
+    Span span("calibration", __PRETTY_FUNCTION__);
+  }
+  const uint64_t end_nanoseconds = nanoseconds();
+  _is_enabled.store(was_enabled, std::memory_order_relaxed);
+  thread_buffer_of_current_thread = buffer_of_thread;
+  return 1e-9*(end_nanoseconds-begin_nanoseconds)/std::max(number_of_spans_, 1u);
+}
+
+Profiler::ThreadBuffer* Profiler::_threadBuffer() {
+  if (!thread_buffer_of_current_thread) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ThreadBuffer* buffer  = new ThreadBuffer();
+    buffer->records.resize(_spans_per_thread);
+    buffer->thread_index = _thread_buffers.size();
+    _thread_buffers.push_back(std::unique_ptr<ThreadBuffer>(buffer));
+    thread_buffer_of_current_thread = buffer;
+  }
+  return thread_buffer_of_current_thread;
+}
+
+std::string Profiler::_label(const Record& record_) {
+
+  //ds strip the signature down to the qualified function name (e.g. void proslam::Relocalizer::compute() -> proslam::Relocalizer::compute)
+  std::string function(record_.scope);
+  function = function.substr(0, function.find('('));
+  const size_t index_name_begin = function.rfind(' ');
+  if (index_name_begin != std::string::npos) {
+    function = function.substr(index_name_begin+1);
+  }
+
+  //ds use the enclosing class if available, otherwise the function
+  const size_t index_function_begin = function.rfind("::");
+  if (index_function_begin != std::string::npos) {
+    function = function.substr(0, index_function_begin);
+  }
+  const size_t index_class_begin = function.rfind("::");
+  if (index_class_begin != std::string::npos) {
+    function = function.substr(index_class_begin+2);
+  }
+  return function+"::"+record_.name;
+}
+
+void Profiler::_collect(std::vector<std::pair<uint32_t, Record>>& records_) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  records_.clear();
+  for (const std::unique_ptr<ThreadBuffer>& buffer: _thread_buffers) {
+    const uint64_t capacity          = buffer->records.size();
+    const uint64_t number_of_records = std::min(buffer->number_of_records, capacity);
+
+    //ds if the ring buffer wrapped around the oldest record is located at the write position
+    const uint64_t index_oldest = (buffer->number_of_records > capacity) ? buffer->number_of_records%capacity : 0;
+    for (uint64_t index = 0; index < number_of_records; ++index) {
+      records_.push_back(std::make_pair(buffer->thread_index, buffer->records[(index_oldest+index)%capacity]));
+    }
+  }
+}
+}
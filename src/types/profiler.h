@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace proslam {
+
+//! @class low-overhead scoped profiler: records hierarchical spans tagged with the current frame into per-thread ring buffers
+//! @class spans are only recorded while the profiler is enabled, the macros in definitions.h vanish if SRRG_PROSLAM_ENABLE_PROFILER is not defined
+//! @class exported as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev) or as percentile table per span
+class Profiler {
+
+//ds exported types
+public:
+
+  //! @brief a completed span
+  struct Record {
+    const char* name;          //ds span name (string literal)
+    const char* scope;         //ds enclosing function (__PRETTY_FUNCTION__)
+    uint64_t begin_nanoseconds;
+    uint64_t end_nanoseconds;
+    uint32_t frame_identifier;
+    uint32_t depth;            //ds nesting level within the recording thread
+  };
+
+  //! @brief span records of a single thread (only written by the owning thread)
+  struct ThreadBuffer {
+    std::vector<Record> records;
+    uint64_t number_of_records = 0;
+    uint32_t depth             = 0;
+    uint32_t thread_index      = 0;
+  };
+
+  //! @brief a span covering its lifetime or until stop is called
+  //! @brief the span always measures its duration (a single clock read at start and stop), such that chronometers can use it as their timer
+  class Span {
+  public:
+    Span(const char* name_, const char* scope_): _name(name_), _scope(scope_) {
+      if (Profiler::isEnabled()) {
+        _buffer           = Profiler::_threadBuffer();
+        _depth            = _buffer->depth++;
+        _frame_identifier = Profiler::frameIdentifier();
+      }
+      _begin_nanoseconds = Profiler::nanoseconds();
+    }
+    ~Span() {stop();}
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    //! @brief completes the span and records it if the profiler was enabled at construction
+    //! @return duration of the span in seconds (0 if already stopped)
+    const double stop() {
+      if (_is_stopped) {
+        return 0;
+      }
+      _is_stopped = true;
+      const uint64_t end_nanoseconds = Profiler::nanoseconds();
+      if (_buffer) {
+        Record& record           = _buffer->records[_buffer->number_of_records%_buffer->records.size()];
+        record.name              = _name;
+        record.scope             = _scope;
+        record.begin_nanoseconds = _begin_nanoseconds;
+        record.end_nanoseconds   = end_nanoseconds;
+        record.frame_identifier  = _frame_identifier;
+        record.depth             = _depth;
+        ++_buffer->number_of_records;
+        --_buffer->depth;
+        _buffer = nullptr;
+      }
+      return 1e-9*(end_nanoseconds-_begin_nanoseconds);
+    }
+  protected:
+    const char* _name;
+    const char* _scope;
+    ThreadBuffer* _buffer       = nullptr;
+    uint64_t _begin_nanoseconds = 0;
+    uint32_t _frame_identifier  = 0;
+    uint32_t _depth             = 0;
+    bool _is_stopped            = false;
+  };
+
+  //! @brief assigns spans started by the current thread during its lifetime to the given frame (instead of the global frame identifier)
+  //! @brief used for work on a frame other than the one currently processed by the main thread (e.g. pipelined feature extraction on the pool)
+  class FrameScope {
+  public:
+    FrameScope(const uint32_t& frame_identifier_): _frame_identifier_previous(_frame_identifier_of_thread), _has_frame_identifier_previous(_has_frame_identifier_of_thread) {
+      _frame_identifier_of_thread     = frame_identifier_;
+      _has_frame_identifier_of_thread = true;
+    }
+    ~FrameScope() {
+      _frame_identifier_of_thread     = _frame_identifier_previous;
+      _has_frame_identifier_of_thread = _has_frame_identifier_previous;
+    }
+    FrameScope(const FrameScope&) = delete;
+    FrameScope& operator=(const FrameScope&) = delete;
+  protected:
+    const uint32_t _frame_identifier_previous;
+    const bool _has_frame_identifier_previous;
+  };
+
+//ds interface
+public:
+
+  //! @brief starts recording spans (warns if the profiler is compiled out)
+  //! @param[in] spans_per_thread_ ring buffer capacity of every recording thread (fixed at the first call)
+  static void enable(const uint32_t& spans_per_thread_ = 65536);
+
+  //! @brief stops recording spans (recorded spans are kept)
+  static void disable();
+
+  //! @brief discards all recorded spans (no span may be recorded concurrently)
+  static void clear();
+
+  //! @brief writes all recorded spans as Chrome trace-event JSON (no span may be recorded concurrently)
+  //! @param[in] file_name_ target JSON file
+  static void writeChromeTrace(const std::string& file_name_);
+
+  //! @brief prints count, total and p50/p95/p99/max durations per span with the frame of the maximum (no span may be recorded concurrently)
+  //! @brief followed by the recording overhead: number of spans times the measured cost of a span, relative to the given processing time
+  //! @param[in] processing_time_seconds_ total processing time of the profiled run (overhead ratio omitted if 0)
+  static void printStatistics(std::ostream& stream_, const double& processing_time_seconds_ = 0);
+
+  //! @brief measures the cost of recording a span on the calling thread (into a scratch buffer, the recorded spans are kept)
+  //! @param[in] number_of_spans_ number of spans averaged over
+  //! @return mean cost of a recorded span in seconds
+  static const double measureSpanCostSeconds(const uint32_t& number_of_spans_ = 100000);
+
+  //! @brief sets the frame identifier assigned to subsequently started spans
+  static void setFrameIdentifier(const uint32_t& frame_identifier_) {_frame_identifier.store(frame_identifier_, std::memory_order_relaxed);}
+
+//ds getters/setters
+public:
+
+  static const bool isEnabled() {return _is_enabled.load(std::memory_order_relaxed);}
+  //! @brief frame identifier of the current thread if set by a FrameScope, otherwise the global one
+  static const uint32_t frameIdentifier() {
+    return (_has_frame_identifier_of_thread) ? _frame_identifier_of_thread : _frame_identifier.load(std::memory_order_relaxed);
+  }
+  static const uint64_t nanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+//ds helpers
+protected:
+
+  //! @brief buffer of the calling thread, allocated and registered on first use
+  static ThreadBuffer* _threadBuffer();
+
+  //! @brief readable span label: class and span name (e.g. Relocalizer::overall)
+  static std::string _label(const Record& record_);
+
+  //! @brief retrieves the recorded spans of all threads (oldest first per thread)
+  static void _collect(std::vector<std::pair<uint32_t, Record>>& records_);
+
+//ds attributes
+protected:
+
+  static std::atomic<bool> _is_enabled;
+  static std::atomic<uint32_t> _frame_identifier;
+
+  //! @brief frame identifier override of the current thread (see FrameScope)
+  static thread_local uint32_t _frame_identifier_of_thread;
+  static thread_local bool _has_frame_identifier_of_thread;
+  static uint32_t _spans_per_thread;
+
+  //! @brief buffers of all threads that recorded spans (kept after the threads terminated)
+  static std::vector<std::unique_ptr<ThreadBuffer>> _thread_buffers;
+  static std::mutex _mutex;
+};
+}
@@ -0,0 +1,326 @@
+#include "thread_pool.h"
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace proslam {
+
+//ds pool and queue of the calling thread (external threads, e.g. the main thread, are not registered)
+thread_local const ThreadPool* thread_pool_of_current_thread = nullptr;
+thread_local Index worker_index_of_current_thread           = 0;
+
+ThreadPool::ThreadPool(ThreadPoolParameters* parameters_): _parameters(parameters_),
+                                                           _number_of_queued_tasks(0),
+                                                           _index_next_queue(0),
+                                                           _is_termination_requested(false),
+                                                           _number_of_stolen_tasks(0) {
+  LOG_INFO(std::cerr << "ThreadPool::ThreadPool|constructed" << std::endl)
+}
+
+void ThreadPool::configure() {
+  LOG_INFO(std::cerr << "ThreadPool::configure|configuring" << std::endl)
+
+  //ds stop running workers (reconfiguration)
+  _stopWorkers();
+
+  //ds the calling thread participates in parallel loops, hence one worker less than threads
+  Count number_of_threads = _parameters->number_of_threads;
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  _is_termination_requested = false;
+  for (Index index = 0; index+1 < number_of_threads; ++index) {
+    _workers.push_back(new Worker());
+  }
+
+  //ds start workers once all queues are available (workers steal from each other)
+  for (Index index = 0; index < _workers.size(); ++index) {
+    _workers[index]->thread = std::thread([=] {_work(index);});
+  }
+
+  //ds reset statistics
+  _number_of_stolen_tasks = 0;
+  for (Index stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+    _number_of_parallel_loops[stage]               = 0;
+    _time_consumption_seconds_parallel_loops[stage] = 0;
+  }
+  LOG_INFO(std::cerr << "ThreadPool::configure|number of threads: " << numberOfThreads()
+                     << " (CPU pinning: " << _parameters->enable_cpu_pinning << ")" << std::endl)
+  LOG_INFO(std::cerr << "ThreadPool::configure|configured" << std::endl)
+}
+
+ThreadPool::~ThreadPool() {
+  LOG_INFO(std::cerr << "ThreadPool::~ThreadPool|destroying" << std::endl)
+  _stopWorkers();
+  LOG_INFO(std::cerr << "ThreadPool::~ThreadPool|destroyed" << std::endl)
+}
+
+void ThreadPool::submit(TaskGroup& group_, const std::function<void()>& task_) {
+  ++group_._number_of_pending_tasks;
+
+  //ds sequential processing
+  if (_workers.empty()) {
+    _execute(&group_, task_);
+    return;
+  }
+
+  //ds workers push to their own queue, external threads distribute their tasks over all queues
+  Index queue_index = 0;
+  if (thread_pool_of_current_thread == this) {
+    queue_index = worker_index_of_current_thread;
+  } else {
+    queue_index = (_index_next_queue++)%_workers.size();
+  }
+  Worker* worker = _workers[queue_index];
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->tasks.push_back(std::make_pair(&group_, task_));
+    ++_number_of_queued_tasks;
+  }
+
+  //ds wake up an idle worker (synchronized with the idle check of the workers)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+  }
+  _condition.notify_one();
+}
+
+void ThreadPool::wait(TaskGroup& group_) {
+
+  //ds help processing pending tasks until the group is completed - workers take tasks of any group (nested parallelism),
+  //ds external threads only tasks of the awaited group (a foreign task could stall the caller for its whole duration)
+  const bool is_worker     = (thread_pool_of_current_thread == this);
+  const Index worker_index = is_worker ? worker_index_of_current_thread : _workers.size();
+  const TaskGroup* group   = is_worker ? nullptr : &group_;
+  while (group_._number_of_pending_tasks > 0) {
+    if (!_executePendingTask(worker_index, group)) {
+
+      //ds the remaining tasks are running on other threads - wait for them (periodically checking for new pending tasks)
+      std::unique_lock<std::mutex> lock(group_._mutex);
+      group_._condition.wait_for(lock, std::chrono::microseconds(100), [&group_] {return group_._number_of_pending_tasks == 0;});
+    }
+  }
+
+  //ds synchronize with the last completing task (the group might be destroyed after returning)
+  std::exception_ptr exception = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(group_._mutex);
+    std::swap(exception, group_._exception);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::parallelFor(const Index& begin_, const Index& end_, const std::function<void(const Index&)>& body_, const Stage& stage_) {
+  if (end_ <= begin_) {
+    return;
+  }
+  const double time_begin_seconds = srrg_core::getTime();
+  const Count number_of_threads   = std::min(maximumParallelism(stage_), end_-begin_);
+
+  //ds sequential processing
+  if (number_of_threads == 1) {
+    for (Index index = begin_; index < end_; ++index) {
+      body_(index);
+    }
+  } else {
+
+    //ds indices are fetched one at a time by all participating threads (balances uneven workloads)
+    std::atomic<Index> index_next(begin_);
+    const std::function<void()> process = [&]() {
+      for (Index index = index_next++; index < end_; index = index_next++) {
+        body_(index);
+      }
+    };
+    TaskGroup group;
+    for (Index u = 1; u < number_of_threads; ++u) {
+      submit(group, process);
+    }
+
+    //ds the calling thread participates - exceptions are held back until the submitted tasks are completed
+    std::exception_ptr exception = nullptr;
+    try {
+      process();
+    } catch (...) {
+      exception  = std::current_exception();
+      index_next = end_;
+    }
+    try {
+      wait(group);
+    } catch (...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  //ds update statistics (parallel loops are issued by different threads)
+  std::lock_guard<std::mutex> lock(_mutex_statistics);
+  ++_number_of_parallel_loops[stage_];
+  _time_consumption_seconds_parallel_loops[stage_] += srrg_core::getTime()-time_begin_seconds;
+}
+
+const Count ThreadPool::maximumParallelism(const Stage& stage_) const {
+  Count maximum_number_of_threads = 0;
+  switch (stage_) {
+    case Stage::FEATURE_EXTRACTION: {
+      maximum_number_of_threads = _parameters->maximum_number_of_threads_feature_extraction;
+      break;
+    }
+    case Stage::TRACKING: {
+      maximum_number_of_threads = _parameters->maximum_number_of_threads_tracking;
+      break;
+    }
+    case Stage::RELOCALIZATION: {
+      maximum_number_of_threads = _parameters->maximum_number_of_threads_relocalization;
+      break;
+    }
+    case Stage::OPTIMIZATION: {
+      maximum_number_of_threads = _parameters->maximum_number_of_threads_optimization;
+      break;
+    }
+    case Stage::DATASET_DECODING: {
+      maximum_number_of_threads = _parameters->maximum_number_of_threads_dataset_decoding;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+
+  //ds no cap or cap above the pool size
+  if (maximum_number_of_threads == 0 || maximum_number_of_threads > numberOfThreads()) {
+    return numberOfThreads();
+  }
+  return maximum_number_of_threads;
+}
+
+const char* ThreadPool::stageName(const Stage& stage_) {
+  switch (stage_) {
+    case Stage::FEATURE_EXTRACTION: {return "feature extraction";}
+    case Stage::TRACKING:           {return "tracking";}
+    case Stage::RELOCALIZATION:     {return "relocalization";}
+    case Stage::OPTIMIZATION:       {return "optimization";}
+    case Stage::DATASET_DECODING:   {return "dataset decoding";}
+    default:                        {return "unknown";}
+  }
+}
+
+void ThreadPool::_work(const Index& worker_index_) {
+  thread_pool_of_current_thread  = this;
+  worker_index_of_current_thread = worker_index_;
+  if (_parameters->enable_cpu_pinning) {
+
+    //ds the first core is left to the processing thread
+    _pinToCore((worker_index_+1)%std::max(std::thread::hardware_concurrency(), 1u));
+  }
+
+  //ds process tasks until termination
+  while (!_is_termination_requested) {
+    if (!_executePendingTask(worker_index_)) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] {return _number_of_queued_tasks > 0 || _is_termination_requested;});
+    }
+  }
+}
+
+const bool ThreadPool::_executePendingTask(const Index& worker_index_, const TaskGroup* group_) {
+  if (_workers.empty()) {
+    return false;
+  }
+  std::pair<TaskGroup*, std::function<void()>> task(nullptr, nullptr);
+
+  //ds own queue first: newest task (data of the submitting task is likely still in cache)
+  if (worker_index_ < _workers.size()) {
+    Worker* worker = _workers[worker_index_];
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (!worker->tasks.empty()) {
+      task = std::move(worker->tasks.back());
+      worker->tasks.pop_back();
+      --_number_of_queued_tasks;
+    }
+  }
+
+  //ds otherwise steal the oldest (matching) task of another queue
+  if (!task.first) {
+    for (Index offset = 1; offset <= _workers.size(); ++offset) {
+      Worker* victim = _workers[(worker_index_+offset)%_workers.size()];
+      std::lock_guard<std::mutex> lock(victim->mutex);
+      std::deque<std::pair<TaskGroup*, std::function<void()>>>::iterator iterator = victim->tasks.begin();
+      if (group_) {
+        while (iterator != victim->tasks.end() && iterator->first != group_) {
+          ++iterator;
+        }
+      }
+      if (iterator != victim->tasks.end()) {
+        task = std::move(*iterator);
+        victim->tasks.erase(iterator);
+        --_number_of_queued_tasks;
+        ++_number_of_stolen_tasks;
+        break;
+      }
+    }
+  }
+  if (!task.first) {
+    return false;
+  }
+  _execute(task.first, task.second);
+  return true;
+}
+
+void ThreadPool::_execute(TaskGroup* group_, const std::function<void()>& task_) {
+  std::exception_ptr exception = nullptr;
+  try {
+    task_();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  //ds update group under lock - the waiting thread synchronizes on it before releasing the group
+  std::lock_guard<std::mutex> lock(group_->_mutex);
+  if (exception && !group_->_exception) {
+    group_->_exception = exception;
+  }
+  if (--group_->_number_of_pending_tasks == 0) {
+    group_->_condition.notify_all();
+  }
+}
+
+void ThreadPool::_pinToCore(const Index& core_index_) const {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core_index_, &cpu_set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) != 0) {
+    LOG_WARNING(std::cerr << "ThreadPool::_pinToCore|unable to pin thread to core: " << core_index_ << std::endl)
+  }
+#else
+  LOG_WARNING(std::cerr << "ThreadPool::_pinToCore|CPU pinning is not supported on this platform" << std::endl)
+#endif
+}
+
+void ThreadPool::_stopWorkers() {
+  if (_workers.empty()) {
+    return;
+  }
+
+  //ds queued tasks are dropped - the pool is only stopped when no task group is waited for
+  _is_termination_requested = true;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+  }
+  _condition.notify_all();
+  for (Worker* worker: _workers) {
+    worker->thread.join();
+    delete worker;
+  }
+  _workers.clear();
+  _number_of_queued_tasks = 0;
+}
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <exception>
+#include "parameters.h"
+
+namespace proslam {
+
+//! @class shared work-stealing thread pool, owned by the SLAMAssembly and passed to all processing modules
+//! @class every worker holds its own task queue: tasks submitted by a worker are pushed to and popped from the back of its queue,
+//! @class idle workers steal from the front of the other queues. threads waiting for a task group execute pending tasks meanwhile,
+//! @class which allows nested parallelism (e.g. parallel keypoint detection inside parallel stereo feature extraction) without deadlocks.
+//! @class external threads (e.g. the main thread) only execute tasks of the group they wait for, such that they do not pick up
+//! @class unrelated long running tasks (e.g. the feature extraction of the next frame) in the middle of their own work
+class ThreadPool {
+PROSLAM_MAKE_PROCESSING_CLASS(ThreadPool)
+
+//ds exported types
+public:
+
+  //! @brief processing stages with individual parallelism caps and time accounting
+  enum Stage {FEATURE_EXTRACTION,
+              TRACKING,
+              RELOCALIZATION,
+              OPTIMIZATION,
+              DATASET_DECODING,
+              NUMBER_OF_STAGES};
+
+  //! @brief a set of submitted tasks that can be waited for - the first exception raised by a task is rethrown by wait
+  class TaskGroup {
+  public:
+    TaskGroup(): _number_of_pending_tasks(0) {}
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+  protected:
+    std::atomic<Count> _number_of_pending_tasks;
+    std::exception_ptr _exception = nullptr;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+  friend class ThreadPool;
+  };
+
+//ds functionality
+public:
+
+  //! @brief queues a task for asynchronous execution (executed immediately if the pool has no worker threads)
+  //! @param[in] group_ task group to which the task is added
+  //! @param[in] task_ the task, must not outlive the objects it references before wait is called
+  void submit(TaskGroup& group_, const std::function<void()>& task_);
+
+  //! @brief blocks until all tasks of the group are completed, executing pending tasks meanwhile (external threads: of the group only)
+  //! @param[in] group_ the task group to wait for, rethrows the first exception raised by one of its tasks
+  void wait(TaskGroup& group_);
+
+  //! @brief executes body_ for each index in [begin_, end_) - indices are distributed dynamically over at most the stage cap of threads
+  //! @brief the calling thread participates, the call returns once all indices have been processed (exceptions are rethrown)
+  //! @param[in] begin_ first index
+  //! @param[in] end_ index after the last index
+  //! @param[in] body_ loop body, called concurrently for different indices
+  //! @param[in] stage_ processing stage (parallelism cap and time accounting)
+  void parallelFor(const Index& begin_, const Index& end_, const std::function<void(const Index&)>& body_, const Stage& stage_);
+
+  //! @brief maximum number of threads that work on a single parallel loop of the stage (including the calling thread)
+  const Count maximumParallelism(const Stage& stage_) const;
+
+  //! @brief stage name for reports
+  static const char* stageName(const Stage& stage_);
+
+//ds getters/setters
+public:
+
+  //! @brief total number of threads including the calling thread
+  const Count numberOfThreads() const {return _workers.size()+1;}
+  const Count numberOfParallelLoops(const Stage& stage_) const {return _number_of_parallel_loops[stage_];}
+  const double timeConsumptionSecondsParallelLoops(const Stage& stage_) const {return _time_consumption_seconds_parallel_loops[stage_];}
+  const Count numberOfStolenTasks() const {return _number_of_stolen_tasks;}
+
+//ds helpers
+protected:
+
+  //! @brief a worker with its task queue
+  struct Worker {
+    std::thread thread;
+    std::deque<std::pair<TaskGroup*, std::function<void()>>> tasks;
+    std::mutex mutex;
+  };
+
+  //! @brief worker thread loop: executes own tasks (newest first) or steals tasks from other workers (oldest first)
+  void _work(const Index& worker_index_);
+
+  //! @brief retrieves and executes a single pending task
+  //! @param[in] worker_index_ queue of the calling worker (workers.size() for external threads, which only steal)
+  //! @param[in] group_ if set, only a task of this group is executed (oldest first)
+  //! @return false if no (matching) task is pending
+  const bool _executePendingTask(const Index& worker_index_, const TaskGroup* group_ = nullptr);
+
+  //! @brief executes a task and updates its group
+  void _execute(TaskGroup* group_, const std::function<void()>& task_);
+
+  //! @brief pins the calling thread to a CPU core (linux only)
+  void _pinToCore(const Index& core_index_) const;
+
+  //! @brief stops and joins all worker threads
+  void _stopWorkers();
+
+//ds attributes
+protected:
+
+  //! @brief worker threads
+  std::vector<Worker*> _workers;
+
+  //! @brief number of queued (not yet started) tasks over all workers
+  std::atomic<Count> _number_of_queued_tasks;
+
+  //! @brief round robin queue selection for tasks submitted by external threads
+  std::atomic<Index> _index_next_queue;
+
+  //! @brief termination request for all workers
+  std::atomic<bool> _is_termination_requested;
+
+  //! @brief wakes up idle workers
+  std::mutex _mutex;
+  std::condition_variable _condition;
+
+//ds informative only
+protected:
+
+  std::atomic<Count> _number_of_stolen_tasks;
+  Count _number_of_parallel_loops[NUMBER_OF_STAGES];
+  double _time_consumption_seconds_parallel_loops[NUMBER_OF_STAGES];
+  std::mutex _mutex_statistics;
+};
+}
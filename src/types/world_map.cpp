@@ -2,10 +2,76 @@
 
 #include <fstream>
 #include <iomanip>
+#include <array>
+#include <limits>
+#include <cstring>
+#include <set>
+#include <algorithm>
 
 namespace proslam {
 using namespace srrg_core;
 
+//ds binary map format (native byte order of the writing machine, identifiers and counts as Identifier/Count):
+//ds header:     "PSLM" | byte order mark (uint32_t) | format version (uint32_t) | sizeof(real) (uint32_t) | descriptor size in bits (uint32_t)
+//ds             files written on a machine with different byte order are rejected by the byte order mark (no conversion)
+//ds frames:     number of frames (uint64_t) | per frame: identifier | previous, next, root and local map identifier (or invalid)
+//ds             | timestamp (double) | flags (uint8_t: keyframe, track broken, reliable pose, tracking) | robot to world (3x4) | robot to local map (3x4)
+//ds landmarks:  number of landmarks (uint64_t) | per landmark: identifier | coordinates (3) | total information (3x3) | number of updates | number of measurements
+//ds             | number of appearances | per appearance: descriptor (bytes) | number of local maps | local map identifiers
+//ds local maps: number of local maps (uint64_t) | per local map: identifier | root, previous and keyframe identifier | number of frames | frame identifiers
+//ds             | number of landmark states | per state: landmark identifier, coordinates in local map (3) | number of closures | per closure: reference identifier, relation (3x4), omega
+static const char* map_file_magic          = "PSLM";
+static const uint32_t map_file_version     = 2;
+static const uint32_t map_file_byte_order  = 0x01020304;
+static const Identifier invalid_identifier = std::numeric_limits<Identifier>::max();
+
+//ds number of evicted frame poses buffered in memory before they are spilled to the temporary file
+static const Count number_of_poses_of_evicted_frames_per_chunk = 1024;
+
+//ds binary serialization helpers
+template<typename Type>
+static inline void writeBinary(std::ofstream& stream_, const Type& value_) {
+  stream_.write(reinterpret_cast<const char*>(&value_), sizeof(Type));
+}
+
+template<typename Type>
+static inline void readBinary(std::ifstream& stream_, Type& value_) {
+  stream_.read(reinterpret_cast<char*>(&value_), sizeof(Type));
+}
+
+static inline void writeTransform(std::ofstream& stream_, const TransformMatrix3D& transform_) {
+  const Matrix3_4 pose(transform_.matrix().block<3,4>(0,0));
+  writeBinary(stream_, pose);
+}
+
+static inline void readTransform(std::ifstream& stream_, TransformMatrix3D& transform_) {
+  Matrix3_4 pose(Matrix3_4::Zero());
+  readBinary(stream_, pose);
+  transform_.setIdentity();
+  transform_.matrix().block<3,4>(0,0) = pose;
+}
+
+//ds descriptors are stored bytewise (bit 0 is the lowest bit of the first byte), independent of the in-memory bitset layout
+static inline void writeDescriptor(std::ofstream& stream_, const HBSTMatchable::Descriptor& descriptor_) {
+  std::array<uint8_t, SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/8> bytes;
+  bytes.fill(0);
+  for (Index bit = 0; bit < SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS; ++bit) {
+    if (descriptor_[bit]) {
+      bytes[bit/8] |= (1 << (bit%8));
+    }
+  }
+  stream_.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static inline void readDescriptor(std::ifstream& stream_, HBSTMatchable::Descriptor& descriptor_) {
+  std::array<uint8_t, SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/8> bytes;
+  stream_.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+  descriptor_.reset();
+  for (Index bit = 0; bit < SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS; ++bit) {
+    descriptor_[bit] = (bytes[bit/8] >> (bit%8)) & 1;
+  }
+}
+
 WorldMap::WorldMap(const WorldMapParameters* parameters_): _parameters(parameters_) {
   LOG_INFO(std::cerr << "WorldMap::WorldMap|constructing" << std::endl)
   clear();
@@ -41,6 +107,14 @@ void WorldMap::clear() {
 
   //ds clear containers
   _frame_queue_for_local_map.clear();
+  _frame_window.clear();
+  _poses_of_evicted_frames.clear();
+  if (_file_poses_of_evicted_frames) {
+    std::fclose(_file_poses_of_evicted_frames);
+    _file_poses_of_evicted_frames = nullptr;
+  }
+  _number_of_evicted_frames = 0;
+  _evicted_root_frames.clear();
   _landmarks.clear();
   _frames.clear();
   _local_maps.clear();
@@ -66,6 +140,7 @@ Frame* WorldMap::createFrame(const double& timestamp_image_left_seconds_){
   //ds bookkeeping
   _frames.insert(std::make_pair(_current_frame->identifier(), _current_frame));
   _frame_queue_for_local_map.push_back(_current_frame);
+  _frame_window.push_back(_current_frame);
 
   //ds done
   return _current_frame;
@@ -78,19 +153,117 @@ Landmark* WorldMap::createLandmark(FramePoint* origin_) {
 }
 
 void WorldMap::removeLandmark(const Identifier& identifier_) {
-  auto iterator = _landmarks.find(identifier_);
-  if (iterator != _landmarks.end()) {
-    Landmark* landmark_to_remove = iterator->second;
-    if (_landmarks.erase(identifier_) != 1) {
-      LOG_WARNING(std::cerr << "WorldMap::removeLandmark|unable to remove landmark with ID: " << identifier_ << std::endl)
-    } else {
-      delete landmark_to_remove;
-    }
+  Landmark* landmark_to_remove = _landmarks.get(identifier_);
+  if (landmark_to_remove) {
+    _landmarks.erase(identifier_);
+    delete landmark_to_remove;
   } else {
     LOG_WARNING(std::cerr << "WorldMap::removeLandmark|unable to remove landmark with ID: " << identifier_ << std::endl)
   }
 }
 
+void WorldMap::evictOutsideWindow() {
+  CHRONOMETER_START(window_eviction)
+
+  //ds a landmark is tracked if it was updated in the current frame - its measurement window then spans
+  //ds at most maximum_number_of_window_measurements consecutive frames, which have to stay in memory
+  auto is_tracked = [this](const Landmark* landmark_) {
+    return (landmark_->lastUpdate() && landmark_->lastUpdate()->frame() == _current_frame);
+  };
+  const Count maximum_number_of_frames = std::max(_parameters->maximum_number_of_frames_in_window,
+                                                  _parameters->landmark->maximum_number_of_window_measurements+2);
+
+  //ds evict the oldest frames
+  while (_frame_window.size() > maximum_number_of_frames) {
+    Frame* frame = _frame_window.front();
+    _frame_window.pop_front();
+    assert(frame != _current_frame && frame != _previous_frame);
+
+    //ds free landmarks whose track ended - tracked landmarks only reference frames inside the window
+    for (const FramePoint* point: frame->points()) {
+      Landmark* landmark = point->landmark();
+      if (landmark && !is_tracked(landmark)) {
+        _landmarks.erase(landmark->identifier());
+        delete landmark;
+        ++_number_of_evicted_landmarks;
+      }
+    }
+
+    //ds move the origins of continuing tracks into the window (the tracker resolves landmarks through the track origin)
+    for (const FramePointPointerVector* points: {&frame->points(), &frame->temporaryPoints()}) {
+      for (FramePoint* point: *points) {
+        if (point->origin() == point && point->next()) {
+          FramePoint* origin = point->next();
+          for (FramePoint* point_in_track = origin; point_in_track; point_in_track = point_in_track->next()) {
+            point_in_track->setOrigin(origin);
+          }
+        }
+      }
+    }
+
+    //ds detach the frame from its successor and free its framepoints
+    if (frame->next()) {
+      frame->next()->setPrevious(nullptr);
+      frame->setNext(nullptr);
+    }
+    if (_last_frame_before_track_break == frame) {
+      _last_frame_before_track_break = nullptr;
+    }
+    if (!_frame_queue_for_local_map.empty() && _frame_queue_for_local_map.front() == frame) {
+      _frame_queue_for_local_map.erase(_frame_queue_for_local_map.begin());
+    }
+    frame->clear();
+
+    //ds root frames (first frame and track breaks) are referenced by all frames of their track and are kept without framepoints
+    if (frame != _root_frame && frame->root() != frame && !frame->isTrackBroken()) {
+      _addPoseOfEvictedFrame(frame);
+      _frames.erase(frame->identifier());
+      delete frame;
+    } else {
+      _evicted_root_frames.push_back(frame);
+    }
+  }
+
+  //ds free evicted root frames once their track has left the window
+  if (!_evicted_root_frames.empty()) {
+    std::set<const Frame*> referenced_roots;
+    for (const Frame* frame: _frame_window) {
+      referenced_roots.insert(frame->root());
+    }
+    referenced_roots.insert(_root_frame);
+    if (_last_frame_before_track_break) {
+      referenced_roots.insert(_last_frame_before_track_break->root());
+    }
+    std::deque<Frame*>::iterator iterator = _evicted_root_frames.begin();
+    while (iterator != _evicted_root_frames.end()) {
+      Frame* frame = *iterator;
+      if (referenced_roots.count(frame)) {
+        ++iterator;
+      } else {
+        _addPoseOfEvictedFrame(frame);
+        _frames.erase(frame->identifier());
+        delete frame;
+        iterator = _evicted_root_frames.erase(iterator);
+      }
+    }
+  }
+
+  //ds enforce the landmark limit, starting from the oldest landmarks (only tracked landmarks are skipped)
+  if (_parameters->maximum_number_of_landmarks_in_window > 0) {
+    LandmarkPointerMap::iterator iterator = _landmarks.begin();
+    while (_landmarks.size() > _parameters->maximum_number_of_landmarks_in_window && iterator != _landmarks.end()) {
+      if (is_tracked(iterator->second)) {
+        ++iterator;
+      } else {
+        delete iterator->second;
+        iterator = _landmarks.erase(iterator);
+        ++_number_of_evicted_landmarks;
+      }
+    }
+  }
+  CHRONOMETER_STOP(window_eviction)
+}
+
 LocalMap* WorldMap::createLocalMap(const bool& drop_framepoints_) {
   if (!_previous_frame) {
     return nullptr;
@@ -165,12 +338,22 @@ void WorldMap::addLoopClosure(LocalMap* query_,
                               const Closure::CorrespondencePointerVector& landmark_correspondences_,
                               const real& information_) {
 
-  //ds check if we relocalized after a lost track
-  if (_frames.at(0)->root() != _current_frame->root()) {
-    assert(_current_frame->localMap() == query_);
+  //ds check if we relocalized after a lost track (the query has to be part of the current track)
+  if (_last_local_map_before_track_break                &&
+      _frames.at(0)->root() != _current_frame->root()   &&
+      query_->keyframe()->root() == _current_frame->root()) {
 
-    //ds rudely link the current frame into the list (proper map merging will be coming soon!)
-    setTrack(_current_frame);
+    //ds rudely link the query keyframe into the list (proper map merging will be coming soon!)
+    //ds the keyframe is the current frame, unless relocalization runs asynchronously
+    setTrack(query_->keyframe());
+
+    //ds move the frames and local maps created since the query to the restored roots
+    for (Frame* frame = query_->keyframe()->next(); frame; frame = frame->next()) {
+      frame->setRoot(_root_frame);
+    }
+    for (LocalMap* local_map = query_->next(); local_map; local_map = local_map->next()) {
+      local_map->setRoot(_root_local_map);
+    }
   }
 
   //ds add loop closure information to the world map
@@ -200,10 +383,12 @@ void WorldMap::writeTrajectoryKITTI(const std::string& filename_) const {
   outfile_trajectory << std::setprecision(9);
 
   //ds for each frame (assuming continuous, sequential indexing)
-  for (const FramePointerMapElement frame: _frames) {
+  TrajectoryPoseVector trajectory;
+  getTrajectory(trajectory);
+  for (const TrajectoryPose& pose: trajectory) {
 
     //ds buffer transform
-    const TransformMatrix3D& robot_to_world = frame.second->robotToWorld();
+    const TransformMatrix3D& robot_to_world = pose.robot_to_world;
 
     //ds dump transform according to KITTI format
     for (uint8_t u = 0; u < 3; ++u) {
@@ -236,14 +421,16 @@ void WorldMap::writeTrajectoryTUM(const std::string& filename_) const {
   outfile_trajectory << std::setprecision(9);
 
   //ds for each frame (assuming continuous, sequential indexing)
-  for (const FramePointerMapElement frame: _frames) {
+  TrajectoryPoseVector trajectory;
+  getTrajectory(trajectory);
+  for (const TrajectoryPose& pose: trajectory) {
 
     //ds buffer transform
-    const TransformMatrix3D& robot_to_world = frame.second->robotToWorld();
+    const TransformMatrix3D& robot_to_world = pose.robot_to_world;
     const Quaternion orientation = Quaternion(robot_to_world.linear());
 
     //ds dump transform according to TUM format
-    outfile_trajectory << frame.second->timestampImageLeftSeconds() << " ";
+    outfile_trajectory << pose.timestamp_seconds << " ";
     outfile_trajectory << robot_to_world.translation().x() << " ";
     outfile_trajectory << robot_to_world.translation().y() << " ";
     outfile_trajectory << robot_to_world.translation().z() << " ";
@@ -257,6 +444,460 @@ void WorldMap::writeTrajectoryTUM(const std::string& filename_) const {
   LOG_INFO(std::cerr << "WorldMap::WorldMap|saved trajectory (TUM format) to: " << filename_tum << std::endl)
 }
 
+void WorldMap::getTrajectory(TrajectoryPoseVector& poses_) const {
+  poses_.clear();
+  poses_.reserve(_number_of_evicted_frames+_frames.size());
+
+  //ds retrieve the poses of all evicted frames: spilled ones first, then the buffered ones
+  TrajectoryPoseVector poses_of_evicted_frames(_number_of_evicted_frames-_poses_of_evicted_frames.size());
+  if (!poses_of_evicted_frames.empty()) {
+    assert(_file_poses_of_evicted_frames);
+    std::rewind(_file_poses_of_evicted_frames);
+    if (std::fread(poses_of_evicted_frames.data(), sizeof(TrajectoryPose), poses_of_evicted_frames.size(), _file_poses_of_evicted_frames) != poses_of_evicted_frames.size()) {
+      throw std::runtime_error("WorldMap::getTrajectory|unable to read poses of evicted frames");
+    }
+  }
+  poses_of_evicted_frames.insert(poses_of_evicted_frames.end(), _poses_of_evicted_frames.begin(), _poses_of_evicted_frames.end());
+
+  //ds root frames are evicted after the frames of their track
+  std::sort(poses_of_evicted_frames.begin(), poses_of_evicted_frames.end(), [](const TrajectoryPose& a_, const TrajectoryPose& b_) {
+    return a_.frame_identifier < b_.frame_identifier;
+  });
+
+  //ds merge evicted and present frames by identifier (kept root frames can be older than evicted frames)
+  TrajectoryPoseVector::const_iterator iterator_evicted = poses_of_evicted_frames.begin();
+  for (const FramePointerMapElement frame: _frames) {
+    while (iterator_evicted != poses_of_evicted_frames.end() && iterator_evicted->frame_identifier < frame.first) {
+      poses_.push_back(*iterator_evicted);
+      ++iterator_evicted;
+    }
+    poses_.push_back(TrajectoryPose(frame.first, frame.second->timestampImageLeftSeconds(), frame.second->robotToWorld()));
+  }
+  poses_.insert(poses_.end(), iterator_evicted, poses_of_evicted_frames.cend());
+}
+
+void WorldMap::_addPoseOfEvictedFrame(const Frame* frame_) {
+  _poses_of_evicted_frames.push_back(TrajectoryPose(frame_->identifier(), frame_->timestampImageLeftSeconds(), frame_->robotToWorld()));
+  ++_number_of_evicted_frames;
+  if (_poses_of_evicted_frames.size() < number_of_poses_of_evicted_frames_per_chunk) {
+    return;
+  }
+
+  //ds spill the chunk to the temporary file (removed automatically when closed) - the buffer keeps its capacity
+  if (!_file_poses_of_evicted_frames) {
+    _file_poses_of_evicted_frames = std::tmpfile();
+    if (!_file_poses_of_evicted_frames) {
+      throw std::runtime_error("WorldMap::_addPoseOfEvictedFrame|unable to create temporary file for evicted poses");
+    }
+  }
+  std::fseek(_file_poses_of_evicted_frames, 0, SEEK_END);
+  if (std::fwrite(_poses_of_evicted_frames.data(), sizeof(TrajectoryPose), _poses_of_evicted_frames.size(), _file_poses_of_evicted_frames) != _poses_of_evicted_frames.size()) {
+    throw std::runtime_error("WorldMap::_addPoseOfEvictedFrame|unable to write poses of evicted frames");
+  }
+  _poses_of_evicted_frames.clear();
+}
+
+void WorldMap::write(const std::string& file_name_) const {
+  const double time_begin_seconds = srrg_core::getTime();
+  std::ofstream outfile(file_name_, std::ios::out | std::ios::binary);
+  if (!outfile.good()) {
+    throw std::runtime_error("WorldMap::write|unable to open file: "+file_name_);
+  }
+
+  //ds header
+  outfile.write(map_file_magic, 4);
+  writeBinary(outfile, map_file_byte_order);
+  writeBinary(outfile, map_file_version);
+  writeBinary(outfile, static_cast<uint32_t>(sizeof(real)));
+  writeBinary(outfile, static_cast<uint32_t>(SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS));
+
+  //ds frames
+  writeBinary(outfile, static_cast<uint64_t>(_frames.size()));
+  for (const FramePointerMapElement& element: _frames) {
+    const Frame* frame = element.second;
+    writeBinary(outfile, frame->identifier());
+    writeBinary(outfile, frame->previous() ? frame->previous()->identifier() : invalid_identifier);
+    writeBinary(outfile, frame->next() ? frame->next()->identifier() : invalid_identifier);
+    writeBinary(outfile, frame->root() ? frame->root()->identifier() : invalid_identifier);
+    writeBinary(outfile, frame->localMap() ? frame->localMap()->identifier() : invalid_identifier);
+    writeBinary(outfile, frame->timestampImageLeftSeconds());
+    const uint8_t flags = frame->isKeyframe()                            |
+                          frame->isTrackBroken() << 1                    |
+                          frame->hasReliablePoseEstimate() << 2          |
+                          (frame->status() == Frame::Status::Tracking) << 3;
+    writeBinary(outfile, flags);
+    writeTransform(outfile, frame->robotToWorld());
+    writeTransform(outfile, frame->robotToLocalMap());
+  }
+
+  //ds landmarks
+  writeBinary(outfile, static_cast<uint64_t>(_landmarks.size()));
+  for (const LandmarkPointerMapElement& element: _landmarks) {
+    const Landmark* landmark = element.second;
+    writeBinary(outfile, landmark->identifier());
+    writeBinary(outfile, landmark->coordinates());
+    writeBinary(outfile, landmark->_totalInformationMatrix());
+    writeBinary(outfile, landmark->_number_of_updates);
+    writeBinary(outfile, landmark->_number_of_measurements);
+
+    //ds appearances (place database content): each descriptor with the local maps in which it describes this landmark
+    std::set<const HBSTMatchable*> matchables;
+    for (const std::pair<const HBSTMatchable*, HBSTMatchable*>& appearance: landmark->_appearance_map) {
+      matchables.insert(appearance.second);
+    }
+    writeBinary(outfile, static_cast<Count>(matchables.size()));
+    for (const HBSTMatchable* matchable: matchables) {
+      writeDescriptor(outfile, matchable->descriptor);
+      std::vector<Identifier> local_map_identifiers;
+      for (const auto& object: matchable->objects) {
+        if (object.second == landmark) {
+          local_map_identifiers.push_back(object.first);
+        }
+      }
+      writeBinary(outfile, static_cast<Count>(local_map_identifiers.size()));
+      for (const Identifier& local_map_identifier: local_map_identifiers) {
+        writeBinary(outfile, local_map_identifier);
+      }
+    }
+  }
+
+  //ds local maps
+  writeBinary(outfile, static_cast<uint64_t>(_local_maps.size()));
+  for (LocalMap* local_map: _local_maps) {
+    writeBinary(outfile, local_map->identifier());
+    writeBinary(outfile, local_map->root() ? local_map->root()->identifier() : invalid_identifier);
+    writeBinary(outfile, local_map->previous() ? local_map->previous()->identifier() : invalid_identifier);
+    writeBinary(outfile, local_map->keyframe()->identifier());
+    writeBinary(outfile, static_cast<Count>(local_map->frames().size()));
+    for (const Frame* frame: local_map->frames()) {
+      writeBinary(outfile, frame->identifier());
+    }
+    writeBinary(outfile, static_cast<Count>(local_map->_landmarks.size()));
+    for (const Closure::LandmarkStateMapElement& element: local_map->_landmarks) {
+      writeBinary(outfile, element.first);
+      writeBinary(outfile, element.second.coordinates_in_local_map);
+    }
+    writeBinary(outfile, static_cast<Count>(local_map->closures().size()));
+    for (const Closure::ClosureConstraint& closure: local_map->closures()) {
+      writeBinary(outfile, closure.local_map->identifier());
+      writeTransform(outfile, closure.relation);
+      writeBinary(outfile, closure.omega);
+    }
+  }
+
+  //ds check for failure before closing
+  if (!outfile.good()) {
+    throw std::runtime_error("WorldMap::write|unable to write to file: "+file_name_);
+  }
+  const double size_megabytes = outfile.tellp()/1e6;
+  outfile.close();
+  const double duration_seconds = srrg_core::getTime()-time_begin_seconds;
+  LOG_INFO(std::printf("WorldMap::write|saved map to: '%s' (frames: %lu, landmarks: %lu, local maps: %lu) %.2f MB in %.3f s (%.1f MB/s)\n",
+                       file_name_.c_str(), _frames.size(), _landmarks.size(), _local_maps.size(),
+                       size_megabytes, duration_seconds, size_megabytes/duration_seconds))
+}
+
+void WorldMap::read(const std::string& file_name_) {
+  if (!_frames.empty() || !_landmarks.empty() || !_local_maps.empty()) {
+    throw std::runtime_error("WorldMap::read|a map can only be loaded into an empty world map");
+  }
+
+  //ds release everything loaded so far on failure - the appearances are not owned by their landmarks
+  std::map<Identifier, AppearanceVector> appearances_per_local_map;
+  const Count number_of_closures_before = _number_of_closures;
+  try {
+    _read(file_name_, appearances_per_local_map);
+  } catch (...) {
+    LOG_WARNING(std::cerr << "WorldMap::read|unable to load map from: '" << file_name_ << "' - releasing partially loaded map" << std::endl)
+    for (std::pair<const Identifier, AppearanceVector>& appearances: appearances_per_local_map) {
+      for (HBSTMatchable* matchable: appearances.second) {
+        delete matchable;
+      }
+    }
+    clear();
+    _number_of_closures = number_of_closures_before;
+    throw;
+  }
+}
+
+void WorldMap::_read(const std::string& file_name_, std::map<Identifier, AppearanceVector>& appearances_per_local_map_) {
+  const double time_begin_seconds = srrg_core::getTime();
+  std::ifstream infile(file_name_, std::ios::in | std::ios::binary);
+  if (!infile.good()) {
+    throw std::runtime_error("WorldMap::read|unable to open file: "+file_name_);
+  }
+  infile.seekg(0, std::ios::end);
+  const uint64_t file_size_bytes = infile.tellg();
+  infile.seekg(0, std::ios::beg);
+
+  //ds every record is checked after reading - counts are bounded by the number of records of minimum size fitting into the rest of the file,
+  //ds such that a corrupt count is detected before any allocation
+  auto check_record = [&infile, &file_name_]() {
+    if (!infile.good()) {
+      throw std::runtime_error("WorldMap::read|truncated map file: "+file_name_);
+    }
+  };
+  auto check_count = [&](const uint64_t& count_, const uint64_t& minimum_bytes_per_record_, const std::string& records_) {
+    check_record();
+    const uint64_t remaining_bytes = file_size_bytes-static_cast<uint64_t>(infile.tellg());
+    if (count_ > remaining_bytes/minimum_bytes_per_record_) {
+      throw std::runtime_error("WorldMap::read|invalid number of "+records_+": "+std::to_string(count_)+" (corrupt map file: "+file_name_+")");
+    }
+  };
+
+  //ds check header
+  char magic[4] = {0, 0, 0, 0};
+  uint32_t byte_order           = 0;
+  uint32_t version              = 0;
+  uint32_t size_of_real         = 0;
+  uint32_t descriptor_size_bits = 0;
+  infile.read(magic, 4);
+  readBinary(infile, byte_order);
+  readBinary(infile, version);
+  readBinary(infile, size_of_real);
+  readBinary(infile, descriptor_size_bits);
+  if (!infile.good() || std::strncmp(magic, map_file_magic, 4) != 0) {
+    throw std::runtime_error("WorldMap::read|invalid map file: "+file_name_);
+  }
+  if (byte_order != map_file_byte_order) {
+    throw std::runtime_error("WorldMap::read|map file written with incompatible byte order: "+file_name_);
+  }
+  if (version != map_file_version) {
+    throw std::runtime_error("WorldMap::read|unsupported map file version: "+std::to_string(version));
+  }
+  if (size_of_real != sizeof(real) || descriptor_size_bits != SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS) {
+    throw std::runtime_error("WorldMap::read|incompatible map file (real size: "+std::to_string(size_of_real)+
+                             ", descriptor size: "+std::to_string(descriptor_size_bits)+")");
+  }
+
+  //ds frames - links are restored once all frames and local maps are available
+  struct FrameLinks {
+    Frame* frame;
+    Identifier previous;
+    Identifier next;
+    Identifier root;
+    Identifier local_map;
+  };
+  uint64_t number_of_frames = 0;
+  readBinary(infile, number_of_frames);
+  check_count(number_of_frames, 5*sizeof(Identifier)+sizeof(double)+sizeof(uint8_t)+2*sizeof(Matrix3_4), "frames");
+  std::vector<FrameLinks> frame_links(number_of_frames);
+  for (FrameLinks& links: frame_links) {
+    Identifier identifier = 0;
+    double timestamp_seconds = 0;
+    uint8_t flags = 0;
+    TransformMatrix3D robot_to_world(TransformMatrix3D::Identity());
+    TransformMatrix3D robot_to_local_map(TransformMatrix3D::Identity());
+    readBinary(infile, identifier);
+    readBinary(infile, links.previous);
+    readBinary(infile, links.next);
+    readBinary(infile, links.root);
+    readBinary(infile, links.local_map);
+    readBinary(infile, timestamp_seconds);
+    readBinary(infile, flags);
+    readTransform(infile, robot_to_world);
+    readTransform(infile, robot_to_local_map);
+    check_record();
+    if (_frames.get(identifier)) {
+      throw std::runtime_error("WorldMap::read|duplicate frame identifier: "+std::to_string(identifier));
+    }
+
+    links.frame = new Frame(identifier, robot_to_world, timestamp_seconds);
+    links.frame->setIsKeyframe(flags & 1);
+    if (flags & 2) {
+      links.frame->breakTrack();
+    }
+    links.frame->setHasReliablePoseEstimate(flags & 4);
+    links.frame->setStatus((flags & 8) ? Frame::Status::Tracking : Frame::Status::Localizing);
+    links.frame->setRobotToLocalMap(robot_to_local_map);
+    _frames.insert(std::make_pair(identifier, links.frame));
+  }
+
+  //ds landmarks with their appearances, which are collected per local map
+  uint64_t number_of_landmarks = 0;
+  readBinary(infile, number_of_landmarks);
+  check_count(number_of_landmarks, sizeof(Identifier)+sizeof(PointCoordinates)+sizeof(Matrix3)+3*sizeof(Count), "landmarks");
+  for (uint64_t index = 0; index < number_of_landmarks; ++index) {
+    Identifier identifier = 0;
+    PointCoordinates coordinates(PointCoordinates::Zero());
+    Matrix3 information_matrix(Matrix3::Zero());
+    Count number_of_updates      = 0;
+    Count number_of_measurements = 0;
+    Count number_of_appearances  = 0;
+    readBinary(infile, identifier);
+    readBinary(infile, coordinates);
+    readBinary(infile, information_matrix);
+    readBinary(infile, number_of_updates);
+    readBinary(infile, number_of_measurements);
+    check_record();
+    if (_landmarks.get(identifier)) {
+      throw std::runtime_error("WorldMap::read|duplicate landmark identifier: "+std::to_string(identifier));
+    }
+    Landmark* landmark = new Landmark(identifier, coordinates, information_matrix, number_of_updates, number_of_measurements, _parameters->landmark);
+    _landmarks.insert(std::make_pair(identifier, landmark));
+
+    readBinary(infile, number_of_appearances);
+    check_count(number_of_appearances, SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS/8+sizeof(Count), "appearances");
+    for (Count u = 0; u < number_of_appearances; ++u) {
+      HBSTMatchable::Descriptor descriptor;
+      Count number_of_local_maps = 0;
+      readDescriptor(infile, descriptor);
+      readBinary(infile, number_of_local_maps);
+      check_count(number_of_local_maps, sizeof(Identifier), "appearance local maps");
+      for (Count v = 0; v < number_of_local_maps; ++v) {
+        Identifier identifier_local_map = 0;
+        readBinary(infile, identifier_local_map);
+        check_record();
+        HBSTMatchable* matchable = new HBSTMatchable(landmark, descriptor, identifier_local_map);
+        appearances_per_local_map_[identifier_local_map].push_back(matchable);
+        landmark->_appearance_map.insert(std::make_pair(matchable, matchable));
+      }
+    }
+  }
+
+  //ds local maps - links and closures are restored once all local maps are available
+  struct LocalMapLinks {
+    LocalMap* local_map;
+    Identifier root;
+    Identifier previous;
+    std::vector<Identifier> closure_references;
+    std::vector<TransformMatrix3D, Eigen::aligned_allocator<TransformMatrix3D>> closure_relations;
+    std::vector<real> closure_omegas;
+  };
+  IdentifierMap<LocalMap> local_maps_loaded;
+  uint64_t number_of_local_maps = 0;
+  readBinary(infile, number_of_local_maps);
+  check_count(number_of_local_maps, 4*sizeof(Identifier)+3*sizeof(Count), "local maps");
+  std::vector<LocalMapLinks> local_map_links(number_of_local_maps);
+  for (LocalMapLinks& links: local_map_links) {
+    Identifier identifier          = 0;
+    Identifier identifier_keyframe = 0;
+    readBinary(infile, identifier);
+    readBinary(infile, links.root);
+    readBinary(infile, links.previous);
+    readBinary(infile, identifier_keyframe);
+    check_record();
+    if (local_maps_loaded.get(identifier)) {
+      throw std::runtime_error("WorldMap::read|duplicate local map identifier: "+std::to_string(identifier));
+    }
+    FramePointerMap::iterator iterator_keyframe = _frames.find(identifier_keyframe);
+    if (iterator_keyframe == _frames.end()) {
+      throw std::runtime_error("WorldMap::read|invalid keyframe identifier: "+std::to_string(identifier_keyframe));
+    }
+    links.local_map = new LocalMap(identifier, iterator_keyframe->second, _parameters->local_map);
+    _local_maps.push_back(links.local_map);
+    local_maps_loaded.insert(std::make_pair(identifier, links.local_map));
+
+    //ds contained frames
+    Count number_of_frames_in_local_map = 0;
+    readBinary(infile, number_of_frames_in_local_map);
+    check_count(number_of_frames_in_local_map, sizeof(Identifier), "local map frames");
+    for (Count u = 0; u < number_of_frames_in_local_map; ++u) {
+      Identifier identifier_frame = 0;
+      readBinary(infile, identifier_frame);
+      check_record();
+      FramePointerMap::iterator iterator_frame = _frames.find(identifier_frame);
+      if (iterator_frame == _frames.end()) {
+        throw std::runtime_error("WorldMap::read|invalid frame identifier: "+std::to_string(identifier_frame));
+      }
+      links.local_map->_frames.push_back(iterator_frame->second);
+    }
+
+    //ds landmark snapshots
+    Count number_of_landmark_states = 0;
+    readBinary(infile, number_of_landmark_states);
+    check_count(number_of_landmark_states, sizeof(Identifier)+sizeof(PointCoordinates), "local map landmarks");
+    for (Count u = 0; u < number_of_landmark_states; ++u) {
+      Identifier identifier_landmark = 0;
+      PointCoordinates coordinates_in_local_map(PointCoordinates::Zero());
+      readBinary(infile, identifier_landmark);
+      readBinary(infile, coordinates_in_local_map);
+      check_record();
+      LandmarkPointerMap::iterator iterator_landmark = _landmarks.find(identifier_landmark);
+      if (iterator_landmark == _landmarks.end()) {
+        throw std::runtime_error("WorldMap::read|invalid landmark identifier: "+std::to_string(identifier_landmark));
+      }
+      links.local_map->_landmarks.insert(std::make_pair(identifier_landmark, Closure::LandmarkState(iterator_landmark->second, coordinates_in_local_map)));
+      iterator_landmark->second->_local_maps.insert(links.local_map);
+    }
+
+    //ds closures (the landmark correspondences are not stored)
+    Count number_of_closures = 0;
+    readBinary(infile, number_of_closures);
+    check_count(number_of_closures, sizeof(Identifier)+sizeof(Matrix3_4)+sizeof(real), "closures");
+    links.closure_references.resize(number_of_closures);
+    links.closure_relations.resize(number_of_closures);
+    links.closure_omegas.resize(number_of_closures);
+    for (Count u = 0; u < number_of_closures; ++u) {
+      readBinary(infile, links.closure_references[u]);
+      readTransform(infile, links.closure_relations[u]);
+      readBinary(infile, links.closure_omegas[u]);
+    }
+    check_record();
+  }
+  const double size_megabytes = infile.tellg()/1e6;
+  infile.close();
+
+  //ds restore frame links
+  auto getFrame = [this](const Identifier& identifier_) -> Frame* {
+    return _frames.get(identifier_);
+  };
+  auto getLocalMap = [&local_maps_loaded](const Identifier& identifier_) -> LocalMap* {
+    return local_maps_loaded.get(identifier_);
+  };
+  for (const FrameLinks& links: frame_links) {
+    links.frame->setPrevious(getFrame(links.previous));
+    links.frame->setNext(getFrame(links.next));
+    links.frame->setRoot(getFrame(links.root));
+    links.frame->setLocalMap(getLocalMap(links.local_map));
+  }
+
+  //ds restore local map links and closures
+  for (const LocalMapLinks& links: local_map_links) {
+    links.local_map->setRoot(getLocalMap(links.root));
+    links.local_map->setPrevious(getLocalMap(links.previous));
+    if (links.local_map->previous() && links.local_map->previous() != links.local_map) {
+      links.local_map->previous()->setNext(links.local_map);
+    }
+    for (Index u = 0; u < links.closure_references.size(); ++u) {
+      LocalMap* local_map_reference = getLocalMap(links.closure_references[u]);
+      if (!local_map_reference) {
+        throw std::runtime_error("WorldMap::read|invalid closure reference identifier: "+std::to_string(links.closure_references[u]));
+      }
+      links.local_map->addCorrespondence(local_map_reference, links.closure_relations[u], Closure::CorrespondencePointerVector(), links.closure_omegas[u]);
+      ++_number_of_closures;
+    }
+  }
+
+  //ds hand over the appearances of each local map (to be added to the place database) - only once all of them are valid
+  for (const std::pair<const Identifier, AppearanceVector>& appearances: appearances_per_local_map_) {
+    if (!getLocalMap(appearances.first)) {
+      throw std::runtime_error("WorldMap::read|invalid appearance local map identifier: "+std::to_string(appearances.first));
+    }
+  }
+  for (std::pair<const Identifier, AppearanceVector>& appearances: appearances_per_local_map_) {
+    getLocalMap(appearances.first)->_appearances.swap(appearances.second);
+  }
+  appearances_per_local_map_.clear();
+
+  //ds the loaded map is treated as a track that broke after its last frame, the next created frame will start a new track
+  if (!_frames.empty()) {
+    _last_frame_before_track_break = _frames.back();
+  }
+  if (!_local_maps.empty()) {
+    _last_local_map_before_track_break = _local_maps.back();
+    _current_local_map                 = _local_maps.back();
+  }
+  _root_frame     = nullptr;
+  _current_frame  = nullptr;
+  _previous_frame = nullptr;
+  _root_local_map = nullptr;
+  const double duration_seconds = srrg_core::getTime()-time_begin_seconds;
+  LOG_INFO(std::printf("WorldMap::read|loaded map from: '%s' (frames: %lu, landmarks: %lu, local maps: %lu) %.2f MB in %.3f s (%.1f MB/s)\n",
+                       file_name_.c_str(), _frames.size(), _landmarks.size(), _local_maps.size(),
+                       size_megabytes, duration_seconds, size_megabytes/duration_seconds))
+}
+
 void WorldMap::breakTrack(Frame* frame_) {
 
   //ds if the track is not already broken
@@ -1,8 +1,24 @@
 #pragma once
+#include <cstdio>
+#include <deque>
 #include "local_map.h"
 
 namespace proslam {
 
+//! @brief pose of a frame in the trajectory (also available for frames that have been evicted from the odometry window)
+struct TrajectoryPose {
+  TrajectoryPose() {}
+  TrajectoryPose(const Identifier& frame_identifier_,
+                 const double& timestamp_seconds_,
+                 const TransformMatrix3D& robot_to_world_): frame_identifier(frame_identifier_),
+                                                            timestamp_seconds(timestamp_seconds_),
+                                                            robot_to_world(robot_to_world_) {}
+  Identifier frame_identifier;
+  double timestamp_seconds;
+  TransformMatrix3D robot_to_world;
+};
+typedef std::vector<TrajectoryPose, Eigen::aligned_allocator<TrajectoryPose>> TrajectoryPoseVector;
+
 //! @class the world map is the overarching map entity, generating and owning all landmarks, frames and local map objects
 class WorldMap {
 public: EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -31,6 +47,12 @@ public:
   //! @param[in] identifier_ the identifier of the landmark to remove
   void removeLandmark(const Identifier& identifier_);
 
+  //! @brief frees the frames leaving the bounded-memory odometry window together with their landmarks that are no longer tracked
+  //! @brief and enforces the landmark limit of the window (oldest untracked landmarks first). Only the poses of evicted frames are kept
+  //! @brief (spilled to a temporary file in chunks), root frames are kept without framepoints until no frame in the window references them.
+  //! @brief Must not be used in combination with relocalization (local maps reference frames)
+  void evictOutsideWindow();
+
   //ds attempts to create a new local map if the generation criteria are met (returns true if a local map was generated)
   LocalMap* createLocalMap(const bool& drop_framepoints_ = false);
 
@@ -57,19 +79,36 @@ public:
   //! @param[in] filename_ text file in which the poses are saved to
   void writeTrajectoryTUM(const std::string& filename_ = "") const;
 
+  //! @brief saves the map to a binary file (versioned format, described in world_map.cpp)
+  //! @brief contains frame poses, landmark estimates and appearances, local maps with their landmark states and closures
+  //! @param[in] file_name_ binary map file
+  void write(const std::string& file_name_) const;
+
+  //! @brief loads a map from a binary file into this (empty) instance
+  //! @brief the loaded map is treated as a track that was broken after its last frame - the next created frame starts a new track,
+  //! @brief which is connected to the loaded one upon relocalization. The appearances of each loaded local map are available in its
+  //! @brief appearances() for insertion into a place database. On failure (invalid, corrupt or truncated file) the partially loaded
+  //! @brief map is released and the instance is left empty
+  //! @param[in] file_name_ binary map file
+  void read(const std::string& file_name_);
+
+  //! @brief obtains the complete trajectory in frame order, including the frames evicted from the odometry window
+  //! @param[out] poses_ frame poses with timestamps
+  void getTrajectory(TrajectoryPoseVector& poses_) const;
+
   //! @brief save trajectory to a vector
   //! @param[in,out] poses_ vector with poses, set in the function
   template<typename RealType>
   void writeTrajectory(std::vector<Eigen::Matrix<RealType, 4, 4>, Eigen::aligned_allocator<Eigen::Matrix<RealType, 4, 4>>>& poses_) const {
+    TrajectoryPoseVector trajectory;
+    getTrajectory(trajectory);
 
     //ds prepare output vector
-    poses_.resize(_frames.size());
+    poses_.resize(trajectory.size());
 
     //ds add the pose for each frame
-    Identifier identifier_frame = 0;
-    for (const FramePointerMapElement frame: _frames) {
-      poses_[identifier_frame] = frame.second->robotToWorld().matrix().cast<RealType>();
-      ++identifier_frame;
+    for (Index index = 0; index < trajectory.size(); ++index) {
+      poses_[index] = trajectory[index].robot_to_world.matrix().cast<RealType>();
     }
   }
 
@@ -77,16 +116,16 @@ public:
   //! @param[in,out] poses_ vector with timestamps and poses, set in the function
   template<typename RealType>
   void writeTrajectoryWithTimestamps(std::vector<std::pair<RealType, Eigen::Transform<RealType, 3, Eigen::Isometry>>>& poses_) const {
+    TrajectoryPoseVector trajectory;
+    getTrajectory(trajectory);
 
     //ds prepare output vector
-    poses_.resize(_frames.size());
+    poses_.resize(trajectory.size());
 
     //ds add the pose for each frame
-    Identifier identifier_frame = 0;
-    for (const FramePointerMapElement frame: _frames) {
-      poses_[identifier_frame].first  = frame.second->timestampImageLeftSeconds();
-      poses_[identifier_frame].second = frame.second->robotToWorld().matrix().cast<RealType>();
-      ++identifier_frame;
+    for (Index index = 0; index < trajectory.size(); ++index) {
+      poses_[index].first  = trajectory[index].timestamp_seconds;
+      poses_[index].second = trajectory[index].robot_to_world.matrix().cast<RealType>();
     }
   }
 
@@ -123,6 +162,8 @@ public:
   const bool relocalized() const {return _relocalized;}
   const Count& numberOfClosures() const {return _number_of_closures;}
   const Count& numberOfMergedLandmarks() const {return _number_of_merged_landmarks;}
+  const Count& numberOfEvictedFrames() const {return _number_of_evicted_frames;}
+  const Count& numberOfEvictedLandmarks() const {return _number_of_evicted_landmarks;}
 
   //ds visualization only
   const FramePointerMap& frames() const {return _frames;}
@@ -131,6 +172,17 @@ public:
 
   const WorldMapParameters* parameters() const {return _parameters;}
 
+//ds helpers
+protected:
+
+  //! @brief stores the pose of an evicted frame, spilling the buffered poses to the temporary file once a chunk is full
+  void _addPoseOfEvictedFrame(const Frame* frame_);
+
+  //! @brief loads a map from a binary file (see read), throws on failure leaving the already loaded elements in this instance
+  //! @param[in] file_name_ binary map file
+  //! @param[out] appearances_per_local_map_ appearances not yet handed over to their local maps (owned by the caller)
+  void _read(const std::string& file_name_, std::map<Identifier, AppearanceVector>& appearances_per_local_map_);
+
 //ds helpers
 public:
 
@@ -157,6 +209,17 @@ protected:
   //ds active frames in the map
   FramePointerMap _frames;
 
+  //! @brief frames of the odometry window in order of creation (the oldest is evicted first)
+  std::deque<Frame*> _frame_window;
+
+  //! @brief poses of the frames evicted from the odometry window (in order of eviction) - moved to a temporary file once a chunk is full
+  TrajectoryPoseVector _poses_of_evicted_frames;
+  std::FILE* _file_poses_of_evicted_frames = nullptr;
+  Count _number_of_evicted_frames          = 0;
+
+  //! @brief root frames evicted from the odometry window (without framepoints) that are still referenced by frames in the window
+  std::deque<Frame*> _evicted_root_frames;
+
   //ds localization
   TransformMatrix3D robot_to_world = TransformMatrix3D::Identity();
   bool _relocalized = false;
@@ -177,7 +240,9 @@ protected:
 
   //ds informative only
   CREATE_CHRONOMETER(landmark_merging)
-  Count _number_of_merged_landmarks = 0;
+  CREATE_CHRONOMETER(window_eviction)
+  Count _number_of_merged_landmarks  = 0;
+  Count _number_of_evicted_landmarks = 0;
 
 private:
 